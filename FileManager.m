@@ -66,6 +66,15 @@ static NSString* const kEncryptionStreamDirectoryName = @"_enc_stream";
     return ret;
 }
 
+- (NSURL *)hibpRangeCacheDirectory {
+    NSURL* ret = [self.appSupportDirectory URLByAppendingPathComponent:@"hibp-range-cache"];
+    
+    [self createIfNecessary:ret];
+    [self setIncludeExcludeFromBackup:ret include:NO];
+    
+    return ret;
+}
+
 - (NSURL *)syncManagerMergeWorkingDirectory {
     NSURL* url = FileManager.sharedInstance.sharedAppGroupDirectory;
     NSURL* ret = [url URLByAppendingPathComponent:@"sync-manager/merge-working"];
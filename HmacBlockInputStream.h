@@ -20,6 +20,10 @@ NSData* getBlockHmac(NSData *data, NSData* hmacKey, uint64_t blockIndex);
 NSData* getHmacKeyForBlock(NSData* key, uint64_t blockIndex);
 NSData* getBlockHmacBytes(const uint8_t* data, size_t len, NSData* hmacKey, uint64_t blockIndex);
 
+void computeHmacKeyForBlock(const uint8_t* key, size_t keyLength, uint64_t blockIndex, uint8_t blockKey[64]);
+void computeBlockHmac(const uint8_t* data, size_t len, const uint8_t* hmacKey, size_t hmacKeyLength, uint64_t blockIndex, uint8_t hmac[32]);
+BOOL blockHmacsEqual(const uint8_t* a, const uint8_t* b);
+
 @end
 
 NS_ASSUME_NONNULL_END
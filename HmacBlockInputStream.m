@@ -11,14 +11,16 @@
 #import "Utils.h"
 #import <CommonCrypto/CommonCrypto.h>
 #import "KeePassCiphers.h"
-#import "Utils.h"
+#import "MappedFileInputStream.h"
 
 @interface HmacBlockInputStream ()
 
 @property NSUInteger workingBlockOffset;
 @property uint8_t* workingBlock;
+@property const uint8_t* currentBlock;
+@property size_t workingBlockCapacity;
 @property size_t workingBlockLength;
-@property int workingBlockIndex;
+@property uint64_t workingBlockIndex;
 
 @property NSData *hmacKey;
 @property size_t readSoFar;
@@ -49,6 +51,10 @@
     return self;
 }
 
+- (void)dealloc {
+    [self freeWorkingBlock];
+}
+
 - (void)open {
     if (self.innerStream) {
         [self.innerStream open];
@@ -61,154 +67,257 @@
         self.innerStream = nil;
     }
     
+    [self freeWorkingBlock];
+}
+
+- (void)freeWorkingBlock {
     if (self.workingBlock) {
         free(self.workingBlock);
     }
+    
     self.workingBlock = nil;
+    self.currentBlock = nil;
+    self.workingBlockCapacity = 0;
+    self.workingBlockLength = 0;
+    self.workingBlockOffset = 0;
 }
 
 - (NSInteger)read:(uint8_t *)buffer maxLength:(NSUInteger)maxLength {
     NSUInteger bufferWritten = 0;
-    NSUInteger bufferOffset = 0;
     
     while (bufferWritten < maxLength) {
-        NSUInteger bufferAvailable = maxLength - bufferWritten;
         NSUInteger workingAvailable = self.workingBlockLength - self.workingBlockOffset;
 
-        if (self.workingBlock == nil || workingAvailable == 0)  {
-            if (! [self loadNextBlock] ) {
+        if (workingAvailable == 0)  {
+            if (self.finished) {
+                break;
+            }
+            
+            HmacBlockHeader blockHeader;
+            if (![self readBlockHeader:&blockHeader]) {
                 return -1;
             }
             
-            if (self.workingBlockLength == 0) { 
+            size_t blockLength = littleEndian4BytesToUInt32(blockHeader.lengthBytes);
+            
+            if (blockLength == 0) {
+                if (![self verifyBlock:NULL length:0 header:&blockHeader]) {
+                    return -1;
+                }
+                
+                self.finished = YES;
                 break;
             }
+            
+            
+            
+            const uint8_t* mappedBlock = [self mappedBlockBody:blockLength];
+            
+            if (mappedBlock) {
+                if (![self verifyBlock:mappedBlock length:blockLength header:&blockHeader]) {
+                    return -1;
+                }
+                
+                self.currentBlock = mappedBlock;
+                self.workingBlockLength = blockLength;
+                self.workingBlockOffset = 0;
+                workingAvailable = blockLength;
+            }
+            else if (blockLength <= maxLength - bufferWritten) {
+                uint8_t *dest = &buffer[bufferWritten];
+                
+                if (![self readBlockBody:dest length:blockLength] || ![self verifyBlock:dest length:blockLength header:&blockHeader]) {
+                    return -1;
+                }
+                
+                bufferWritten += blockLength;
+                continue;
+            }
+            else {
+                if (![self ensureWorkingBlockCapacity:blockLength] ||
+                    ![self readBlockBody:self.workingBlock length:blockLength] ||
+                    ![self verifyBlock:self.workingBlock length:blockLength header:&blockHeader]) {
+                    return -1;
+                }
+                
+                self.currentBlock = self.workingBlock;
+                self.workingBlockLength = blockLength;
+                self.workingBlockOffset = 0;
+                workingAvailable = blockLength;
+            }
         }
         
-        workingAvailable = self.workingBlockLength - self.workingBlockOffset;
-        NSUInteger bytesToWriteToBuffer = MIN(bufferAvailable, workingAvailable);
+        NSUInteger bytesToWriteToBuffer = MIN(maxLength - bufferWritten, workingAvailable);
         
-        uint8_t *src = &self.workingBlock[self.workingBlockOffset];
-        uint8_t *dest = &buffer[bufferOffset];
-    
-        memcpy(dest, src, bytesToWriteToBuffer);
+        memcpy(&buffer[bufferWritten], &self.currentBlock[self.workingBlockOffset], bytesToWriteToBuffer);
         
         bufferWritten += bytesToWriteToBuffer;
-        bufferOffset += bytesToWriteToBuffer;
         self.workingBlockOffset += bytesToWriteToBuffer;
     }
     
     return bufferWritten;
 }
 
-- (BOOL)loadNextBlock {
-    if (self.finished) { 
-        if (self.workingBlock) {
-            free(self.workingBlock);
-        }
-        self.workingBlock = nil;
-        self.workingBlockLength = 0;
-        return YES;
+- (BOOL)readBlockHeader:(HmacBlockHeader*)blockHeader {
+    NSInteger bytesRead = [self.innerStream read:(uint8_t*)blockHeader maxLength:SIZE_OF_HMAC_BLOCK_HEADER];
+    
+    if (bytesRead != SIZE_OF_HMAC_BLOCK_HEADER) {
+        self.finished = YES;
+        return NO;
     }
+    
+    return YES;
+}
 
-    HmacBlockHeader blockHeader;
-    NSInteger bytesRead = [self.innerStream read:(uint8_t*)&blockHeader maxLength:SIZE_OF_HMAC_BLOCK_HEADER];
-    if (bytesRead != SIZE_OF_HMAC_BLOCK_HEADER) {
+- (const uint8_t*)mappedBlockBody:(size_t)blockLength {
+    if (![self.innerStream isKindOfClass:MappedFileInputStream.class]) {
+        return nil;
+    }
+    
+    MappedFileInputStream* mapped = (MappedFileInputStream*)self.innerStream;
+    
+    uint8_t* bytes;
+    NSUInteger available;
+    
+    if (![mapped getBuffer:&bytes length:&available] || available < blockLength) {
+        return nil;
+    }
+    
+    [mapped skip:blockLength];
+    
+    return bytes;
+}
+
+- (BOOL)ensureWorkingBlockCapacity:(size_t)blockLength {
+    if (self.workingBlockCapacity >= blockLength) {
+        return YES;
+    }
+    
+    uint8_t* grown = realloc(self.workingBlock, blockLength);
+    if (!grown) {
+        self.error = [Utils createNSError:@"Error: HmacBlockStream - Could not allocate working block." errorCode:-1];
+        self.finished = YES;
         return NO;
     }
     
-    size_t blockLength = littleEndian4BytesToUInt32(blockHeader.lengthBytes);
+    self.workingBlock = grown;
+    self.workingBlockCapacity = blockLength;
     
+    return YES;
+}
+
+- (BOOL)readBlockBody:(uint8_t*)dest length:(size_t)blockLength {
+    size_t total = 0;
     
-    if (blockLength > 0) {
-        if (self.workingBlock != nil) {
-            free(self.workingBlock);
-        }
-        self.workingBlock = malloc(blockLength);
-                                   
-        bytesRead = [self.innerStream read:self.workingBlock maxLength:blockLength];
-        if(bytesRead < 0 || bytesRead < blockLength) {
+    while (total < blockLength) {
+        NSInteger bytesRead = [self.innerStream read:&dest[total] maxLength:blockLength - total];
+        
+        if (bytesRead <= 0) {
             NSLog(@"Not enough data to decrypt Block! [%@]", self.innerStream.streamError);
             self.error = self.innerStream.streamError ? self.innerStream.streamError : [Utils createNSError:@"Error: HmacBlocStream - Could not read enough from inner stream to decrypt block." errorCode:-1];
-            free(self.workingBlock);
-            self.workingBlock = nil;
-            self.workingBlockLength = 0;
             self.finished = YES;
             return NO;
         }
         
-        self.workingBlockLength = blockLength;
-        
-        NSData *actualHmac = getBlockHmacBytes(self.workingBlock, self.workingBlockLength, self.hmacKey, self.workingBlockIndex);
-        NSData *expectedHmac = [NSData dataWithBytes:blockHeader.hmacSha256 length:CC_SHA256_DIGEST_LENGTH];
-
-        if(![actualHmac isEqualToData:expectedHmac]) {
-            NSLog(@"Actual Block HMAC does not match expected. Block has been corrupted.");
-            self.error = [Utils createNSError:@"Actual Block HMAC does not match expected. Block has been corrupted." errorCode:-1];
-            self.workingBlock = nil;
-            self.finished = YES;
-            return NO;
-        }
+        total += bytesRead;
     }
-    else {
-        if (self.workingBlock) {
-            free(self.workingBlock);
-        }
-        self.workingBlock = nil;
-        self.workingBlockLength = 0;
+    
+    return YES;
+}
+
+- (BOOL)verifyBlock:(const uint8_t*)data length:(size_t)blockLength header:(const HmacBlockHeader*)blockHeader {
+    uint8_t actualHmac[CC_SHA256_DIGEST_LENGTH];
+    
+    computeBlockHmac(data, blockLength, self.hmacKey.bytes, self.hmacKey.length, self.workingBlockIndex, actualHmac);
+
+    if (!blockHmacsEqual(actualHmac, blockHeader->hmacSha256)) {
+        NSLog(@"Actual Block HMAC does not match expected. Block has been corrupted.");
+        self.error = [Utils createNSError:@"Actual Block HMAC does not match expected. Block has been corrupted." errorCode:-1];
         self.finished = YES;
+        return NO;
     }
     
     self.readSoFar += blockLength;
-    
-    
-
     self.workingBlockIndex++;
-    self.workingBlockOffset = 0;
     
     return YES;
 }
 
-NSData* getBlockHmac(NSData *data, NSData* hmacKey, uint64_t blockIndex) {
-    return getBlockHmacBytes((uint8_t*)data.bytes, data.length, hmacKey, blockIndex);
+static inline void writeLittleEndian64(uint64_t value, uint8_t out[8]) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = (uint8_t)(value >> (8 * i));
+    }
 }
 
-NSData* getBlockHmacBytes(const uint8_t* data, size_t len, NSData* hmacKey, uint64_t blockIndex) {
-    NSData* blockKey = getHmacKeyForBlock(hmacKey, blockIndex);
-    NSData* index = Uint64ToLittleEndianData(blockIndex);
-    NSData* blockSizeData = Uint32ToLittleEndianData((uint32_t)len);
+void computeHmacKeyForBlock(const uint8_t* key, size_t keyLength, uint64_t blockIndex, uint8_t blockKey[64]) {
+    uint8_t index[8];
+    writeLittleEndian64(blockIndex, index);
+    
+    CC_SHA512_CTX ctx;
+    CC_SHA512_Init(&ctx);
+    CC_SHA512_Update(&ctx, index, sizeof(index));
+    CC_SHA512_Update(&ctx, key, (CC_LONG)keyLength);
+    CC_SHA512_Final(blockKey, &ctx);
+}
 
+void computeBlockHmac(const uint8_t* data, size_t len, const uint8_t* hmacKey, size_t hmacKeyLength, uint64_t blockIndex, uint8_t hmac[32]) {
+    uint8_t blockKey[CC_SHA512_DIGEST_LENGTH];
+    computeHmacKeyForBlock(hmacKey, hmacKeyLength, blockIndex, blockKey);
+    
+    uint8_t index[8];
+    writeLittleEndian64(blockIndex, index);
+    
+    uint8_t blockSize[4];
+    for (int i = 0; i < 4; i++) {
+        blockSize[i] = (uint8_t)((uint32_t)len >> (8 * i));
+    }
+    
     CCHmacContext ctx;
-    CCHmacInit(&ctx, kCCHmacAlgSHA256, blockKey.bytes, blockKey.length);
-    CCHmacUpdate(&ctx, index.bytes, index.length);
-    CCHmacUpdate(&ctx, blockSizeData.bytes, blockSizeData.length);
-
-    if(len){
+    CCHmacInit(&ctx, kCCHmacAlgSHA256, blockKey, sizeof(blockKey));
+    CCHmacUpdate(&ctx, index, sizeof(index));
+    CCHmacUpdate(&ctx, blockSize, sizeof(blockSize));
+    
+    if (len) {
         CCHmacUpdate(&ctx, data, len);
     }
+    
+    CCHmacFinal(&ctx, hmac);
+    
+    memset(blockKey, 0, sizeof(blockKey));
+}
+
+BOOL blockHmacsEqual(const uint8_t* a, const uint8_t* b) {
+    uint8_t diff = 0;
+    
+    for (int i = 0; i < CC_SHA256_DIGEST_LENGTH; i++) {
+        diff |= a[i] ^ b[i];
+    }
+    
+    return diff == 0;
+}
+
+NSData* getBlockHmac(NSData *data, NSData* hmacKey, uint64_t blockIndex) {
+    return getBlockHmacBytes((uint8_t*)data.bytes, data.length, hmacKey, blockIndex);
+}
 
+NSData* getBlockHmacBytes(const uint8_t* data, size_t len, NSData* hmacKey, uint64_t blockIndex) {
     NSMutableData *hmac = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH];
-    CCHmacFinal(&ctx, hmac.mutableBytes);
+    
+    computeBlockHmac(data, len, hmacKey.bytes, hmacKey.length, blockIndex, hmac.mutableBytes);
     
     return hmac;
 }
 
 NSData* getHmacKeyForBlock(NSData* key, uint64_t blockIndex) {
-    NSData* index = Uint64ToLittleEndianData(blockIndex);
-    
     NSMutableData *hash = [NSMutableData dataWithLength:CC_SHA512_DIGEST_LENGTH];
     
-    CC_SHA512_CTX ctx;
-    CC_SHA512_Init(&ctx);
-    CC_SHA512_Update(&ctx, index.bytes, (CC_LONG)index.length);
-    CC_SHA512_Update(&ctx, key.bytes, (CC_LONG)key.length);
-    CC_SHA512_Final(hash.mutableBytes, &ctx);
+    computeHmacKeyForBlock(key.bytes, key.length, blockIndex, hash.mutableBytes);
     
     return hash;
 }
 
 - (NSError *)streamError {
-    return self.error;
+    return self.error ? self.error : self.innerStream.streamError;
 }
 
 @end
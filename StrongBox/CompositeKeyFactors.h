@@ -7,6 +7,7 @@
 //
 
 #import <Foundation/Foundation.h>
+#import "TransformKeyCache.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -35,6 +36,8 @@ typedef void (^YubiKeyCRHandlerBlock)(NSData* challenge, YubiKeyCRResponseBlock
 
 @property (readonly) BOOL isAmbiguousEmptyOrNullPassword;
 
+@property (readonly) TransformKeyCache* transformKeyCache;
+
 @end
 
 NS_ASSUME_NONNULL_END
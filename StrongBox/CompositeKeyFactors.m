@@ -40,6 +40,7 @@
         _password = password;
         _keyFileDigest = keyFileDigest;
         _yubiKeyCR = yubiKeyCR;
+        _transformKeyCache = [[TransformKeyCache alloc] init];
     }
     return self;
 }
@@ -52,6 +53,8 @@
     CompositeKeyFactors *ret = [[CompositeKeyFactors alloc] initWithPassword:self.password
                                                               keyFileDigest:self.keyFileDigest
                                                                   yubiKeyCR:self.yubiKeyCR];
+    
+    ret->_transformKeyCache = self.transformKeyCache;
 
     return ret;
 }
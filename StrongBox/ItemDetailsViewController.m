@@ -1414,7 +1414,7 @@ didFinishPickingMediaWithInfo:(NSDictionary<UIImagePickerControllerInfoKey,id> *
         return;
     }
     
-    [self.databaseModel.database rebuildFastMaps];
+    [self.databaseModel.database refreshFastMapsForItems:@[ret]];
     
     
     
@@ -2248,6 +2248,8 @@ suggestionProvider:^NSString*(NSString *text) {
     
     [item restoreFromHistoricalNode:historicalNode];
     
+    [self.databaseModel.database refreshFastMapsForItems:@[item]];
+    
     [self refreshPublishAndSyncAfterModelEdit];
 }
 
@@ -2257,7 +2259,7 @@ suggestionProvider:^NSString*(NSString *text) {
     item.fields.passwordHistory = changed;
     [item touch:YES touchParents:NO];
     
-    [self.databaseModel.database rebuildFastMaps];
+    [self.databaseModel.database refreshFastMapsForItems:@[item]];
     
     [self refreshPublishAndSyncAfterModelEdit];
 }
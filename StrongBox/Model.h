@@ -237,6 +237,8 @@ extern NSString* const kAsyncUpdateStarting;
                         foldersSeparately:(BOOL)foldersSeparately;
 
 - (void)rebuildFastMaps; 
+- (void)refreshFastMapsForItems:(NSArray<Node*>*)items;
+- (void)onFastMapsChanged;
 
 #ifndef IS_APP_EXTENSION 
 
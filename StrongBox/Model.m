@@ -118,6 +118,8 @@ NSString* const kSpecialSearchTermNearlyExpiredEntries = @"strongbox:nearlyExpir
 
 - (void)closeAndCleanup { 
     NSLog(@"Model closeAndCleanup...");
+    [self.database.ckfs.transformKeyCache clear];
+    
     if (self.auditor) {
         [self.auditor stop];
         self.auditor = nil;
@@ -275,7 +277,7 @@ NSString* const kSpecialSearchTermNearlyExpiredEntries = @"strongbox:nearlyExpir
                 completion(YES);
             }
             
-            [self rebuildFastMaps];
+            [self onFastMapsChanged];
             
             [self restartBackgroundAudit];
             
@@ -416,7 +418,9 @@ NSString* const kSpecialSearchTermNearlyExpiredEntries = @"strongbox:nearlyExpir
 }
 
 - (void)postSerializationRefreshCaches {
-    [self rebuildFastMaps];
+    [self.database refreshFastMapsForModifiedItems];
+    
+    [self onFastMapsChanged];
     
     
     
@@ -706,6 +710,8 @@ NSString* const kSpecialSearchTermNearlyExpiredEntries = @"strongbox:nearlyExpir
 }
 
 - (void)restartAudit {
+    DatabaseAuditor* previous = self.auditor;
+    
     [self stopAndClearAuditor];
     
 #ifndef IS_APP_EXTENSION
@@ -713,6 +719,7 @@ NSString* const kSpecialSearchTermNearlyExpiredEntries = @"strongbox:nearlyExpir
     
     [self.auditor start:self.database
                  config:self.metadata.auditConfig
+               previous:previous
             nodesChanged:^{
 
         dispatch_async(dispatch_get_main_queue(), ^{
@@ -1226,12 +1233,25 @@ NSString* const kSpecialSearchTermNearlyExpiredEntries = @"strongbox:nearlyExpir
           browseSortField:(BrowseSortField)browseSortField
                descending:(BOOL)descending
         foldersSeparately:(BOOL)foldersSeparately {
-    NSArray<Node*>* nodes = trueRoot ? self.database.allSearchableTrueRootIncludingRecycled : self.database.allSearchableIncludingRecycled;
-
-    NSMutableArray* results = [nodes mutableCopy]; 
-    
     NSArray<NSString*>* terms = [self.database getSearchTerms:searchText];
     
+    NSArray<NSString*>* textTerms = [terms filter:^BOOL(NSString * _Nonnull obj) {
+        return ![self isSpecialSearchTerm:obj];
+    }];
+    
+    NSSet<Node*>* candidates = [self.database getSearchCandidates:textTerms
+                                                            scope:scope
+                                                      dereference:dereference];
+    
+    NSMutableArray* results;
+    if ( candidates ) {
+        results = [[self.database searchableIncludingRecycledFromCandidates:candidates trueRoot:trueRoot] mutableCopy];
+    }
+    else {
+        NSArray<Node*>* nodes = trueRoot ? self.database.allSearchableTrueRootIncludingRecycled : self.database.allSearchableIncludingRecycled;
+        results = [nodes mutableCopy];
+    }
+    
     for (NSString* word in terms) {
         [self filterForWord:results
                  searchText:word
@@ -1266,6 +1286,14 @@ NSString* const kSpecialSearchTermNearlyExpiredEntries = @"strongbox:nearlyExpir
     return [self sortItemsForBrowse:nodes browseSortField:browseSortField descending:descending foldersSeparately:foldersSeparately];
 }
 
+- (BOOL)isSpecialSearchTerm:(NSString*)searchText {
+    return [searchText isEqualToString:kSpecialSearchTermAllEntries] ||
+           [searchText isEqualToString:kSpecialSearchTermAuditEntries] ||
+           [searchText isEqualToString:kSpecialSearchTermTotpEntries] ||
+           [searchText isEqualToString:kSpecialSearchTermExpiredEntries] ||
+           [searchText isEqualToString:kSpecialSearchTermNearlyExpiredEntries];
+}
+
 - (void)filterForWord:(NSMutableArray<Node*>*)searchNodes
            searchText:(NSString *)searchText
                 scope:(NSInteger)scope
@@ -1555,6 +1583,16 @@ NSString* const kSpecialSearchTermNearlyExpiredEntries = @"strongbox:nearlyExpir
 - (void)rebuildFastMaps {
     [self.database rebuildFastMaps];
     
+    [self onFastMapsChanged];
+}
+
+- (void)refreshFastMapsForItems:(NSArray<Node *> *)items {
+    [self.database refreshFastMapsForItems:items];
+    
+    [self onFastMapsChanged];
+}
+
+- (void)onFastMapsChanged {
     [self rebuildAutoFillDomainNodeMap];
     
     
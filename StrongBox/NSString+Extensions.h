@@ -32,9 +32,12 @@ NS_ASSUME_NONNULL_BEGIN
 @property (readonly, nullable) NSData* utf8Data;
 
 @property (readonly) BOOL isAllDigits;
+@property (readonly) BOOL containsHanCharacters;
 
 - (BOOL)containsSearchString:(NSString*)searchText checkPinYin:(BOOL)checkPinYin;
 
+@property (readonly, nullable) NSString* pinYinLatinized;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -289,30 +289,26 @@ static NSString* const kLowerCaseNull = @"null";
     
     
     
-    NSTextCheckingResult* result = [[NSString hanChineseRegex] firstMatchInString:self options:kNilOptions range:NSMakeRange(0, self.length)];
+    NSString* pinYinStr = self.pinYinLatinized;
     
-    if ( result ) {
-        
-        
-        
-        
-        NSMutableString* latinized = self.mutableCopy;
-        CFStringTransform((__bridge CFMutableStringRef)latinized, nil, kCFStringTransformMandarinLatin, NO);
-        CFStringTransform((__bridge CFMutableStringRef)latinized, nil, kCFStringTransformStripDiacritics, NO);
-
-        NSString* pinYinStr = [latinized stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
-        pinYinStr = [pinYinStr stringByReplacingOccurrencesOfString:@"\r" withString:@""];
-        pinYinStr = [pinYinStr stringByReplacingOccurrencesOfString:@"\n" withString:@""];
-        pinYinStr = [pinYinStr stringByReplacingOccurrencesOfString:@" " withString:@""];
-
-        
-
-        BOOL latinizedPinYin = [pinYinStr localizedStandardContainsString:searchText];
+    return pinYinStr ? [pinYinStr localizedStandardContainsString:searchText] : NO;
+}
 
-        return latinizedPinYin;
+- (NSString *)pinYinLatinized {
+    if ( !self.containsHanCharacters ) {
+        return nil;
     }
     
-    return NO;
+    NSMutableString* latinized = self.mutableCopy;
+    CFStringTransform((__bridge CFMutableStringRef)latinized, nil, kCFStringTransformMandarinLatin, NO);
+    CFStringTransform((__bridge CFMutableStringRef)latinized, nil, kCFStringTransformStripDiacritics, NO);
+
+    NSString* pinYinStr = [latinized stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
+    pinYinStr = [pinYinStr stringByReplacingOccurrencesOfString:@"\r" withString:@""];
+    pinYinStr = [pinYinStr stringByReplacingOccurrencesOfString:@"\n" withString:@""];
+    pinYinStr = [pinYinStr stringByReplacingOccurrencesOfString:@" " withString:@""];
+    
+    return pinYinStr;
 }
 
 - (void)enumerateCharactersWithBlock:(void (^)(unichar, NSUInteger, BOOL *))block {
@@ -341,4 +337,12 @@ static NSString* const kLowerCaseNull = @"null";
     return r.location == NSNotFound && self.length > 0;
 }
 
+- (BOOL)containsHanCharacters {
+    if ( self.length == 0 ) {
+        return NO;
+    }
+    
+    return [[NSString hanChineseRegex] firstMatchInString:self options:kNilOptions range:NSMakeRange(0, self.length)] != nil;
+}
+
 @end
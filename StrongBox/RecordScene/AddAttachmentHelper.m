@@ -13,6 +13,7 @@
 #import "SVProgressHUD.h"
 #import "UIImage+FixOrientation.h"
 #import "NSDate+Extensions.h"
+#import "DatabaseAttachmentStore.h"
 
 const int kMaxRecommendedAttachmentSize = 512 * 1024; 
 
@@ -321,7 +322,7 @@ const int kMaxRecommendedAttachmentSize = 512 * 1024;
                                   else {
                                       if(self.onAdd) {
                                           NSInputStream* inputStream = [NSInputStream inputStreamWithData:data];
-                                          DatabaseAttachment *dbAttachment = [[DatabaseAttachment alloc] initWithStream:inputStream length:data.length protectedInMemory:YES compressed:YES];
+                                          DatabaseAttachment *dbAttachment = [DatabaseAttachmentStore.sharedInstance internNew:[[DatabaseAttachment alloc] initWithStream:inputStream length:data.length protectedInMemory:YES compressed:YES]];
                                           
                                           NSLog(@"Adding Attachment: [%@]-[%@]", text, dbAttachment.digestHash);
                                           
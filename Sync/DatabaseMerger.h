@@ -15,6 +15,10 @@ NS_ASSUME_NONNULL_BEGIN
 @interface DatabaseMerger : NSObject
 
 + (instancetype)mergerFor:(DatabaseModel *)mine theirs:(DatabaseModel *)theirs;
++ (instancetype)mergerFor:(DatabaseModel *)mine theirs:(DatabaseModel *)theirs batched:(BOOL)batched;
+
+@property (readonly) BOOL batched;
+@property (readonly, nullable) MergeDryRunReport* report;
 
 - (MergeDryRunReport *)dryRun;
 
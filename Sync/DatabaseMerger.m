@@ -15,6 +15,19 @@
 #import "DatabaseDiffer.h"
 #import "MergeDryRunReport.h"
 
+static const BOOL kBatchedMerge = YES;
+
+@interface MergeSiblings : NSObject
+
+@property NSArray<Node*>* children;
+@property NSMapTable<Node*, NSNumber*>* indexes;
+
+@end
+
+@implementation MergeSiblings
+
+@end
+
 @interface DatabaseMerger ()
 
 @property DatabaseModel* mine; 
@@ -28,20 +41,34 @@
 @property (readonly) BOOL canCompareGroupNodes;
 @property (readonly) BOOL canCompareNodeLocations;
 @property (readonly) BOOL canDetectDeletions;
+
+@property (readonly) NSMutableDictionary<NSUUID*, Node*>* addedNodes;
+@property (readonly) NSMutableSet<NSUUID*>* deletedIds;
+@property (readonly) NSMapTable<Node*, MergeSiblings*>* theirSiblings;
+@property (nullable) MergeDryRunReport* report;
     
 @end
 
 @implementation DatabaseMerger
 
 + (instancetype)mergerFor:(DatabaseModel *)mine theirs:(DatabaseModel *)theirs {
-    return [[DatabaseMerger alloc] initSynchronizerFor:mine theirs:theirs];
+    return [DatabaseMerger mergerFor:mine theirs:theirs batched:kBatchedMerge];
 }
 
-- (instancetype)initSynchronizerFor:(DatabaseModel *)mine theirs:(DatabaseModel *)theirs {
++ (instancetype)mergerFor:(DatabaseModel *)mine theirs:(DatabaseModel *)theirs batched:(BOOL)batched {
+    return [[DatabaseMerger alloc] initSynchronizerFor:mine theirs:theirs batched:batched];
+}
+
+- (instancetype)initSynchronizerFor:(DatabaseModel *)mine theirs:(DatabaseModel *)theirs batched:(BOOL)batched {
     self = [super init];
     if (self) {
         self.mine = mine;
         self.theirs = theirs;
+        _batched = batched;
+        _addedNodes = NSMutableDictionary.dictionary;
+        _deletedIds = NSMutableSet.set;
+        _theirSiblings = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                               valueOptions:NSPointerFunctionsStrongMemory];
         
         
         _useEffectiveRoot = ![self.mine.effectiveRootGroup.uuid isEqual:self.theirs.effectiveRootGroup.uuid];
@@ -51,13 +78,15 @@
 }
 
 - (MergeDryRunReport *)dryRun {
-    MergeDryRunReport* ret = [[MergeDryRunReport alloc] init];
-    
     DatabaseModel* clone = [self.mine clone];
     
-    DatabaseMerger *syncer = [DatabaseMerger mergerFor:clone theirs:self.theirs];
+    DatabaseMerger *syncer = [DatabaseMerger mergerFor:clone theirs:self.theirs batched:self.batched];
 
-    ret.success = [syncer merge];
+    BOOL success = [syncer merge];
+    
+    MergeDryRunReport* ret = syncer.report ? syncer.report : [[MergeDryRunReport alloc] init];
+    ret.success = success;
+    
     if (ret.success) {
         ret.diff = [DatabaseDiffer diff:self.mine second:clone];
     }
@@ -92,34 +121,89 @@
 - (BOOL)merge {
     NSLog(@"DatabaseMerger::merge BEGIN");
     
+    MergeDryRunReport* report = [[MergeDryRunReport alloc] init];
+    report.batched = self.batched;
+    self.report = report;
+    
+    NSTimeInterval startTime = NSDate.timeIntervalSinceReferenceDate;
+    NSTimeInterval phaseStart = startTime;
+    
     if ( ![self manageAdditionsAndEdits] ) {
         return NO;
     }
-    [self.mine rebuildFastMaps];
+    [self rebuildFastMapsUnlessBatched];
+    
+    report.additionsAndEditsDuration = NSDate.timeIntervalSinceReferenceDate - phaseStart;
+    phaseStart = NSDate.timeIntervalSinceReferenceDate;
     
     if (self.canCompareNodeLocations) {
         if (![self manageMoves]) {
             return NO;
         }
         
-        [self.mine rebuildFastMaps];
+        [self rebuildFastMapsUnlessBatched];
     }
     
+    report.movesDuration = NSDate.timeIntervalSinceReferenceDate - phaseStart;
+    phaseStart = NSDate.timeIntervalSinceReferenceDate;
+    
     if (self.canDetectDeletions) {
         [self manageDeletions];
         
-        [self.mine rebuildFastMaps];
+        [self rebuildFastMapsUnlessBatched];
     }
     
+    report.deletionsDuration = NSDate.timeIntervalSinceReferenceDate - phaseStart;
+    phaseStart = NSDate.timeIntervalSinceReferenceDate;
+    
     [self manageDatabaseProperties];
     
     [self.mine performPreSerializationTidy];
 
+    report.propertiesDuration = NSDate.timeIntervalSinceReferenceDate - phaseStart;
+    phaseStart = NSDate.timeIntervalSinceReferenceDate;
+    
     [self.mine rebuildFastMaps];
     
+    [self.addedNodes removeAllObjects];
+    [self.deletedIds removeAllObjects];
+    [self.theirSiblings removeAllObjects];
+    
+    report.indexDuration = NSDate.timeIntervalSinceReferenceDate - phaseStart;
+    report.totalDuration = NSDate.timeIntervalSinceReferenceDate - startTime;
+    
+    NSLog(@"====================================== PERF ======================================");
+    NSLog(@"MERGE (batched = %d) took [%f] seconds. Added %lu, Edited %lu, Moved %lu, Deleted %lu. Additions/Edits [%f], Moves [%f], Deletions [%f], Properties [%f], Index [%f]",
+          self.batched, report.totalDuration,
+          (unsigned long)report.added, (unsigned long)report.edited, (unsigned long)report.moved, (unsigned long)report.deleted,
+          report.additionsAndEditsDuration, report.movesDuration, report.deletionsDuration, report.propertiesDuration, report.indexDuration);
+    NSLog(@"====================================== PERF ======================================");
+    
     return YES;
 }
 
+- (void)rebuildFastMapsUnlessBatched {
+    if ( !self.batched ) {
+        [self.mine rebuildFastMaps];
+    }
+}
+
+- (Node*)myItemById:(NSUUID*)uuid {
+    if ( self.batched && uuid ) {
+        if ( [self.deletedIds containsObject:uuid] ) {
+            return nil;
+        }
+        
+        Node* added = self.addedNodes[uuid];
+        
+        if ( added ) {
+            return added;
+        }
+    }
+    
+    return [self.mine getItemById:uuid];
+}
+
 - (void)manageDatabaseProperties {
     UnifiedDatabaseMetadata* me = self.mine.meta;
     UnifiedDatabaseMetadata* thee = self.theirs.meta;
@@ -160,10 +244,10 @@
 
     
     
-    if ([self.mine getItemById:newBin]) {
+    if ([self myItemById:newBin]) {
         me.recycleBinGroup = newBin;
     }
-    else if ([self.mine getItemById:fallbackBin]) {
+    else if ([self myItemById:fallbackBin]) {
         me.recycleBinGroup = fallbackBin;
     }
     else {
@@ -182,10 +266,10 @@
 
     
     
-    if ([self.mine getItemById:newEtg]) {
+    if ([self myItemById:newEtg]) {
         me.entryTemplatesGroup = newEtg;
     }
-    else if ([self.mine getItemById:fallbackEtg]) {
+    else if ([self myItemById:fallbackEtg]) {
         me.entryTemplatesGroup = fallbackEtg;
     }
     else {
@@ -245,7 +329,7 @@
             return YES;
         }
         
-        Node* myVersion = [self.mine getItemById:theirVersion.uuid];
+        Node* myVersion = [self myItemById:theirVersion.uuid];
         if (myVersion) {
             if (myVersion.isGroup != theirVersion.isGroup) {
                 error = YES;
@@ -268,11 +352,15 @@
                     error = YES;
                 }
             }
+            
+            self.report.edited++;
         }
         else {
             if (! [self simpleMergeNewNodeIn:theirVersion] ) {
                 error = YES;
             }
+            
+            self.report.added++;
         }
         
         return !error;
@@ -288,6 +376,16 @@
     NSInteger position = [self determineBestPosition:myEquivalentParentContainer theirParentGroup:theirParentContainer theirVersion:theirVersion];
     Node *ours = [theirVersion cloneAsChildOf:myEquivalentParentContainer];
     
+    if ( self.batched ) {
+        if ( ![self.mine insertChildren:@[ours] destination:myEquivalentParentContainer atPosition:position suppressFastMapsRebuild:YES] ) {
+            return NO;
+        }
+        
+        self.addedNodes[ours.uuid] = ours;
+        
+        return YES;
+    }
+    
     return [self.mine insertChildren:@[ours] destination:myEquivalentParentContainer atPosition:position];
 }
 
@@ -376,7 +474,7 @@
     Node* myEquivalentParentContainer = self.myRoot;
 
     if(theirParentContainer != nil && theirParentContainer != self.theirRoot) {
-        Node* tmp = [self.mine getItemById:theirParentContainer.uuid];
+        Node* tmp = [self myItemById:theirParentContainer.uuid];
         if (tmp) {
             myEquivalentParentContainer = tmp;
         }
@@ -416,6 +514,8 @@
 
         if([theirVersion.fields.locationChanged isLaterThan:myNode.fields.locationChanged]) {
             Node* myParentGroup = myNode.parent;
+            self.report.moved++;
+            
             if([myParentGroup.uuid isEqual:theirParentGroup.uuid]) {
                 NSLog(@"Reordering Node [%@]...", myNode);
                 NSInteger position = [self determineBestPosition:myParentGroup theirParentGroup:theirParentGroup theirVersion:theirVersion];
@@ -426,7 +526,7 @@
             else {
                 NSLog(@"Relocating Node [%@]...", myNode);
             
-                Node* myEquivalentParent = [self.mine getItemById:theirParentGroup.uuid];
+                Node* myEquivalentParent = [self myItemById:theirParentGroup.uuid];
                     
                 if (myEquivalentParent == nil) {
                     NSLog(@"WARNWARN: Could not find equivalent parent group");
@@ -518,6 +618,21 @@
         }
     }
     
+    self.report.deleted += toBeDeleted.count;
+    
+    if ( self.batched ) {
+        for ( Node* item in toBeDeleted ) {
+            [item.parent removeChild:item];
+            [self.deletedIds addObject:item.uuid];
+
+            for ( Node* child in item.allChildren ) {
+                [self.deletedIds addObject:child.uuid];
+            }
+        }
+        
+        return;
+    }
+    
     NSArray<NSUUID*>* uuids = [toBeDeleted map:^id _Nonnull(Node * _Nonnull obj, NSUInteger idx) {
         return obj.uuid;
     }];
@@ -528,31 +643,28 @@
 - (NSUInteger)determineBestPosition:(Node*)myProspectiveParentGroup theirParentGroup:(Node*)theirParentGroup theirVersion:(Node*)theirVersion {
     
     
-    NSUInteger theirIndex = [theirParentGroup.children indexOfObject:theirVersion];
+    NSArray<Node*>* theirSiblings = nil;
+    NSUInteger theirIndex = [self indexOfTheirNode:theirVersion inParent:theirParentGroup siblings:&theirSiblings];
     if (theirIndex == NSNotFound) {
         return -1;
     }
     
-    if (theirIndex < (theirParentGroup.children.count - 1)) {
-        Node* afterTheirs = theirParentGroup.children[theirIndex+1];
-        Node* myEquiv = [myProspectiveParentGroup firstOrDefault:NO predicate:^BOOL(Node * _Nonnull node) {
-            return [node.uuid isEqual:afterTheirs.uuid];
-        }];
+    if (theirIndex < (theirSiblings.count - 1)) {
+        Node* afterTheirs = theirSiblings[theirIndex+1];
+        Node* myEquiv = [self myChildWithUuid:afterTheirs.uuid parent:myProspectiveParentGroup];
         
         if (myEquiv) {
-            NSInteger index  = [myProspectiveParentGroup.children indexOfObject:myEquiv];
+            NSInteger index  = [self indexOfMyChild:myEquiv parent:myProspectiveParentGroup];
             return MAX(0, index - 1);
         }
         else if (theirIndex > 0) {
             
             
-            Node* beforeTheirs = theirParentGroup.children[theirIndex-1];
-            Node* myEquiv = [myProspectiveParentGroup firstOrDefault:NO predicate:^BOOL(Node * _Nonnull node) {
-                return [node.uuid isEqual:beforeTheirs.uuid];
-            }];
+            Node* beforeTheirs = theirSiblings[theirIndex-1];
+            Node* myEquiv = [self myChildWithUuid:beforeTheirs.uuid parent:myProspectiveParentGroup];
             
             if (myEquiv) {
-                return [myProspectiveParentGroup.children indexOfObject:myEquiv];
+                return [self indexOfMyChild:myEquiv parent:myProspectiveParentGroup];
             }
         }
         else if (theirIndex == 0) {
@@ -565,4 +677,48 @@
     return -1;
 }
 
+- (NSUInteger)indexOfTheirNode:(Node*)theirVersion inParent:(Node*)theirParentGroup siblings:(NSArray<Node*>**)siblings {
+    if ( !self.batched || theirParentGroup == nil ) {
+        *siblings = theirParentGroup.children;
+        return [*siblings indexOfObject:theirVersion];
+    }
+    
+    MergeSiblings* cached = [self.theirSiblings objectForKey:theirParentGroup];
+    
+    if ( cached == nil ) {
+        cached = [[MergeSiblings alloc] init];
+        cached.children = theirParentGroup.children;
+        cached.indexes = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                               valueOptions:NSPointerFunctionsStrongMemory];
+        
+        for ( NSUInteger i = 0; i < cached.children.count; i++ ) {
+            [cached.indexes setObject:@(i) forKey:cached.children[i]];
+        }
+        
+        [self.theirSiblings setObject:cached forKey:theirParentGroup];
+    }
+    
+    *siblings = cached.children;
+    
+    NSNumber* index = [cached.indexes objectForKey:theirVersion];
+    
+    return index ? index.unsignedIntegerValue : NSNotFound;
+}
+
+- (Node*)myChildWithUuid:(NSUUID*)uuid parent:(Node*)myParentGroup {
+    if ( !self.batched ) {
+        return [myParentGroup firstOrDefault:NO predicate:^BOOL(Node * _Nonnull node) {
+            return [node.uuid isEqual:uuid];
+        }];
+    }
+    
+    Node* candidate = [self myItemById:uuid];
+    
+    return candidate.parent == myParentGroup ? candidate : nil;
+}
+
+- (NSUInteger)indexOfMyChild:(Node*)child parent:(Node*)myParentGroup {
+    return self.batched ? [myParentGroup indexOfChild:child] : [myParentGroup.children indexOfObject:child];
+}
+
 @end
@@ -18,6 +18,20 @@ NS_ASSUME_NONNULL_BEGIN
 @property BOOL success;
 @property DiffSummary* diff;
 
+@property BOOL batched;
+
+@property NSUInteger added;
+@property NSUInteger edited;
+@property NSUInteger moved;
+@property NSUInteger deleted;
+
+@property NSTimeInterval additionsAndEditsDuration;
+@property NSTimeInterval movesDuration;
+@property NSTimeInterval deletionsDuration;
+@property NSTimeInterval propertiesDuration;
+@property NSTimeInterval indexDuration;
+@property NSTimeInterval totalDuration;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -251,6 +251,7 @@ class DatabasesCollection: NSObject {
     }
     
     @objc func forceLock ( uuid : String ) {
+        getUnlocked(uuid: uuid)?.database.ckfs.transformKeyCache.clear()
         unlockedCollection.removeObject(forKey: uuid as NSString)
         stopPollForRemoteChangesTimer(uuid: uuid)
         NSLog("✅ unlocked database [%@] removed from collection...", uuid)
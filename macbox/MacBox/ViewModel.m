@@ -19,6 +19,7 @@
 #import "Serializator.h"
 #import "Utils.h"
 #import "Document.h"
+#import "DatabaseAttachmentStore.h"
 
 #import "Strongbox-Swift.h"
 
@@ -310,8 +311,6 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
         return;
     }
     
-    [self rebuildFastMaps];
-    
     [self.innerModel update:viewController handler:handler];
 }
 
@@ -655,7 +654,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
         NSString* loc = NSLocalizedString(@"mac_undo_action_title_change", @"Title Change");
         [self.document.undoManager setActionName:loc];
         
-        [self rebuildFastMaps];
+        [self refreshFastMapsForItems:@[item]];
         
         dispatch_async(dispatch_get_main_queue(), ^{
             [NSNotificationCenter.defaultCenter postNotificationName:kModelUpdateNotificationTitleChanged object:self userInfo:@{ kNotificationUserInfoKeyNode : item }];
@@ -696,7 +695,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
     NSString* loc = NSLocalizedString(@"mac_undo_action_email_change", @"Email Change");
     [self.document.undoManager setActionName:loc];
     
-    [self rebuildFastMaps];
+    [self refreshFastMapsForItems:@[item]];
     
     dispatch_async(dispatch_get_main_queue(), ^{
         [NSNotificationCenter.defaultCenter postNotificationName:kModelUpdateNotificationEmailChanged object:self userInfo:@{ kNotificationUserInfoKeyNode : item }];
@@ -740,7 +739,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
     NSString* loc = NSLocalizedString(@"mac_undo_action_username_change", @"Username Change");
     [self.document.undoManager setActionName:loc];
     
-    [self rebuildFastMaps];
+    [self refreshFastMapsForItems:@[item]];
     
     dispatch_async(dispatch_get_main_queue(), ^{
         [NSNotificationCenter.defaultCenter postNotificationName:kModelUpdateNotificationUsernameChanged object:self userInfo:@{ kNotificationUserInfoKeyNode : item }];
@@ -775,7 +774,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
     NSString* loc = NSLocalizedString(@"mac_undo_action_url_change", @"URL Change");
     [self.document.undoManager setActionName:loc];
     
-    [self rebuildFastMaps];
+    [self refreshFastMapsForItems:@[item]];
     
     dispatch_async(dispatch_get_main_queue(), ^{
         [NSNotificationCenter.defaultCenter postNotificationName:kModelUpdateNotificationUrlChanged object:self userInfo:@{ kNotificationUserInfoKeyNode : item }];
@@ -816,7 +815,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
     NSString* loc = NSLocalizedString(@"mac_undo_action_password_change", @"Password Change");
     [self.document.undoManager setActionName:loc];
     
-    [self rebuildFastMaps];
+    [self refreshFastMapsForItems:@[item]];
     
     dispatch_async(dispatch_get_main_queue(), ^{
         [NSNotificationCenter.defaultCenter postNotificationName:kModelUpdateNotificationPasswordChanged object:self userInfo:@{ kNotificationUserInfoKeyNode : item }];
@@ -851,7 +850,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
     NSString* loc = NSLocalizedString(@"mac_undo_action_notes_change", @"Notes Change");
     [self.document.undoManager setActionName:loc];
     
-    [self rebuildFastMaps];
+    [self refreshFastMapsForItems:@[item]];
     
     dispatch_async(dispatch_get_main_queue(), ^{
         [NSNotificationCenter.defaultCenter postNotificationName:kModelUpdateNotificationNotesChanged object:self userInfo:@{ kNotificationUserInfoKeyNode : item }];
@@ -886,7 +885,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
     NSString* loc = NSLocalizedString(@"mac_undo_action_expiry_change", @"Expiry Date Change");
     [self.document.undoManager setActionName:loc];
     
-    [self rebuildFastMaps];
+    [self refreshFastMapsForItems:@[item]];
     
     dispatch_async(dispatch_get_main_queue(), ^{
         [NSNotificationCenter.defaultCenter postNotificationName:kModelUpdateNotificationExpiryChanged object:self userInfo:@{ kNotificationUserInfoKeyNode : item }];
@@ -960,8 +959,6 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
         }
     }
     
-    [self rebuildFastMaps];
-    
     NSString* loc = NSLocalizedString(@"browse_prefs_tap_action_edit", @"Edit Item");
     
     [self.document.undoManager setActionName:loc];
@@ -1004,7 +1001,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
         NSString* loc = NSLocalizedString(@"browse_prefs_tap_action_edit", @"Edit Item");
         [self.document.undoManager setActionName:loc];
         
-        [self rebuildFastMaps];
+        [self refreshFastMapsForItems:@[destinationNode]];
         
         dispatch_async(dispatch_get_main_queue(), ^{
             [NSNotificationCenter.defaultCenter postNotificationName:kModelUpdateNotificationItemEdited object:self userInfo:@{ kNotificationUserInfoKeyNode : destinationNode }];
@@ -1261,7 +1258,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
     
     [self touchAndModify:item modDate:modified];
     
-    [self rebuildFastMaps];
+    [self refreshFastMapsForItems:@[item]];
     
     dispatch_async(dispatch_get_main_queue(), ^{
         [NSNotificationCenter.defaultCenter postNotificationName:kModelUpdateNotificationAttachmentsChanged object:self userInfo:@{ kNotificationUserInfoKeyNode : item }];
@@ -1291,7 +1288,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
     
     NSDate* oldModified = item.fields.modified;
     
-    item.fields.attachments[filename] = attachment;
+    item.fields.attachments[filename] = [DatabaseAttachmentStore.sharedInstance internNew:attachment];
     [self touchAndModify:item modDate:modified];
     
     [[self.document.undoManager prepareWithInvocationTarget:self] removeItemAttachment:item filename:filename modified:oldModified];
@@ -1301,7 +1298,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
         [self.document.undoManager setActionName:loc];
     }
     
-    [self rebuildFastMaps];
+    [self refreshFastMapsForItems:@[item]];
     
     dispatch_async(dispatch_get_main_queue(), ^{
         [NSNotificationCenter.defaultCenter postNotificationName:kModelUpdateNotificationAttachmentsChanged object:self userInfo:@{ kNotificationUserInfoKeyNode : item }];
@@ -1391,7 +1388,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
             [self.document.undoManager setActionName:loc];
         }
         
-        [self rebuildFastMaps];
+        [self refreshFastMapsForItems:@[item]];
         
         dispatch_async(dispatch_get_main_queue(), ^{
             [NSNotificationCenter.defaultCenter postNotificationName:kModelUpdateNotificationCustomFieldsChanged object:self userInfo:@{ kNotificationUserInfoKeyNode : item }];
@@ -1435,7 +1432,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
         [self.document.undoManager setActionName:loc];
     }
     
-    [self rebuildFastMaps];
+    [self refreshFastMapsForItems:@[item]];
     
     dispatch_async(dispatch_get_main_queue(), ^{
         [NSNotificationCenter.defaultCenter postNotificationName:kModelUpdateNotificationTotpChanged object:self userInfo:@{ kNotificationUserInfoKeyNode : item }];
@@ -1476,7 +1473,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
         [self.document.undoManager setActionName:loc];
     }
     
-    [self rebuildFastMaps];
+    [self refreshFastMapsForItems:@[item]];
     
     dispatch_async(dispatch_get_main_queue(), ^{
         [NSNotificationCenter.defaultCenter postNotificationName:kModelUpdateNotificationTotpChanged object:self userInfo:@{ kNotificationUserInfoKeyNode : item }];
@@ -1604,7 +1601,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
     }
     [self.document.undoManager endUndoGrouping];
     
-    [self rebuildFastMaps];
+    [self refreshFastMapsForItems:(NSArray*)items];
     
     dispatch_async(dispatch_get_main_queue(), ^{
         [NSNotificationCenter.defaultCenter postNotificationName:kModelUpdateNotificationTagsChanged object:self userInfo:nil];
@@ -1667,7 +1664,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
     }
     [self.document.undoManager endUndoGrouping];
     
-    [self rebuildFastMaps];
+    [self refreshFastMapsForItems:(NSArray*)items];
     
     dispatch_async(dispatch_get_main_queue(), ^{
         [NSNotificationCenter.defaultCenter postNotificationName:kModelUpdateNotificationTagsChanged object:self userInfo:nil];
@@ -1694,7 +1691,9 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
     
     [self.document.undoManager beginUndoGrouping];
     
-    for ( Node* item in [self entriesWithTag:from] ) {
+    NSArray<Node*>* items = [self entriesWithTag:from];
+    
+    for ( Node* item in items ) {
         NSDate* oldModified = item.fields.modified;
         
         if(self.document.undoManager.isUndoing) {
@@ -1719,7 +1718,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
     }
     [self.document.undoManager endUndoGrouping];
     
-    [self rebuildFastMaps];
+    [self refreshFastMapsForItems:items];
     
     dispatch_async(dispatch_get_main_queue(), ^{
         [NSNotificationCenter.defaultCenter postNotificationName:kModelUpdateNotificationTagsChanged object:self userInfo:nil];
@@ -1813,7 +1812,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
                                                                 kNotificationUserInfoKeyBoolParam : @(openEntryDetailsWindowWhenDone)
                                                              }];
     
-    [self rebuildFastMaps];
+    [self onFastMapsChanged];
     
     return YES;
 }
@@ -1844,7 +1843,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
     NSString* loc = children.count > 1 ? NSLocalizedString(@"mac_undo_action_add_items", @"Add Items") : NSLocalizedString(@"mac_undo_action_add_item", @"Add Item");
     [self.document.undoManager setActionName:loc];
     
-    [self rebuildFastMaps];
+    [self onFastMapsChanged];
     
     [NSNotificationCenter.defaultCenter postNotificationName:kModelUpdateNotificationItemsDeleted
                                                       object:self
@@ -1878,7 +1877,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
                                                       object:self
                                                     userInfo:@{ kNotificationUserInfoKeyNode : items }];
     
-    [self rebuildFastMaps];
+    [self onFastMapsChanged];
 }
 
 - (void)unDeleteItems:(NSArray<NodeHierarchyReconstructionData*>*)undoData {
@@ -1903,7 +1902,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
     
     [self.document.undoManager setActionName:loc];
     
-    [self rebuildFastMaps];
+    [self onFastMapsChanged];
     
     [NSNotificationCenter.defaultCenter postNotificationName:kModelUpdateNotificationItemsUnDeleted
                                                       object:self
@@ -1936,7 +1935,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
                                                         userInfo:@{ kNotificationUserInfoKeyNode : items }];
     }
     
-    [self rebuildFastMaps];
+    [self onFastMapsChanged];
     
     return ret;
 }
@@ -1967,7 +1966,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
                                                       object:self
                                                     userInfo:nil];
     
-    [self rebuildFastMaps];
+    [self onFastMapsChanged];
 }
 
 
@@ -2002,7 +2001,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
                                                         userInfo:@{ kNotificationUserInfoKeyNode : items }];
     }
     
-    [self rebuildFastMaps];
+    [self onFastMapsChanged];
     
     return ret;
 }
@@ -2033,7 +2032,7 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
                                                       object:self
                                                     userInfo:nil];
     
-    [self rebuildFastMaps];
+    [self onFastMapsChanged];
 }
 
 - (BOOL)moveItemsIntoNewGroup:(const NSArray<Node *> *)items parentGroup:(Node *)parentGroup title:(NSString *)title group:(Node **)group {
@@ -2873,4 +2872,12 @@ NSString* const kNotificationUserInfoKeyBoolParam = @"boolean";
     [self.innerModel rebuildFastMaps];
 }
 
+- (void)refreshFastMapsForItems:(NSArray<Node*>*)items {
+    [self.innerModel refreshFastMapsForItems:items];
+}
+
+- (void)onFastMapsChanged {
+    [self.innerModel onFastMapsChanged];
+}
+
 @end
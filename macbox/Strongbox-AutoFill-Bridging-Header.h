@@ -51,6 +51,7 @@
 #import "SafeStorageProvider.h"
 #import "HeaderNodeState.h"
 #import "Serializator.h"
+#import "TransformKeyCache.h"
 #import "StrongboxErrorCodes.h"
 #import "DatabaseDiffer.h"
 #import "macOSSpinnerUI.h"
@@ -52,6 +52,7 @@
 #import "SafeStorageProvider.h"
 #import "HeaderNodeState.h"
 #import "Serializator.h"
+#import "TransformKeyCache.h"
 #import "StrongboxErrorCodes.h"
 #import "DatabaseDiffer.h"
 #import "macOSSpinnerUI.h"
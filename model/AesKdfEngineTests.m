@@ -0,0 +1,81 @@
+//
+//  AesKdfEngineTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <CommonCrypto/CommonCrypto.h>
+#import "AesKdfEngine.h"
+
+@interface AesKdfEngineTests : XCTestCase
+
+@end
+
+@implementation AesKdfEngineTests
+
+- (NSData*)commonCryptoTransform:(NSData*)data key:(NSData*)key rounds:(uint64_t)rounds {
+    NSMutableData* ret = data.mutableCopy;
+
+    CCCryptorRef cryptorRef;
+    XCTAssertEqual(CCCryptorCreate(kCCEncrypt, kCCAlgorithmAES, kCCOptionECBMode, key.bytes, key.length, NULL, &cryptorRef), kCCSuccess);
+
+    size_t tmp;
+    for ( uint64_t i = 0; i < rounds; i++ ) {
+        XCTAssertEqual(CCCryptorUpdate(cryptorRef, ret.mutableBytes, 32, ret.mutableBytes, 32, &tmp), kCCSuccess);
+    }
+
+    CCCryptorRelease(cryptorRef);
+
+    return ret;
+}
+
+- (NSData*)engineTransform:(NSData*)data key:(NSData*)key rounds:(uint64_t)rounds {
+    NSMutableData* ret = data.mutableCopy;
+    XCTAssertTrue([AesKdfEngine transform:ret.mutableBytes key:key rounds:rounds]);
+    return ret;
+}
+
+- (void)testKnownAnswer {
+    uint8_t keyBytes[32];
+    uint8_t dataBytes[32];
+    for ( int i = 0; i < 32; i++ ) {
+        keyBytes[i] = (uint8_t)i;
+        dataBytes[i] = (uint8_t)(0xFF - i);
+    }
+
+    NSData* key = [NSData dataWithBytes:keyBytes length:sizeof(keyBytes)];
+    NSData* data = [NSData dataWithBytes:dataBytes length:sizeof(dataBytes)];
+
+    NSData* once = [self engineTransform:data key:key rounds:1];
+    XCTAssertEqualObjects(once, [self commonCryptoTransform:data key:key rounds:1]);
+
+    uint8_t fips197[16] = { 0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67, 0x45, 0xbf, 0xea, 0xfc, 0x49, 0x90, 0x4b, 0x49, 0x60, 0x89 };
+    uint8_t plain[32] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff };
+    memcpy(plain + 16, plain, 16);
+
+    NSData* fips = [self engineTransform:[NSData dataWithBytes:plain length:sizeof(plain)] key:key rounds:1];
+    XCTAssertEqual(memcmp(fips.bytes, fips197, 16), 0);
+    XCTAssertEqual(memcmp((const uint8_t*)fips.bytes + 16, fips197, 16), 0);
+}
+
+- (void)testMatchesCommonCryptoOnBothLanes {
+    for ( NSNumber* rounds in @[@0, @1, @2, @3, @1000, @60000] ) {
+        for ( NSUInteger trial = 0; trial < 4; trial++ ) {
+            NSMutableData* key = [NSMutableData dataWithLength:kCCKeySizeAES256];
+            NSMutableData* data = [NSMutableData dataWithLength:32];
+            arc4random_buf(key.mutableBytes, key.length);
+            arc4random_buf(data.mutableBytes, data.length);
+
+            NSData* expected = [self commonCryptoTransform:data key:key rounds:rounds.unsignedLongLongValue];
+            NSData* actual = [self engineTransform:data key:key rounds:rounds.unsignedLongLongValue];
+
+            XCTAssertEqualObjects([actual subdataWithRange:NSMakeRange(0, 16)], [expected subdataWithRange:NSMakeRange(0, 16)], @"first lane, %@ rounds", rounds);
+            XCTAssertEqualObjects([actual subdataWithRange:NSMakeRange(16, 16)], [expected subdataWithRange:NSMakeRange(16, 16)], @"second lane, %@ rounds", rounds);
+        }
+    }
+}
+
+@end
@@ -46,6 +46,97 @@
     [self test:@"/Users/strongbox/strongbox-test-files/Database.kdbx"];
 }
 
+- (void)testSegmentBackedAttachments {
+    DatabaseAttachmentSegment* segment = [[DatabaseAttachmentSegment alloc] init];
+    XCTAssertNotNil(segment);
+    
+    NSMutableArray<NSData*>* datas = NSMutableArray.array;
+    NSMutableData* combined = NSMutableData.data;
+    for ( NSNumber* length in @[@0, @1, @15, @16, @17, @(100 * 1024 + 3)] ) {
+        NSMutableData* data = [NSMutableData dataWithLength:length.unsignedIntegerValue];
+        arc4random_buf(data.mutableBytes, data.length);
+        [datas addObject:data];
+        [combined appendData:data];
+    }
+    
+    NSInputStream* stream = [NSInputStream inputStreamWithData:combined];
+    [stream open];
+    
+    NSMutableArray<DatabaseAttachment*>* attachments = NSMutableArray.array;
+    for ( NSData* data in datas ) {
+        DatabaseAttachment* attachment = [[DatabaseAttachment alloc] initWithStream:stream length:data.length protectedInMemory:YES segment:segment];
+        XCTAssertNotNil(attachment);
+        [attachments addObject:attachment];
+    }
+    [stream close];
+    [segment finishWriting];
+    
+    for ( NSUInteger i = 0; i < datas.count; i++ ) {
+        DatabaseAttachment* attachment = attachments[i];
+        DatabaseAttachment* eager = [[DatabaseAttachment alloc] initNonPerformantWithData:datas[i] compressed:YES protectedInMemory:YES];
+        
+        XCTAssertEqual(attachment.length, datas[i].length);
+        XCTAssertTrue([attachment.nonPerformantFullData isEqualToData:datas[i]]);
+        XCTAssertTrue([attachment.digestHash isEqualToString:eager.digestHash]);
+        XCTAssertTrue([attachment isEqual:eager]);
+    }
+}
+
+- (NSData*)readAll:(NSInputStream*)stream {
+    NSMutableData* ret = NSMutableData.data;
+    uint8_t block[4096];
+    
+    [stream open];
+    
+    NSInteger read;
+    while ( (read = [stream read:block maxLength:sizeof(block)]) > 0 ) {
+        [ret appendBytes:block length:read];
+    }
+    
+    XCTAssertEqual(read, 0, @"%@", stream.streamError);
+    [stream close];
+    
+    return ret;
+}
+
+- (void)testSegmentAppendAfterFailedAppend {
+    DatabaseAttachmentSegment* segment = [[DatabaseAttachmentSegment alloc] init];
+    XCTAssertNotNil(segment);
+    
+    NSMutableData* first = [NSMutableData dataWithLength:1000];
+    NSMutableData* truncated = [NSMutableData dataWithLength:70 * 1024 + 5];
+    NSMutableData* second = [NSMutableData dataWithLength:40 * 1024 + 9];
+    arc4random_buf(first.mutableBytes, first.length);
+    arc4random_buf(truncated.mutableBytes, truncated.length);
+    arc4random_buf(second.mutableBytes, second.length);
+    
+    uint64_t firstOffset, firstLength, failedOffset = 0, failedLength = 0, secondOffset, secondLength;
+    NSData *firstIv, *failedIv, *secondIv;
+    
+    NSInputStream* stream = [NSInputStream inputStreamWithData:first];
+    [stream open];
+    XCTAssertTrue([segment appendFromStream:stream length:first.length offset:&firstOffset encryptedLength:&firstLength iv:&firstIv]);
+    [stream close];
+    
+    stream = [NSInputStream inputStreamWithData:truncated];
+    [stream open];
+    XCTAssertFalse([segment appendFromStream:stream length:truncated.length + 1024 offset:&failedOffset encryptedLength:&failedLength iv:&failedIv]);
+    [stream close];
+    
+    stream = [NSInputStream inputStreamWithData:second];
+    [stream open];
+    XCTAssertTrue([segment appendFromStream:stream length:second.length offset:&secondOffset encryptedLength:&secondLength iv:&secondIv]);
+    [stream close];
+    
+    [segment finishWriting];
+    
+    XCTAssertEqual(firstOffset, 0);
+    XCTAssertGreaterThan(secondOffset, firstOffset + firstLength);
+    
+    XCTAssertEqualObjects([self readAll:[segment plainTextInputStreamAtOffset:firstOffset encryptedLength:firstLength iv:firstIv]], first);
+    XCTAssertEqualObjects([self readAll:[segment plainTextInputStreamAtOffset:secondOffset encryptedLength:secondLength iv:secondIv]], second);
+}
+
 - (void)test:(NSString*)filename {
     NSLog(@"Checking File [%@]", filename);
     
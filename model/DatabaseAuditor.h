@@ -56,6 +56,13 @@ typedef BOOL (^IsExcludedBlock)(Node* item);
      progress:(AuditProgressBlock)progress
    completion:(AuditCompletionBlock)completion;
 
+- (BOOL)start:(DatabaseModel*)database
+       config:(DatabaseAuditorConfiguration*)config
+     previous:(DatabaseAuditor*_Nullable)previous
+ nodesChanged:(AuditNodesChangedBlock)nodesChanged
+     progress:(AuditProgressBlock)progress
+   completion:(AuditCompletionBlock)completion;
+
 - (void)stop;
 
 
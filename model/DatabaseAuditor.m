@@ -9,19 +9,19 @@
 #import "DatabaseAuditor.h"
 #import "NSArray+Extensions.h"
 #import "PasswordMaker.h"
-#import "NSString+Levenshtein.h"
+#import "PasswordSimilarityEngine.h"
 #import "NSData+Extensions.h"
 #import "NSString+Extensions.h"
 #import "ConcurrentMutableSet.h"
-#import "UrlRequestOperation.h"
+#import "HibpRangeCache.h"
 #import "SecretStore.h"
 #import "Utils.h"
 #import "PasswordStrengthTester.h"
 #import "NSString+Extensions.h"
 #import "Strongbox-Swift.h"
 
-static const int kHttpStatusOk = 200;
 static NSString* const kSecretStoreHibpPwnedSetCacheKey = @"SecretStoreHibpPwnedSetCacheKey";
+static const NSUInteger kSimilarityRowBatchSize = 64;
 
 @interface DatabaseAuditor ()
 
@@ -47,7 +47,6 @@ static NSString* const kSecretStoreHibpPwnedSetCacheKey = @"SecretStoreHibpPwned
 @property NSSet<NSUUID*>* duplicatedPasswordsNodeSet; 
 @property NSSet<NSUUID*>* similarPasswordsNodeSet; 
 @property ConcurrentMutableSet<NSUUID*>* mutablePwnedNodes;
-@property NSOperationQueue *hibpQueue;
 
 @property NSUInteger hibpErrorCount;
 @property NSUInteger hibpCompletedCount;
@@ -65,6 +64,11 @@ static NSString* const kSecretStoreHibpPwnedSetCacheKey = @"SecretStoreHibpPwned
 
 @property PasswordStrengthConfig* strengthConfig;
 
+@property (nullable) DatabaseAuditor* previous;
+@property NSDictionary<NSUUID*, NSData*>* fingerprints;
+@property (nullable) NSSet<NSUUID*>* unchangedIds;
+@property NSArray<Node*>* changedNodes;
+
 @end
 
 @implementation DatabaseAuditor
@@ -102,8 +106,6 @@ const static NSSet<NSString*>* kTwoFactorDomains;
         self.similarPasswordsNodeSet = NSSet.set;
         self.isPro = pro;
      
-        self.hibpQueue = [NSOperationQueue new];
-        self.hibpQueue.maxConcurrentOperationCount = 4;
         self.mutablePwnedNodes = ConcurrentMutableSet.mutableSet;
         
         self.isExcluded = (isExcluded != nil) ? isExcluded : ^BOOL(Node * _Nonnull item) {
@@ -133,6 +135,15 @@ const static NSSet<NSString*>* kTwoFactorDomains;
 
 - (BOOL)start:(DatabaseModel*)database
        config:(DatabaseAuditorConfiguration *)config
+ nodesChanged:(AuditNodesChangedBlock)nodesChanged
+     progress:(AuditProgressBlock)progress
+   completion:(AuditCompletionBlock)completion {
+    return [self start:database config:config previous:nil nodesChanged:nodesChanged progress:progress completion:completion];
+}
+
+- (BOOL)start:(DatabaseModel*)database
+       config:(DatabaseAuditorConfiguration *)config
+     previous:(DatabaseAuditor *)previous
  nodesChanged:(AuditNodesChangedBlock)nodesChanged
      progress:(AuditProgressBlock)progress
    completion:(AuditCompletionBlock)completion {
@@ -148,6 +159,7 @@ const static NSSet<NSString*>* kTwoFactorDomains;
     self.config = config;
 
     self.database = database;
+    self.previous = [self canReuseResultsOf:previous] ? previous : nil;
 
     self.auditableNonEmptyPasswordNodes = [self.database.allSearchableEntries filter:^BOOL(Node * _Nonnull obj) {
         return obj.fields.password.length && ![self.database isDereferenceableText:obj.fields.password] && !self.isExcluded(obj);
@@ -165,8 +177,12 @@ const static NSSet<NSString*>* kTwoFactorDomains;
     
     self.progress(0.0);
 
+    [self prepareIncrementalAudit];
+    
     [self performAudits];
     
+    self.previous = nil;
+    
     self.progress(1.0);
 
     if (self.state == kAuditStateRunning) { 
@@ -179,7 +195,6 @@ const static NSSet<NSString*>* kTwoFactorDomains;
 - (void)stop {
     NSLog(@"AUDIT: Stopping Audit...");
     self.stopRequested = YES;
-    [self.hibpQueue cancelAllOperations];
 }
 
 - (DatabaseAuditReport *)getAuditReport {
@@ -502,70 +517,168 @@ const static NSSet<NSString*>* kTwoFactorDomains;
 
 
 
-- (void)performAudits {
-    
+- (BOOL)canReuseResultsOf:(DatabaseAuditor*)previous {
+    if ( previous == nil || previous.state != kAuditStateDone || previous.fingerprints == nil || previous.isPro != self.isPro ) {
+        return NO;
+    }
     
-    self.noPasswords = [self checkForNoPasswords];
+    DatabaseAuditorConfiguration* a = previous.config;
+    DatabaseAuditorConfiguration* b = self.config;
+    
+    BOOL sameConfig = a.checkForNoPasswords == b.checkForNoPasswords &&
+        a.checkForTwoFactorAvailable == b.checkForTwoFactorAvailable &&
+        a.checkForDuplicatedPasswords == b.checkForDuplicatedPasswords &&
+        a.caseInsensitiveMatchForDuplicates == b.caseInsensitiveMatchForDuplicates &&
+        a.checkForCommonPasswords == b.checkForCommonPasswords &&
+        a.checkForLowEntropy == b.checkForLowEntropy &&
+        a.lowEntropyThreshold == b.lowEntropyThreshold &&
+        a.checkForSimilarPasswords == b.checkForSimilarPasswords &&
+        a.levenshteinSimilarityThreshold == b.levenshteinSimilarityThreshold &&
+        a.checkForMinimumLength == b.checkForMinimumLength &&
+        a.minimumLength == b.minimumLength &&
+        a.checkHibp == b.checkHibp &&
+        a.hibpOfflineMode == b.hibpOfflineMode;
+    
+    BOOL sameStrength = (previous.strengthConfig == nil && self.strengthConfig == nil) ||
+        (previous.strengthConfig != nil && self.strengthConfig != nil &&
+         previous.strengthConfig.algorithm == self.strengthConfig.algorithm &&
+         previous.strengthConfig.adversaryGuessesPerSecond == self.strengthConfig.adversaryGuessesPerSecond);
+    
+    return sameConfig && sameStrength;
+}
 
+- (NSData*)fingerprintForNode:(Node*)node {
+    NSString* key = [NSString stringWithFormat:@"%@\n%@\n%d", node.fields.password, node.fields.url, node.fields.otpToken != nil];
     
+    return key.sha256Data;
+}
 
-    self.duplicatedPasswords = [self checkForDuplicatedPasswords];
-    self.duplicatedPasswordsNodeSet = [NSSet setWithArray:[self.duplicatedPasswords.allValues flatMap:^NSArray * _Nonnull(NSSet<Node *> * _Nonnull obj, NSUInteger idx) {
-        return obj.allObjects;
-    }]];
-
+- (void)prepareIncrementalAudit {
+    NSCountedSet<NSUUID*>* ids = NSCountedSet.set;
+    for (Node* node in self.auditableNonEmptyPasswordNodes) {
+        [ids addObject:node.uuid];
+    }
     
-
-    self.commonPasswords = [self checkForCommonPasswords];
-
+    NSMutableDictionary<NSUUID*, NSData*>* fingerprints = NSMutableDictionary.dictionary;
+    for (Node* node in self.auditableNonEmptyPasswordNodes) {
+        fingerprints[node.uuid] = [ids countForObject:node.uuid] == 1 ? [self fingerprintForNode:node] : NSData.data;
+    }
     
-
-    self.lowEntropy = [self checkForLowEntropy];
-
+    self.fingerprints = fingerprints.copy;
     
+    if (self.previous == nil) {
+        self.unchangedIds = nil;
+        self.changedNodes = self.auditableNonEmptyPasswordNodes;
+        return;
+    }
     
-    self.tooShort = [self checkForTooShort];
+    NSMutableSet<NSUUID*>* unchanged = NSMutableSet.set;
+    NSMutableArray<Node*>* changed = NSMutableArray.array;
     
+    for (Node* node in self.auditableNonEmptyPasswordNodes) {
+        NSData* before = self.previous.fingerprints[node.uuid];
+        NSData* now = fingerprints[node.uuid];
+        
+        if (before.length && [before isEqualToData:now]) {
+            [unchanged addObject:node.uuid];
+        }
+        else {
+            [changed addObject:node];
+        }
+    }
     
+    self.unchangedIds = unchanged.copy;
+    self.changedNodes = changed.copy;
     
-    if (self.tooShort.anyObject || self.noPasswords.anyObject || self.duplicatedPasswordsNodeSet.anyObject || self.commonPasswords.anyObject) {
-         self.nodesChanged();
-    }
+    NSLog(@"AUDIT: Incremental Audit - %lu changed, %lu unchanged", (unsigned long)changed.count, (unsigned long)unchanged.count);
+}
 
-    
-        
-    if (self.isPro) {
-        [self checkHibp]; 
+- (NSSet<NSUUID*>*)reusePrevious:(NSSet<NSUUID*>*)previous check:(NSSet<NSUUID*>* (^)(NSArray<Node*>* nodes))check {
+    if (self.unchangedIds == nil) {
+        return check(self.auditableNonEmptyPasswordNodes);
     }
+    
+    NSMutableSet<NSUUID*>* ret = previous.mutableCopy;
+    
+    [ret intersectSet:self.unchangedIds];
+    [ret unionSet:check(self.changedNodes)];
+    
+    return ret.copy;
+}
 
+- (void)performAudits {
+    dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0L);
+    dispatch_group_t group = dispatch_group_create();
     
+    dispatch_group_async(group, queue, ^{
+        self.noPasswords = [self checkForNoPasswords];
+    });
 
-    if (self.isPro) {
-        self.similar = [self checkForSimilarPasswords];
-        self.similarPasswordsNodeSet = [NSSet setWithArray:[self.similar.allValues flatMap:^NSArray * _Nonnull(NSSet<Node *> * _Nonnull obj, NSUInteger idx) {
+    dispatch_group_async(group, queue, ^{
+        NSDictionary<NSString*, NSSet<NSUUID*>*>* duplicatedPasswords = [self checkForDuplicatedPasswords];
+        
+        self.duplicatedPasswords = duplicatedPasswords;
+        self.duplicatedPasswordsNodeSet = [NSSet setWithArray:[duplicatedPasswords.allValues flatMap:^NSArray * _Nonnull(NSSet<Node *> * _Nonnull obj, NSUInteger idx) {
             return obj.allObjects;
         }]];
+    });
 
-        if (self.similarPasswordsNodeSet.anyObject) {
-             self.nodesChanged();
-        }
-    }
+    dispatch_group_async(group, queue, ^{
+        self.commonPasswords = [self reusePrevious:self.previous.commonPasswords check:^NSSet<NSUUID *> *(NSArray<Node *> *nodes) {
+            return [self checkForCommonPasswords:nodes];
+        }];
+    });
 
+    dispatch_group_async(group, queue, ^{
+        self.lowEntropy = [self reusePrevious:self.previous.lowEntropy check:^NSSet<NSUUID *> *(NSArray<Node *> *nodes) {
+            return [self checkForLowEntropy:nodes];
+        }];
+    });
+
+    dispatch_group_async(group, queue, ^{
+        self.tooShort = [self checkForTooShort];
+    });
+
+    dispatch_group_async(group, queue, ^{
+        self.twoFactorAvailable = [self reusePrevious:self.previous.twoFactorAvailable check:^NSSet<NSUUID *> *(NSArray<Node *> *nodes) {
+            return [self checkForTwoFactorAvailable:nodes];
+        }];
+    });
+
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
     
-    
-    self.twoFactorAvailable = [self checkForTwoFactorAvailable];
+    if (self.tooShort.anyObject || self.noPasswords.anyObject || self.duplicatedPasswordsNodeSet.anyObject || self.commonPasswords.anyObject) {
+         self.nodesChanged();
+    }
+
+    if (!self.isPro) {
+        return;
+    }
     
     
+        
+    dispatch_group_async(group, queue, ^{
+        [self checkHibp]; 
+    });
 
+    self.similar = [self checkForSimilarPasswords];
+    self.similarPasswordsNodeSet = [NSSet setWithArray:[self.similar.allValues flatMap:^NSArray * _Nonnull(NSSet<Node *> * _Nonnull obj, NSUInteger idx) {
+        return obj.allObjects;
+    }]];
+
+    if (self.similarPasswordsNodeSet.anyObject) {
+         self.nodesChanged();
+    }
     
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
 }
 
-- (NSSet<NSUUID*>*)checkForTwoFactorAvailable {
+- (NSSet<NSUUID*>*)checkForTwoFactorAvailable:(NSArray<Node*>*)nodes {
     if ( !self.config.checkForTwoFactorAvailable ) {
         return NSSet.set;
     }
 
-    NSArray<Node*>* results = [self.auditableNonEmptyPasswordNodes filter:^BOOL(Node * _Nonnull obj) {
+    NSArray<Node*>* results = [nodes filter:^BOOL(Node * _Nonnull obj) {
         if ( obj.fields.otpToken ) {
             return NO;
         }
@@ -650,12 +763,12 @@ const static NSSet<NSString*>* kTwoFactorDomains;
     return dupes.copy;
 }
 
-- (NSSet<NSUUID*>*)checkForCommonPasswords {
+- (NSSet<NSUUID*>*)checkForCommonPasswords:(NSArray<Node*>*)nodes {
     if (!self.config.checkForCommonPasswords) {
          return NSSet.set;
     }
 
-    NSArray<Node*>* common = [self.auditableNonEmptyPasswordNodes filter:^BOOL(Node * _Nonnull obj) {
+    NSArray<Node*>* common = [nodes filter:^BOOL(Node * _Nonnull obj) {
         return [PasswordMaker.sharedInstance isCommonPassword:obj.fields.password];
     }];
     
@@ -664,21 +777,21 @@ const static NSSet<NSString*>* kTwoFactorDomains;
     }].set;
 }
 
-- (NSSet<NSUUID*>*)checkForLowEntropy {
+- (NSSet<NSUUID*>*)checkForLowEntropy:(NSArray<Node*>*)nodes {
     if ( !self.config.checkForLowEntropy ) {
          return NSSet.set;
     }
 
     NSTimeInterval startTime = NSDate.timeIntervalSinceReferenceDate;
         
-    NSArray<Node*>* lowEntropy = [self.auditableNonEmptyPasswordNodes filter:^BOOL(Node * _Nonnull obj) {
+    NSArray<Node*>* lowEntropy = [nodes filter:^BOOL(Node * _Nonnull obj) {
         PasswordStrength* strength = [PasswordStrengthTester getStrength:obj.fields.password config:self.strengthConfig];
         BOOL low = strength.entropy < ((double)self.config.lowEntropyThreshold);
         return low;
     }];
     
     NSLog(@"====================================== PERF ======================================");
-    NSLog(@"LOW ENTROPY CHECK took [%f] seconds for %lu items", NSDate.timeIntervalSinceReferenceDate - startTime, (unsigned long)self.auditableNonEmptyPasswordNodes.count);
+    NSLog(@"LOW ENTROPY CHECK took [%f] seconds for %lu items", NSDate.timeIntervalSinceReferenceDate - startTime, (unsigned long)nodes.count);
     NSLog(@"====================================== PERF ======================================");
 
     return [lowEntropy map:^id _Nonnull(Node * _Nonnull obj, NSUInteger idx) {
@@ -691,55 +804,164 @@ const static NSSet<NSString*>* kTwoFactorDomains;
         return NSDictionary.dictionary;
     }
     
-    NSMutableArray<Node*>* uncheckedOthers = self.auditableNonEmptyPasswordNodes.mutableCopy; 
+    NSArray<Node*>* nodes = self.auditableNonEmptyPasswordNodes;
+    NSArray<NSString*>* passwords = [nodes map:^id _Nonnull(Node * _Nonnull obj, NSUInteger idx) {
+        return obj.fields.password;
+    }];
+    
+    NSTimeInterval startTime = NSDate.timeIntervalSinceReferenceDate;
+
+    PasswordSimilarityEngine* engine = [[PasswordSimilarityEngine alloc] initWithStrings:passwords threshold:self.config.levenshteinSimilarityThreshold];
 
+    if (self.unchangedIds && self.changedNodes.count * 2 <= nodes.count) {
+        NSDictionary* ret = [self checkForSimilarPasswordsIncrementally:engine nodes:nodes passwords:passwords];
+        
+        NSLog(@"====================================== PERF ======================================");
+        NSLog(@"INCREMENTAL SIMILARITY CHECK took [%f] seconds for %lu changed items", NSDate.timeIntervalSinceReferenceDate - startTime, (unsigned long)self.changedNodes.count);
+        NSLog(@"====================================== PERF ======================================");
+        
+        return ret;
+    }
+    
     NSMutableDictionary<NSUUID*, NSMutableSet<NSUUID*>*>* similarGroups = NSMutableDictionary.dictionary;
     
-    int i=0;
-    int n = (int)self.auditableNonEmptyPasswordNodes.count - 1;
-    int totalComparisons = (n * (n + 1)) / 2; 
+    NSUInteger count = nodes.count;
+    NSUInteger totalComparisons = count > 1 ? (count * (count - 1)) / 2 : 0;
+    NSUInteger batches = (count + kSimilarityRowBatchSize - 1) / kSimilarityRowBatchSize;
+    __block NSUInteger completedComparisons = 0;
     
-    NSLog(@"AUDIT: Similarity Comparisons required = %d", totalComparisons);
-    for (Node* entry in self.auditableNonEmptyPasswordNodes) {
-        NSString* password = entry.fields.password;
-
-        [uncheckedOthers removeObject:entry];
-
-        for (Node* other in uncheckedOthers) {
-            if (i % 1000 == 0) {
-                
-                self.similarProgress = (CGFloat)i/(CGFloat)totalComparisons;
-                [self publishPartialProgress];
-            }
-            i++;
+    NSLog(@"AUDIT: Similarity Comparisons required = %lu", (unsigned long)totalComparisons);
+    
+    self.similarProgress = 0.0f;
+    [self publishPartialProgress];
 
-            if (self.stopRequested) {
-                self.state = kAuditStateStoppedIncomplete;
-                return similarGroups.copy;
+    dispatch_apply(batches, DISPATCH_APPLY_AUTO, ^(size_t batch) {
+        if (self.stopRequested) {
+            return;
+        }
+        
+        NSUInteger index = batch * kSimilarityRowBatchSize;
+        NSRange rows = NSMakeRange(index, MIN(kSimilarityRowBatchSize, count - index));
+        NSMutableDictionary<NSUUID*, NSMutableSet<NSUUID*>*>* batchGroups = NSMutableDictionary.dictionary;
+        
+        [engine enumerateSimilarPairsInRange:rows usingBlock:^(NSUInteger entryIndex, NSUInteger otherIndex) {
+            if ([passwords[entryIndex] compare:passwords[otherIndex]] == NSOrderedSame) {
+                return; 
             }
             
+            NSUUID* uuid = nodes[entryIndex].uuid;
+            if(!batchGroups[uuid]) {
+                batchGroups[uuid] = [NSMutableSet setWithObject:uuid];
+            }
             
+            [batchGroups[uuid] addObject:nodes[otherIndex].uuid];
+        }];
+        
+        NSUInteger comparisons = 0;
+        for (NSUInteger row = rows.location; row < NSMaxRange(rows); row++) {
+            comparisons += count - row - 1;
+        }
 
-            NSString* otherPassword = other.fields.password;
-            
-            if ([password compare:otherPassword] == NSOrderedSame) {
-                continue; 
+        @synchronized (similarGroups) {
+            for (NSUUID* uuid in batchGroups) {
+                if (similarGroups[uuid]) {
+                    [similarGroups[uuid] unionSet:batchGroups[uuid]];
+                }
+                else {
+                    similarGroups[uuid] = batchGroups[uuid];
+                }
             }
             
-            double similarity = [password levenshteinSimilarityRatio:otherPassword];
+            completedComparisons += comparisons;
+            self.similarProgress = totalComparisons ? (CGFloat)completedComparisons/(CGFloat)totalComparisons : 1.0f;
+            [self publishPartialProgress];
+        }
+    });
+    
+    if (self.stopRequested) {
+        self.state = kAuditStateStoppedIncomplete;
+        return similarGroups.copy;
+    }
+    
+    NSLog(@"====================================== PERF ======================================");
+    NSLog(@"SIMILARITY CHECK took [%f] seconds for %lu items", NSDate.timeIntervalSinceReferenceDate - startTime, (unsigned long)count);
+    NSLog(@"====================================== PERF ======================================");
 
-            if (similarity >= self.config.levenshteinSimilarityThreshold) {
-                
+    return similarGroups.copy;
+}
 
-                if(!similarGroups[entry.uuid]) {
-                    similarGroups[entry.uuid] = [NSMutableSet setWithObject:entry.uuid];
-                }
-                
-                [similarGroups[entry.uuid] addObject:other.uuid];
+- (NSDictionary<NSUUID*, NSSet<NSUUID*>*>*)checkForSimilarPasswordsIncrementally:(PasswordSimilarityEngine*)engine
+                                                                          nodes:(NSArray<Node*>*)nodes
+                                                                      passwords:(NSArray<NSString*>*)passwords {
+    NSUInteger count = nodes.count;
+    
+    NSMutableDictionary<NSUUID*, NSNumber*>* unchangedIndexes = NSMutableDictionary.dictionary;
+    NSMutableArray<NSNumber*>* changedIndexes = NSMutableArray.array;
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        NSUUID* uuid = nodes[i].uuid;
+        
+        if ([self.unchangedIds containsObject:uuid]) {
+            unchangedIndexes[uuid] = @(i);
+        }
+        else {
+            [changedIndexes addObject:@(i)];
+        }
+    }
+    
+    
+    
+    NSMutableSet<NSNumber*>* pairs = NSMutableSet.set;
+    
+    [self.previous.similar enumerateKeysAndObjectsUsingBlock:^(NSUUID * _Nonnull key, NSSet<NSUUID *> * _Nonnull members, BOOL * _Nonnull stop) {
+        NSNumber* a = unchangedIndexes[key];
+        if (a == nil) {
+            return;
+        }
+        
+        for (NSUUID* member in members) {
+            NSNumber* b = unchangedIndexes[member];
+            
+            if (b != nil && ![member isEqual:key]) {
+                [pairs addObject:@(MIN(a.unsignedIntegerValue, b.unsignedIntegerValue) * count + MAX(a.unsignedIntegerValue, b.unsignedIntegerValue))];
+            }
+        }
+    }];
+    
+    
+    
+    for (NSNumber* changed in changedIndexes) {
+        if (self.stopRequested) {
+            self.state = kAuditStateStoppedIncomplete;
+            break;
+        }
+        
+        NSUInteger index = changed.unsignedIntegerValue;
+        
+        [engine enumerateSimilarTo:index usingBlock:^(NSUInteger other) {
+            if ([passwords[index] compare:passwords[other]] == NSOrderedSame) {
+                return; 
             }
+            
+            [pairs addObject:@(MIN(index, other) * count + MAX(index, other))];
+        }];
+    }
+    
+    NSMutableDictionary<NSUUID*, NSMutableSet<NSUUID*>*>* similarGroups = NSMutableDictionary.dictionary;
+    
+    for (NSNumber* pair in pairs) {
+        NSUUID* uuid = nodes[pair.unsignedIntegerValue / count].uuid;
+        
+        if(!similarGroups[uuid]) {
+            similarGroups[uuid] = [NSMutableSet setWithObject:uuid];
         }
+        
+        [similarGroups[uuid] addObject:nodes[pair.unsignedIntegerValue % count].uuid];
     }
     
+    self.similarProgress = 1.0f;
+    [self publishPartialProgress];
+    
     return similarGroups.copy;
 }
 
@@ -750,15 +972,7 @@ const static NSSet<NSString*>* kTwoFactorDomains;
         return;
     }
     
-    NSDictionary<NSString*, NSArray<Node*>*> *nodesByPasswords = [self.auditableNonEmptyPasswordNodes groupBy:^id _Nonnull(Node * _Nonnull obj) {
-        return obj.fields.password;
-    }];
-    
-    self.hibpQueue.suspended = YES;
-    self.hibpTotalCount = nodesByPasswords.allKeys.count;
-    self.hibpCompletedCount = 0;
-
-    BOOL checkForNewBreaches = self.config.checkHibp;
+    BOOL checkForNewBreaches = self.config.checkHibp && !self.config.hibpOfflineMode;
 
     NSDate *lastChecked = self.config.lastHibpOnlineCheck;
 
@@ -781,203 +995,133 @@ const static NSSet<NSString*>* kTwoFactorDomains;
 
     }
     
+    NSArray<Node*>* hibpNodes = self.auditableNonEmptyPasswordNodes;
+    
+    if (self.unchangedIds && !checkForNewBreaches) {
+        NSMutableSet<NSUUID*>* carried = self.previous.mutablePwnedNodes.snapshot.mutableCopy;
+        [carried intersectSet:self.unchangedIds];
+        [self.mutablePwnedNodes addObjectsFromArray:carried.allObjects];
+        
+        hibpNodes = self.changedNodes;
+    }
+    
+    NSDictionary<NSString*, NSArray<Node*>*> *nodesByPasswords = [hibpNodes groupBy:^id _Nonnull(Node * _Nonnull obj) {
+        return obj.fields.password;
+    }];
+    
+    self.hibpTotalCount = nodesByPasswords.allKeys.count;
+    self.hibpCompletedCount = 0;
+    
     NSSet<NSString*>* pwnedCache = [SecretStore.sharedInstance getSecureObject:kSecretStoreHibpPwnedSetCacheKey];
+    NSMutableDictionary<NSString*, NSArray<Node*>*>* pending = NSMutableDictionary.dictionary;
     
     for (NSString* password in nodesByPasswords.allKeys) {
         NSString* sha1HexPassword = password.sha1Data.hexString;
         NSArray<Node*>* affectedNodes = nodesByPasswords[password];
         
         if ([pwnedCache containsObject:sha1HexPassword]) {
-
             self.hibpCompletedCount++;
-            NSArray<NSUUID*> *ids = [affectedNodes map:^id _Nonnull(Node * _Nonnull obj, NSUInteger idx) {
-                return obj.uuid;
-            }];
-            
-            [self.mutablePwnedNodes addObjectsFromArray:ids];
+            [self addPwnedNodes:affectedNodes];
         }
-        else if (checkForNewBreaches) {
-            UrlRequestOperation* op = [self haveIBeenPwned:password sha1HexPassword:sha1HexPassword nodes:affectedNodes];
-            [self.hibpQueue addOperation:op];
+        else {
+            pending[sha1HexPassword] = affectedNodes;
         }
     }
-        
     
-
     if (self.hibpCompletedCount) {
         self.hibpProgress = ((CGFloat)self.hibpCompletedCount / self.hibpTotalCount);
         [self publishPartialProgress];
         self.nodesChanged();
     }
     
+    HibpRangeCache* rangeCache = HibpRangeCache.sharedInstance;
     
+    if (checkForNewBreaches && pending.count) {
+        NSMutableSet<NSString*>* prefixes = NSMutableSet.set;
+        for (NSString* sha1HexPassword in pending.allKeys) {
+            [prefixes addObject:[HibpRangeCache prefixForSha1Hex:sha1HexPassword]];
+        }
+        
+        NSUInteger alreadyCompleted = self.hibpCompletedCount;
+        NSUInteger pendingCount = pending.count;
+        
+        rangeCache.maxConcurrentRequests = self.config.hibpMaxConcurrentRequests;
+        
+        self.hibpErrorCount = [rangeCache prefetchPrefixes:prefixes
+                                                    maxAge:self.config.hibpCheckForNewBreachesIntervalSeconds
+                                                  progress:^(NSUInteger completed, NSUInteger total) {
+            if (completed % 10 == 0 || completed == total) {
+                self.hibpProgress = (alreadyCompleted + ((CGFloat)pendingCount * completed / total)) / self.hibpTotalCount;
+                [self publishPartialProgress];
+            }
+        } cancelled:^BOOL{
+            return self.stopRequested;
+        }];
+    }
     
-    self.hibpQueue.suspended = NO;
-    [self.hibpQueue waitUntilAllOperationsAreFinished];
-
     if (self.stopRequested) {
         self.state = kAuditStateStoppedIncomplete;
+        return;
     }
     
-
-}
-
-- (void)oneTimeHibpCheck:(NSString*)password completion:(void(^)(BOOL pwned, NSError* error))completion {
-    NSString* sha1HexPassword = password.sha1Data.hexString;
-    NSSet<NSString*>* pwnedCache = [SecretStore.sharedInstance getSecureObject:kSecretStoreHibpPwnedSetCacheKey];
+    NSMutableArray<NSString*>* hits = NSMutableArray.array;
     
-    if ([pwnedCache containsObject:sha1HexPassword]) {
-
-        completion(YES, nil);
-    }
-    else  {
-          NSMutableURLRequest *request = [self getHibpUrlRequest:sha1HexPassword];
-
-          UrlRequestOperation* op = [[UrlRequestOperation alloc] initWithRequest:request.copy
-                                                       dataTaskCompletionHandler:^(NSData * _Nullable data, NSURLResponse * _Nullable response, NSError * _Nullable error) {
-              if (error) {
-                  NSLog(@"ERROR: [%@]", error);
-                  completion(NO, error);
-                  return;
-              }
-              
-              NSHTTPURLResponse* httpResponse = (NSHTTPURLResponse*)response;
-              
-              if (httpResponse.statusCode == kHttpStatusOk) {
-                  BOOL found = [self processHibpResponse:data targetHash:sha1HexPassword];
-                   
-                  if (found) {
-                      NSSet<NSString*> *pwnedCache = [SecretStore.sharedInstance getSecureObject:kSecretStoreHibpPwnedSetCacheKey];
-                      NSLog(@"Caching HIBP hit...");
-                      NSMutableSet<NSString*>* mut = pwnedCache ? pwnedCache.mutableCopy : NSMutableSet.set;
-                      [mut addObject:sha1HexPassword];
-                      [SecretStore.sharedInstance setSecureObject:mut.copy forIdentifier:kSecretStoreHibpPwnedSetCacheKey];
-                  }
-                  
-                  completion(found, nil);
-              }
-              else {
-                  NSLog(@"HTTP [%ld] - [%@]", (long)httpResponse.statusCode , error);
-                  completion(NO, [Utils createNSError:[NSString stringWithFormat:@"response = [%@]", httpResponse] errorCode:-2345]);
-              }
-        }];
-        
-        [self.hibpQueue addOperation:op];
-        self.hibpQueue.suspended = NO;
+    for (NSString* sha1HexPassword in pending.allKeys) {
+        if ([rangeCache isPwned:sha1HexPassword].boolValue) {
+            [hits addObject:sha1HexPassword];
+            [self addPwnedNodes:pending[sha1HexPassword]];
+        }
     }
-}
-
-- (NSMutableURLRequest*)getHibpUrlRequest:(NSString*)sha1HexPassword {
-    NSURL* url = [self buildHibpUrl:sha1HexPassword];
     
-    const NSTimeInterval kUrlRequestTimeout = 5.0f; 
-    
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:url cachePolicy:NSURLRequestUseProtocolCachePolicy timeoutInterval:kUrlRequestTimeout];
-    [request addValue:@"true" forHTTPHeaderField:@"Add-Padding"]; 
+    if (hits.count) {
+        NSLog(@"Caching %lu HIBP hits...", (unsigned long)hits.count);
+        [self cachePwnedHashes:hits];
+        self.nodesChanged();
+    }
     
-    return request;
+    self.hibpCompletedCount = self.hibpTotalCount;
+    self.hibpProgress = 1.0f;
+    [self publishPartialProgress];
 }
 
-- (UrlRequestOperation*)haveIBeenPwned:(NSString*)password sha1HexPassword:(NSString*)sha1HexPassword nodes:(NSArray<Node*>*)nodes {
-    NSMutableURLRequest *request = [self getHibpUrlRequest:sha1HexPassword];
-    
-    return [[UrlRequestOperation alloc] initWithRequest:request.copy dataTaskCompletionHandler:^(NSData * _Nullable data, NSURLResponse * _Nullable response, NSError * _Nullable error) {
-        [self handleUrlRequestCompletion:password sha1HexPassword:sha1HexPassword nodes:nodes data:data response:response error:error];
+- (void)addPwnedNodes:(NSArray<Node*>*)nodes {
+    NSArray<NSUUID*> *ids = [nodes map:^id _Nonnull(Node * _Nonnull obj, NSUInteger idx) {
+        return obj.uuid;
     }];
+    
+    [self.mutablePwnedNodes addObjectsFromArray:ids];
 }
 
-- (void)handleUrlRequestCompletion:(NSString*)password
-                   sha1HexPassword:(NSString*)sha1HexPassword
-                             nodes:(NSArray<Node*>*)nodes
-                              data:(NSData*)data
-                          response:(NSURLResponse*)response
-                             error:(NSError*)error {
-    self.hibpCompletedCount++;
-    
-    if (self.hibpCompletedCount % 10 == 0) { 
-        self.hibpProgress = ((CGFloat)self.hibpCompletedCount / self.hibpTotalCount);
-        [self publishPartialProgress];
+- (void)cachePwnedHashes:(NSArray<NSString*>*)sha1HexPasswords {
+    @synchronized (kSecretStoreHibpPwnedSetCacheKey) {
+        NSSet<NSString*> *pwnedCache = [SecretStore.sharedInstance getSecureObject:kSecretStoreHibpPwnedSetCacheKey];
+        NSMutableSet<NSString*>* mut = pwnedCache ? pwnedCache.mutableCopy : NSMutableSet.set;
+        
+        [mut addObjectsFromArray:sha1HexPasswords];
+        [SecretStore.sharedInstance setSecureObject:mut.copy forIdentifier:kSecretStoreHibpPwnedSetCacheKey];
     }
+}
+
+- (void)oneTimeHibpCheck:(NSString*)password completion:(void(^)(BOOL pwned, NSError* error))completion {
+    NSString* sha1HexPassword = password.sha1Data.hexString;
+    NSSet<NSString*>* pwnedCache = [SecretStore.sharedInstance getSecureObject:kSecretStoreHibpPwnedSetCacheKey];
     
-    if (error) {
-        self.hibpErrorCount++;
-        NSLog(@"ERROR: [%@]", error);
+    if ([pwnedCache containsObject:sha1HexPassword]) {
+        completion(YES, nil);
         return;
     }
     
-    NSHTTPURLResponse* httpResponse = (NSHTTPURLResponse*)response;
-    
-    if (httpResponse.statusCode == kHttpStatusOk) {
-        BOOL found = [self processHibpResponse:data targetHash:sha1HexPassword];
-         
-        if (found) {
-            NSSet<NSString*> *pwnedCache = [SecretStore.sharedInstance getSecureObject:kSecretStoreHibpPwnedSetCacheKey];
-
-            NSLog(@"Caching HIBP hit...");
-            NSMutableSet<NSString*>* mut = pwnedCache ? pwnedCache.mutableCopy : NSMutableSet.set;
-            
-            [mut addObject:sha1HexPassword];
-            [SecretStore.sharedInstance setSecureObject:mut.copy forIdentifier:kSecretStoreHibpPwnedSetCacheKey];
-            
-            NSArray<NSUUID*> *ids = [nodes map:^id _Nonnull(Node * _Nonnull obj, NSUInteger idx) {
-                return obj.uuid;
-            }];
-            
-            [self.mutablePwnedNodes addObjectsFromArray:ids];
-            self.nodesChanged();
+    [HibpRangeCache.sharedInstance lookup:sha1HexPassword offline:self.config.hibpOfflineMode completion:^(BOOL pwned, NSError * _Nullable error) {
+        if (error) {
+            NSLog(@"ERROR: [%@]", error);
         }
-    }
-    else {
-        NSLog(@"HTTP [%ld] - [%@]", (long)httpResponse.statusCode , error);
-        self.hibpErrorCount++;
-    }
-}
-
-- (NSURL*)buildHibpUrl:(NSString*)sha1HexPassword {
-    NSString* prefix = [sha1HexPassword substringToIndex:5];
-    
-    NSURLComponents* components = [[NSURLComponents alloc] init];
-    components.scheme = @"https";
-    components.host = @"api.pwnedpasswords.com";
-    components.path = [NSString stringWithFormat:@"/range/%@", prefix];
-
-    NSURL* url = components.URL;
-    
-    
-    
-    return url;
-}
-
-- (BOOL)processHibpResponse:(NSData*)data targetHash:(NSString*)targetHash {
-    NSString* suffix = [targetHash substringFromIndex:5];
-    NSString* str = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
-
-    NSArray<NSString*>* trimmed = [str.lines map:^id _Nonnull(NSString * _Nonnull obj, NSUInteger idx) {
-        return obj.trimmed;
-    }];
-    
-    NSArray<NSString*> *nonEmpty = [trimmed filter:^BOOL(NSString * _Nonnull obj) {
-        return obj.length != 0;
-    }];
-        
-    
-    
-    for (NSString* line in nonEmpty) {
-        NSArray<NSString*>* components = [line componentsSeparatedByString:@":"];
-    
-        if (components.count != 2) {
-            return NO;
+        else if (pwned) {
+            NSLog(@"Caching HIBP hit...");
+            [self cachePwnedHashes:@[sha1HexPassword]];
         }
         
-        NSString* hash = components[0];
-        NSString* count = components[1]; 
-        
-        if (![count isEqualToString:@"0"] && [hash isEqualToString:suffix]) {
-            return YES;
-        }
-    }
-    
-    return NO;
+        completion(pwned, error);
+    }];
 }
 
 - (void)publishPartialProgress {
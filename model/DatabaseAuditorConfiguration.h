@@ -41,6 +41,8 @@ NS_ASSUME_NONNULL_BEGIN
 @property NSUInteger hibpCheckForNewBreachesIntervalSeconds;
 @property (nullable) NSDate* lastHibpOnlineCheck;
 @property (readonly) BOOL showCachedHibpHits;
+@property BOOL hibpOfflineMode;
+@property NSUInteger hibpMaxConcurrentRequests;
 
 @end
 
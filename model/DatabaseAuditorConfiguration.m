@@ -42,6 +42,8 @@ const NSUInteger kDefaultLowEntropyThreshold = 36; // bits
         self.hibpCaveatAccepted = NO;
         self.hibpCheckForNewBreachesIntervalSeconds = 7 * 24 * 60 * 60; 
         self.lastHibpOnlineCheck = nil;
+        self.hibpOfflineMode = NO;
+        self.hibpMaxConcurrentRequests = 8;
     }
         
     return self;
@@ -73,6 +75,8 @@ const NSUInteger kDefaultLowEntropyThreshold = 36; // bits
     if (jsonDictionary[@"hibpCheckForNewBreachesIntervalSeconds"] != nil ) ret.hibpCheckForNewBreachesIntervalSeconds = ((NSNumber*)(jsonDictionary[@"hibpCheckForNewBreachesIntervalSeconds"])).unsignedIntegerValue;
 
     if (jsonDictionary[@"lastHibpOnlineCheck"] != nil ) ret.lastHibpOnlineCheck = [NSDate dateWithTimeIntervalSinceReferenceDate:((NSNumber*)(jsonDictionary[@"lastHibpOnlineCheck"])).doubleValue];
+    if (jsonDictionary[@"hibpOfflineMode"] != nil ) ret.hibpOfflineMode = ((NSNumber*)(jsonDictionary[@"hibpOfflineMode"])).boolValue;
+    if (jsonDictionary[@"hibpMaxConcurrentRequests"] != nil ) ret.hibpMaxConcurrentRequests = ((NSNumber*)(jsonDictionary[@"hibpMaxConcurrentRequests"])).unsignedIntegerValue;
     if (jsonDictionary[@"lastKnownAuditIssueCount"] != nil ) ret.lastKnownAuditIssueCount = ((NSNumber*)(jsonDictionary[@"lastKnownAuditIssueCount"]));
     if (jsonDictionary[@"lowEntropyThreshold"] != nil ) ret.lowEntropyThreshold = ((NSNumber*)(jsonDictionary[@"lowEntropyThreshold"])).unsignedIntegerValue;
     if (jsonDictionary[@"checkForTwoFactorAvailable"] != nil ) ret.checkForTwoFactorAvailable = ((NSNumber*)(jsonDictionary[@"checkForTwoFactorAvailable"])).boolValue;
@@ -96,6 +100,8 @@ const NSUInteger kDefaultLowEntropyThreshold = 36; // bits
         @"showAuditPopupNotifications2" : @(self.showAuditPopupNotifications),
         @"hibpCaveatAccepted" : @(self.hibpCaveatAccepted),
         @"hibpCheckForNewBreachesIntervalSeconds" : @(self.hibpCheckForNewBreachesIntervalSeconds),
+        @"hibpOfflineMode" : @(self.hibpOfflineMode),
+        @"hibpMaxConcurrentRequests" : @(self.hibpMaxConcurrentRequests),
 
         @"lowEntropyThreshold" : @(self.lowEntropyThreshold),
         @"checkForTwoFactorAvailable" : @(self.checkForTwoFactorAvailable),
@@ -133,6 +139,8 @@ const NSUInteger kDefaultLowEntropyThreshold = 36; // bits
         self.checkForTwoFactorAvailable = [coder decodeBoolForKey:@"checkForTwoFactorAvailable"];
         self.lastHibpOnlineCheck = [coder decodeObjectForKey:@"lastHibpOnlineCheck"];
         self.lastKnownAuditIssueCount = [coder decodeObjectForKey:@"lastKnownAuditIssueCount"];
+        self.hibpOfflineMode = [coder decodeBoolForKey:@"hibpOfflineMode"];
+        self.hibpMaxConcurrentRequests = [coder containsValueForKey:@"hibpMaxConcurrentRequests"] ? [coder decodeIntegerForKey:@"hibpMaxConcurrentRequests"] : 8;
 
         if ( [coder containsValueForKey:@"showAuditPopupNotifications2"] ) {
             self.showAuditPopupNotifications = [coder decodeBoolForKey:@"showAuditPopupNotifications2"];
@@ -164,6 +172,8 @@ const NSUInteger kDefaultLowEntropyThreshold = 36; // bits
     [coder encodeBool:self.checkForTwoFactorAvailable forKey:@"checkForTwoFactorAvailable"];
     [coder encodeObject:self.lastHibpOnlineCheck forKey:@"lastHibpOnlineCheck"];
     [coder encodeObject:self.lastKnownAuditIssueCount forKey:@"lastKnownAuditIssueCount"];
+    [coder encodeBool:self.hibpOfflineMode forKey:@"hibpOfflineMode"];
+    [coder encodeInteger:self.hibpMaxConcurrentRequests forKey:@"hibpMaxConcurrentRequests"];
 }
 
 @end
@@ -0,0 +1,149 @@
+//
+//  DatabaseMergerTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "DatabaseMerger.h"
+#import "DatabaseModel.h"
+#import "NSUUID+Zero.h"
+
+static const NSUInteger kEntriesPerGroup = 25;
+
+@interface DatabaseMergerTests : XCTestCase
+
+@end
+
+@implementation DatabaseMergerTests
+
+- (Node*)addGroup:(NSString*)title parent:(Node*)parent database:(DatabaseModel*)database {
+    Node* group = [[Node alloc] initAsGroup:title parent:parent keePassGroupTitleRules:YES uuid:nil];
+    XCTAssertTrue([database addChildren:@[group] destination:parent]);
+    return group;
+}
+
+- (void)addEntries:(NSUInteger)count parent:(Node*)parent database:(DatabaseModel*)database {
+    NSMutableArray<Node*>* entries = NSMutableArray.array;
+
+    for ( NSUInteger i = 0; i < count; i++ ) {
+        Node* entry = [[Node alloc] initAsRecord:[NSString stringWithFormat:@"%@ %lu", parent.title, (unsigned long)i] parent:parent];
+        entry.fields.username = [NSString stringWithFormat:@"user%lu", (unsigned long)i];
+        entry.fields.password = NSUUID.UUID.UUIDString;
+        [entries addObject:entry];
+    }
+
+    XCTAssertTrue([database addChildren:entries destination:parent]);
+}
+
+- (DatabaseModel*)mine {
+    DatabaseModel* database = [[DatabaseModel alloc] initWithFormat:kKeePass4];
+    Node* root = database.effectiveRootGroup;
+
+    Node* bin = [self addGroup:@"Recycle Bin" parent:root database:database];
+    [self addEntries:kEntriesPerGroup parent:bin database:database];
+    [self addEntries:kEntriesPerGroup parent:[self addGroup:@"Old" parent:bin database:database] database:database];
+
+    Node* templates = [self addGroup:@"Templates" parent:root database:database];
+    [self addEntries:3 parent:templates database:database];
+
+    [self addEntries:kEntriesPerGroup parent:[self addGroup:@"Work" parent:root database:database] database:database];
+    [self addEntries:kEntriesPerGroup parent:[self addGroup:@"Home" parent:root database:database] database:database];
+
+    NSDate* past = [NSDate dateWithTimeIntervalSinceNow:-86400];
+    for ( Node* node in database.rootNode.allChildren ) {
+        [node setModifiedDateExplicit:past setParents:NO];
+    }
+
+    database.meta.recycleBinEnabled = YES;
+    database.meta.recycleBinGroup = bin.uuid;
+    database.meta.recycleBinChanged = past;
+    database.meta.entryTemplatesGroup = templates.uuid;
+    database.meta.entryTemplatesGroupChanged = past;
+
+    [database rebuildFastMaps];
+
+    return database;
+}
+
+- (DatabaseModel*)theirsFrom:(DatabaseModel*)mine {
+    DatabaseModel* theirs = [mine clone];
+    Node* root = theirs.effectiveRootGroup;
+
+    Node* bin = [root getChildGroupWithTitle:@"Recycle Bin"];
+    Node* templates = [root getChildGroupWithTitle:@"Templates"];
+    Node* work = [root getChildGroupWithTitle:@"Work"];
+    Node* home = [root getChildGroupWithTitle:@"Home"];
+
+    [theirs deleteItems:@[bin, templates]];
+
+    Node* newTemplates = [self addGroup:@"New Templates" parent:root database:theirs];
+    [self addEntries:2 parent:newTemplates database:theirs];
+    theirs.meta.entryTemplatesGroup = newTemplates.uuid;
+    theirs.meta.entryTemplatesGroupChanged = NSDate.date;
+
+    [self addEntries:kEntriesPerGroup parent:[self addGroup:@"Travel" parent:work database:theirs] database:theirs];
+
+    Node* edited = work.childRecords.firstObject;
+    [theirs setItemTitle:edited title:@"Edited Title"];
+    edited.fields.password = @"changed";
+    [edited touch:YES touchParents:NO];
+
+    XCTAssertTrue([theirs moveItems:@[home.childRecords.firstObject, home.childRecords.lastObject] destination:work]);
+
+    [theirs rebuildFastMaps];
+
+    return theirs;
+}
+
+- (DatabaseModel*)merge:(DatabaseModel*)mine theirs:(DatabaseModel*)theirs batched:(BOOL)batched {
+    DatabaseModel* merged = [mine clone];
+    DatabaseMerger* merger = [DatabaseMerger mergerFor:merged theirs:[theirs clone] batched:batched];
+
+    XCTAssertTrue([merger merge]);
+    XCTAssertEqual(merger.report.batched, batched);
+
+    return merged;
+}
+
+- (void)assertTree:(Node*)node equals:(Node*)other {
+    XCTAssertEqualObjects(node.uuid, other.uuid);
+    XCTAssertTrue([node isSyncEqualTo:other], @"[%@] vs [%@]", node.title, other.title);
+    XCTAssertEqual(node.children.count, other.children.count, @"[%@]", node.title);
+
+    NSUInteger count = MIN(node.children.count, other.children.count);
+    for ( NSUInteger i = 0; i < count; i++ ) {
+        [self assertTree:node.children[i] equals:other.children[i]];
+    }
+}
+
+- (void)testBatchedMergeMatchesUnbatchedMerge {
+    DatabaseModel* mine = [self mine];
+    DatabaseModel* theirs = [self theirsFrom:mine];
+
+    DatabaseModel* batched = [self merge:mine theirs:theirs batched:YES];
+    DatabaseModel* unbatched = [self merge:mine theirs:theirs batched:NO];
+
+    [self assertTree:batched.rootNode equals:unbatched.rootNode];
+
+    XCTAssertEqualObjects(batched.deletedObjects, unbatched.deletedObjects);
+    XCTAssertEqualObjects(batched.meta.recycleBinGroup, unbatched.meta.recycleBinGroup);
+    XCTAssertEqualObjects(batched.meta.entryTemplatesGroup, unbatched.meta.entryTemplatesGroup);
+
+    XCTAssertNil([batched.effectiveRootGroup getChildGroupWithTitle:@"Recycle Bin"]);
+    XCTAssertNil([batched.effectiveRootGroup getChildGroupWithTitle:@"Templates"]);
+    XCTAssertEqualObjects(batched.meta.recycleBinGroup, NSUUID.zero);
+
+    Node* templates = [batched getItemById:batched.meta.entryTemplatesGroup];
+    XCTAssertNotNil(templates);
+    XCTAssertEqualObjects(templates.title, @"New Templates");
+    XCTAssertEqual(templates.parent, batched.effectiveRootGroup);
+
+    for ( Node* node in batched.rootNode.allChildren ) {
+        XCTAssertEqual([batched getItemById:node.uuid], node);
+    }
+}
+
+@end
@@ -8,6 +8,8 @@
 #import "UnifiedDatabaseMetadata.h"
 #import "NodeHierarchyReconstructionData.h"
 #import "CompositeKeyFactors.h"
+#import "SearchScope.h"
+#import "SprCompilationCache.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -55,6 +57,10 @@ NS_ASSUME_NONNULL_BEGIN
 
 
 - (void)rebuildFastMaps; 
+- (void)refreshFastMapsForItems:(NSArray<Node*>*)items;
+- (void)refreshFastMapsForModifiedItems;
+
+@property (readonly) SprCompilationCache* sprCompilationCache;
 
 
 
@@ -111,6 +117,11 @@ NS_ASSUME_NONNULL_BEGIN
            destination:(Node *)destination
             atPosition:(NSInteger)position;
 
+- (BOOL)insertChildren:(NSArray<Node *>*)items
+           destination:(Node *)destination
+            atPosition:(NSInteger)position
+suppressFastMapsRebuild:(BOOL)suppressFastMapsRebuild;
+
 - (void)removeChildren:(NSArray<NSUUID *>*)itemIds;
 
 
@@ -139,6 +150,12 @@ NS_ASSUME_NONNULL_BEGIN
 - (BOOL)isAllFieldsMatches:(NSString*)searchText node:(Node*)node dereference:(BOOL)dereference checkPinYin:(BOOL)checkPinYin;
 - (NSArray<NSString*>*)getSearchTerms:(NSString *)searchText;
 
+- (NSSet<Node*>*_Nullable)getSearchCandidates:(NSArray<NSString*>*)terms
+                                        scope:(SearchScope)scope
+                                  dereference:(BOOL)dereference;
+
+- (NSArray<Node*>*)searchableIncludingRecycledFromCandidates:(NSSet<Node*>*)candidates trueRoot:(BOOL)trueRoot;
+
 - (NSString*)getHtmlPrintString:(NSString*)databaseName;
 
 
@@ -11,6 +11,8 @@
 #import "MinimalPoolHelper.h"
 #import "NSString+Extensions.h"
 #import "FastMaps.h"
+#import "DatabaseSearchIndex.h"
+#import "SprCompilationCache.h"
 #import "CrossPlatform.h"
 
 #if TARGET_OS_IPHONE
@@ -27,6 +29,14 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
 @property (nonatomic) DatabaseFormat format;
 @property (nonatomic, nonnull, readonly) UnifiedDatabaseMetadata* metadata;
 @property (readonly) FastMaps* fastMaps;
+@property (nullable) DatabaseSearchIndex* searchIndex;
+@property (nullable) SprCompilationCache* sprCache;
+@property (nullable) NSMapTable<Node*, NSNumber*>* treeOrder;
+@property NSUInteger treeOrderEpoch;
+@property NSUInteger fastMapsContentGeneration;
+@property NSUInteger derivedFlagsEpoch;
+@property (nullable) NSUUID* derivedFlagsRecyclerId;
+@property (nullable, weak) Node* derivedFlagsKeePass1Backup;
 
 @property (readonly) id<ApplicationPreferences> preferences;
 
@@ -281,7 +291,12 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
         [self addHistoricalNode:item originalNodeForHistory:originalNodeForHistory];
         [item touch:YES touchParents:NO];
 
-        [self rebuildFastMaps];
+        if ( item.isGroup && self.format == kKeePass1 ) {
+            [self rebuildFastMaps]; 
+        }
+        else {
+            [self refreshFastMapsForItems:@[item]];
+        }
     }
     
     return ret;
@@ -293,7 +308,7 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
     if ( node ) {
         if ( ![node.fields.tags containsObject:tag] ) {
             [node.fields.tags addObject:tag];
-            [self rebuildFastMaps];
+            [self refreshFastMapsForItems:@[node]];
             return YES;
         }
     }
@@ -307,7 +322,7 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
     if ( node ) {
         if ( [node.fields.tags containsObject:tag] ) {
             [node.fields.tags removeObject:tag];
-            [self rebuildFastMaps];
+            [self refreshFastMapsForItems:@[node]];
             return YES;
         }
     }
@@ -381,7 +396,14 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
         }
     }
         
-    [self rebuildFastMaps]; 
+    if ( self.format == kKeePass1 ) {
+        [self rebuildFastMaps]; 
+    }
+    else {
+        for ( Node* item in minimalItems ) {
+            [self reindexSubtree:item];
+        }
+    }
     
     return !rollback;
 }
@@ -396,6 +418,7 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
     
         if (originalMovedItem && originalMovedItem.parent ) {
             [originalMovedItem.parent removeChild:originalMovedItem];
+            [self removeSubtreeFromIndexes:originalMovedItem];
         }
         else {
             
@@ -462,7 +485,14 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
     }
     
     if ( !suppressFastMapsRebuild ) {
-        [self rebuildFastMaps];
+        if ( self.format == kKeePass1 ) {
+            [self rebuildFastMaps]; 
+        }
+        else {
+            for ( Node* item in items ) {
+                [self addSubtreeToIndexes:item];
+            }
+        }
     }
 
     return YES;
@@ -477,13 +507,14 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
     for ( Node* item in items ) {
         if ( item && item.parent ) {
             [item.parent removeChild:item];
+            [self removeSubtreeFromIndexes:item];
         }
         else {
             NSLog(@"🔴 WARN: Not removing Node from Parent (at least one is nil) [node=%@, parent=%@]", item, item.parent);
         }
     }
     
-    [self rebuildFastMaps];
+    [self finishIncrementalFastMapsRemoval];
 }
 
 
@@ -566,6 +597,7 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
         }
         
         [parent insertChild:recon.clonedNode keePassGroupTitleRules:self.isUsingKeePassGroupTitleRules atPosition:-1];
+        [self addSubtreeToIndexes:recon.clonedNode];
         
         NSUInteger currentIndex = parent.children.count - 1;
         if (currentIndex != recon.index) {
@@ -575,7 +607,9 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
         }
     }
     
-    [self rebuildFastMaps];
+    if ( self.format == kKeePass1 ) {
+        [self rebuildFastMaps]; 
+    }
 }
 
 - (void)unDelete:(NSArray<NodeHierarchyReconstructionData*>*)undoData {
@@ -637,6 +671,8 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
             return;
         }
 
+        [self removeSubtreeFromIndexes:item];
+        
         if ( item.isGroup ) {
             if ( [self deleteAllGroupItems:item deletionDate:now] ) {
                 deletedSomething = YES;
@@ -655,7 +691,7 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
     }
     
     if ( deletedSomething ) { 
-        [self rebuildFastMaps];
+        [self finishIncrementalFastMapsRemoval];
     }
 }
 
@@ -692,21 +728,27 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
 }
 
 - (void)setRecycleBinEnabled:(BOOL)recycleBinEnabled {
-    self.metadata.recycleBinEnabled = recycleBinEnabled;
-    
-    [self rebuildFastMaps];
+    self.metadata.recycleBinEnabled = recycleBinEnabled; 
 }
 
 - (void)setRecycleBinNodeUuid:(NSUUID *)recycleBinNode {
+    Node* oldRecycleBin = self.recycleBinNode;
+    
     self.metadata.recycleBinGroup = recycleBinNode;
     
-    [self rebuildFastMaps];
+    Node* newRecycleBin = self.recycleBinNode;
+    
+    if ( oldRecycleBin ) {
+        [self reindexSubtree:oldRecycleBin];
+    }
+    
+    if ( newRecycleBin && newRecycleBin != oldRecycleBin ) {
+        [self reindexSubtree:newRecycleBin];
+    }
 }
 
 - (void)setRecycleBinChanged:(NSDate *)recycleBinChanged {
-    self.metadata.recycleBinChanged = recycleBinChanged;
-    
-    [self rebuildFastMaps];
+    self.metadata.recycleBinChanged = recycleBinChanged; 
 }
 
 - (void)createNewRecycleBinNode {
@@ -725,8 +767,6 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
 
     self.recycleBinNodeUuid = recycleBin.uuid;
     self.recycleBinChanged = [NSDate date];
-    
-    [self rebuildFastMaps];
 }
 
 
@@ -752,9 +792,9 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
                         trueRoot:(BOOL)trueRoot {
     Node* root = trueRoot ? self.rootNode : self.effectiveRootGroup;
     DatabaseFormat format = self.format;
-    Node* keePass1BackupNode = (format == kKeePass1) ? self.keePass1BackupNode : nil;
-    Node* kp2RecycleBin = (format == kKeePass || format == kKeePass4 ) ? self.recycleBinNode : nil;
-    Node* recycler = kp2RecycleBin ? kp2RecycleBin : keePass1BackupNode;
+    NodeDerivedFlags recycled = kNodeDerivedFlagInRecycleBin | kNodeDerivedFlagInKeePass1Backup;
+    
+    [self refreshDerivedFlagsIfNeeded];
     
     return [root filterChildren:YES predicate:^BOOL(Node * _Nonnull node) {
         if (!includeGroups && node.isGroup) {
@@ -765,16 +805,18 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
             return NO;
         }
         
+        NodeDerivedFlags flags = node.derivedFlags;
+        
         if ( searchableOnly ) {
             if ( format == kKeePass || format == kKeePass4 ) {
-                if ( !node.isSearchable ) {
+                if ( !(flags & kNodeDerivedFlagSearchable) ) {
                     return NO;
                 }
             }
         }
         
         if ( !includeRecycled ) {
-            if ( recycler != nil && (node == recycler || [recycler contains:node]) ) {
+            if ( flags & recycled ) {
                 return NO;
             }
         }
@@ -789,46 +831,46 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
 
 - (BOOL)isTitleMatches:(NSString*)searchText node:(Node*)node dereference:(BOOL)dereference checkPinYin:(BOOL)checkPinYin {
     NSString* foo = [self maybeDeref:node.title node:node maybe:dereference];
-    return [foo containsSearchString:searchText checkPinYin:checkPinYin];
+    return [self isSearchMatch:foo searchText:searchText node:node checkPinYin:checkPinYin];
 }
 
 - (BOOL)isUsernameMatches:(NSString*)searchText node:(Node*)node dereference:(BOOL)dereference  checkPinYin:(BOOL)checkPinYin {
     NSString* foo = [self maybeDeref:node.fields.username node:node maybe:dereference];
-    return [foo containsSearchString:searchText checkPinYin:checkPinYin];
+    return [self isSearchMatch:foo searchText:searchText node:node checkPinYin:checkPinYin];
 }
 
 - (BOOL)isPasswordMatches:(NSString*)searchText node:(Node*)node dereference:(BOOL)dereference checkPinYin:(BOOL)checkPinYin {
     NSString* foo = [self maybeDeref:node.fields.password node:node maybe:dereference];
-    return [foo containsSearchString:searchText checkPinYin:checkPinYin];
+    return [self isSearchMatch:foo searchText:searchText node:node checkPinYin:checkPinYin];
 }
 
 - (BOOL)isEmailMatches:(NSString*)searchText node:(Node*)node dereference:(BOOL)dereference checkPinYin:(BOOL)checkPinYin {
     NSString* email = node.fields.email;
 
     NSString* foo = [self maybeDeref:email node:node maybe:dereference];
-    return [foo containsSearchString:searchText checkPinYin:checkPinYin];
+    return [self isSearchMatch:foo searchText:searchText node:node checkPinYin:checkPinYin];
 }
 
 - (BOOL)isNotesMatches:(NSString*)searchText node:(Node*)node dereference:(BOOL)dereference checkPinYin:(BOOL)checkPinYin {
     NSString* foo = [self maybeDeref:node.fields.notes node:node maybe:dereference];
-    return [foo containsSearchString:searchText checkPinYin:checkPinYin];
+    return [self isSearchMatch:foo searchText:searchText node:node checkPinYin:checkPinYin];
 }
 
 - (BOOL)isTagsMatches:(NSString*)searchText node:(Node*)node checkPinYin:(BOOL)checkPinYin {
     return [node.fields.tags.allObjects anyMatch:^BOOL(NSString * _Nonnull obj) {
-        return [obj containsSearchString:searchText checkPinYin:checkPinYin];
+        return [self isSearchMatch:obj searchText:searchText node:node checkPinYin:checkPinYin];
     }];
 }
 
 - (BOOL)isUrlMatches:(NSString*)searchText node:(Node*)node dereference:(BOOL)dereference checkPinYin:(BOOL)checkPinYin {
     NSString* foo = [self maybeDeref:node.fields.url node:node maybe:dereference];
-    if ( [foo containsSearchString:searchText checkPinYin:checkPinYin] ) {
+    if ( [self isSearchMatch:foo searchText:searchText node:node checkPinYin:checkPinYin] ) {
         return YES;
     }
 
     for (NSString* altUrl in node.fields.alternativeUrls) {
         NSString* foo = [self maybeDeref:altUrl node:node maybe:dereference];
-        if([foo containsSearchString:searchText checkPinYin:checkPinYin]) {
+        if([self isSearchMatch:foo searchText:searchText node:node checkPinYin:checkPinYin]) {
             return YES;
         }
     }
@@ -852,11 +894,13 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
         if (self.format == kKeePass4 || self.format == kKeePass) {
             
             
-            for (NSString* key in node.fields.customFields.allKeys) {
-                NSString* value = node.fields.customFields[key].value;
+            MutableOrderedDictionary<NSString*, StringValue*>* customFields = node.fields.customFields;
+            
+            for (NSString* key in customFields.allKeys) {
+                NSString* value = customFields[key].value;
                 NSString* derefed = [self maybeDeref:value node:node maybe:dereference];
                 
-                if ([key containsSearchString:searchText checkPinYin:checkPinYin] || [derefed containsSearchString:searchText checkPinYin:checkPinYin]) {
+                if ([self isSearchMatch:key searchText:searchText node:node checkPinYin:checkPinYin] || [self isSearchMatch:derefed searchText:searchText node:node checkPinYin:checkPinYin]) {
                     return YES;
                 }
             }
@@ -864,7 +908,7 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
                 
         if (self.format != kPasswordSafe) {
             BOOL attachmentMatch = [node.fields.attachments.allKeys anyMatch:^BOOL(NSString * _Nonnull obj) {
-                return [obj containsSearchString:searchText checkPinYin:checkPinYin];
+                return [self isSearchMatch:obj searchText:searchText node:node checkPinYin:checkPinYin];
             }];
             
             if (attachmentMatch) {
@@ -878,6 +922,128 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
     return NO;
 }
 
+- (BOOL)isSearchMatch:(NSString*)text searchText:(NSString*)searchText node:(Node*)node checkPinYin:(BOOL)checkPinYin {
+    if ( [text containsSearchString:searchText checkPinYin:NO] ) {
+        return YES;
+    }
+    
+    if ( !checkPinYin || text.length == 0 || searchText.length == 0 ) {
+        return NO;
+    }
+    
+    NSString* pinYin = [node.fields pinYinForText:text];
+    
+    return pinYin ? [pinYin localizedStandardContainsString:searchText] : NO;
+}
+
+- (NSSet<Node*>*)getSearchCandidates:(NSArray<NSString*>*)terms
+                                scope:(SearchScope)scope
+                          dereference:(BOOL)dereference {
+    if ( terms.count == 0 ) {
+        return nil;
+    }
+    
+    [self refreshFastMapsForModifiedItems];
+    
+    DatabaseSearchIndex* searchIndex = [self getOrBuildSearchIndex];
+    
+    NSMutableSet<Node*>* candidates = nil;
+    
+    for ( NSString* term in terms ) {
+        NSSet<Node*>* termCandidates = [searchIndex candidatesForTerm:term scope:scope dereference:dereference];
+        
+        if ( candidates == nil ) {
+            candidates = termCandidates.mutableCopy;
+        }
+        else {
+            [candidates intersectSet:termCandidates];
+        }
+        
+        if ( candidates.count == 0 ) {
+            break;
+        }
+    }
+    
+    return candidates;
+}
+
+- (NSArray<Node*>*)searchableIncludingRecycledFromCandidates:(NSSet<Node*>*)candidates trueRoot:(BOOL)trueRoot {
+    Node* excluded = trueRoot ? self.rootNode : self.effectiveRootGroup;
+    BOOL checkSearchable = self.format == kKeePass || self.format == kKeePass4;
+    
+    [self refreshDerivedFlagsIfNeeded];
+    
+    NSMutableArray<Node*>* ret = [NSMutableArray arrayWithCapacity:candidates.count];
+    
+    for ( Node* node in candidates ) {
+        if ( node == self.rootNode || node == excluded ) {
+            continue;
+        }
+        
+        if ( checkSearchable && !(node.derivedFlags & kNodeDerivedFlagSearchable) ) {
+            continue;
+        }
+        
+        [ret addObject:node];
+    }
+    
+    NSMapTable<Node*, NSNumber*>* treeOrder = [self getOrBuildTreeOrder];
+    
+    [ret sortUsingComparator:^NSComparisonResult(Node*  _Nonnull obj1, Node*  _Nonnull obj2) {
+        return [[treeOrder objectForKey:obj1] compare:[treeOrder objectForKey:obj2]];
+    }];
+    
+    return ret;
+}
+
+- (NSMapTable<Node*, NSNumber*>*)getOrBuildTreeOrder {
+    @synchronized (self) {
+        NSUInteger epoch = self.rootNode.derivedFlagsEpoch;
+        
+        if ( self.treeOrder == nil || self.treeOrderEpoch != epoch ) {
+            NSArray<Node*>* nodes = self.rootNode.allChildren;
+            NSMapTable<Node*, NSNumber*>* treeOrder = [[NSMapTable alloc] initWithKeyOptions:NSPointerFunctionsWeakMemory | NSPointerFunctionsObjectPointerPersonality
+                                                                                  valueOptions:NSPointerFunctionsStrongMemory
+                                                                                      capacity:nodes.count];
+            
+            [nodes enumerateObjectsUsingBlock:^(Node * _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
+                [treeOrder setObject:@(idx) forKey:obj];
+            }];
+            
+            self.treeOrder = treeOrder;
+            self.treeOrderEpoch = epoch;
+        }
+        
+        return self.treeOrder;
+    }
+}
+
+- (DatabaseSearchIndex*)getOrBuildSearchIndex {
+    @synchronized (self) {
+        if ( self.searchIndex == nil ) {
+            DatabaseSearchIndex* searchIndex = [[DatabaseSearchIndex alloc] initWithFormat:self.format];
+            
+            for ( Node* node in self.rootNode.allChildren ) {
+                [searchIndex addNode:node];
+            }
+            
+            self.searchIndex = searchIndex;
+        }
+        
+        return self.searchIndex;
+    }
+}
+
+- (SprCompilationCache *)sprCompilationCache {
+    @synchronized (self) {
+        if ( self.sprCache == nil ) {
+            self.sprCache = [[SprCompilationCache alloc] initWithRootNode:self.rootNode];
+        }
+        
+        return self.sprCache;
+    }
+}
+
 - (NSArray<NSString*>*)getSearchTerms:(NSString *)searchText {
     NSArray* split = [searchText componentsSeparatedByString:@" "];
     NSMutableSet<NSString*>* unique = [NSMutableSet setWithArray:split];
@@ -894,137 +1060,164 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
 
 
 - (void)rebuildFastMaps {
-    NSMutableDictionary<NSUUID*, Node*>* uuidMap = NSMutableDictionary.dictionary;
-    NSMutableSet<NSUUID*> *expirySet = NSMutableSet.set;
-    NSMutableSet<NSUUID*> *attachmentSet = NSMutableSet.set;
-    NSMutableSet<NSUUID*> *totpSet = NSMutableSet.set;
-    NSMutableDictionary<NSString*, NSMutableSet<NSUUID*>*>* tagMap = NSMutableDictionary.dictionary;
-    NSCountedSet<NSString*> *usernameSet = NSCountedSet.set;
-    NSCountedSet<NSString*> *emailSet = NSCountedSet.set;
-    NSCountedSet<NSString*> *urlSet = NSCountedSet.set;
-    NSCountedSet<NSString*> *customFieldKeySet = NSCountedSet.set;
+    self.fastMapsContentGeneration = self.rootNode.contentGeneration;
+    _fastMaps = [self buildFullFastMaps];
+    self.searchIndex = nil;
+    self.sprCache = nil;
+}
+
+- (FastMaps*)buildFullFastMaps {
+    FastMaps* maps = [[FastMaps alloc] init];
     
     if ( self.rootNode ) {
-        uuidMap[self.rootNode.uuid] = self.rootNode;
+        NSUUID* recyclerId = self.fastMapsRecyclerId;
+        Node* keePass1Backup = self.fastMapsKeePass1Backup;
+        
+        NSArray<Node*>* nodes = [@[self.rootNode] arrayByAddingObjectsFromArray:self.rootNode.allChildren];
+        
+        [maps addNodes:nodes indexed:^BOOL(Node * _Nonnull node) {
+            return [self isFastMapsIndexed:node recyclerId:recyclerId keePass1Backup:keePass1Backup];
+        }];
+    }
+    
+    return maps;
+}
+
+- (void)refreshDerivedFlagsIfNeeded {
+    [self refreshDerivedFlagsIfNeeded:self.fastMapsRecyclerId keePass1Backup:self.fastMapsKeePass1Backup];
+}
 
+- (void)refreshDerivedFlagsIfNeeded:(NSUUID*)recyclerId keePass1Backup:(Node*)keePass1Backup {
+    @synchronized (self) {
+        NSUInteger epoch = self.rootNode.derivedFlagsEpoch;
         
+        BOOL sameRecycler = (recyclerId == nil && self.derivedFlagsRecyclerId == nil) || [recyclerId isEqual:self.derivedFlagsRecyclerId];
         
-        for (Node* node in self.rootNode.allChildren) { 
-            Node* existing = uuidMap[node.uuid];
-            
-            if ( existing ) {
-                NSLog(@"🔴 WARNWARN: Duplicate ID in database => [%@] - [%@] - [%@]", existing, node, node.uuid);
-            }
-            else {
-                uuidMap[node.uuid] = node;
-            }
+        if ( epoch == self.derivedFlagsEpoch && sameRecycler && keePass1Backup == self.derivedFlagsKeePass1Backup ) {
+            return;
         }
         
-        FastMaps* newMaps = [[FastMaps alloc] initWithUuidMap:uuidMap
-                                              withExpiryDates:expirySet
-                                              withAttachments:attachmentSet
-                                                    withTotps:totpSet
-                                                       tagMap:tagMap
-                                                  usernameSet:usernameSet
-                                                     emailSet:emailSet
-                                                       urlSet:urlSet
-                                            customFieldKeySet:customFieldKeySet];
-
-        _fastMaps = newMaps;
+        [self.rootNode refreshDerivedFlags:recyclerId keePass1Backup:keePass1Backup];
+        
+        self.derivedFlagsEpoch = epoch;
+        self.derivedFlagsRecyclerId = recyclerId;
+        self.derivedFlagsKeePass1Backup = keePass1Backup;
+    }
+}
+
+- (void)refreshFastMapsForItems:(NSArray<Node *> *)items {
+    NSUUID* recyclerId = self.fastMapsRecyclerId;
+    Node* keePass1Backup = self.fastMapsKeePass1Backup;
+
+    DatabaseSearchIndex* searchIndex = self.searchIndex;
+    self.sprCache = nil;
+
+    for ( Node* item in items ) {
+        [self.fastMaps updateNode:item indexed:[self isFastMapsIndexed:item recyclerId:recyclerId keePass1Backup:keePass1Backup]];
+        [searchIndex updateNode:item];
+    }
+}
+
+- (void)refreshFastMapsForModifiedItems {
+    NSUInteger since;
+    NSUInteger generation;
+    
+    @synchronized (self) {
+        since = self.fastMapsContentGeneration;
+        generation = self.rootNode.contentGeneration;
         
+        if ( generation == since ) {
+            return;
+        }
         
+        self.fastMapsContentGeneration = generation;
+    }
+    
+    NSArray<Node*>* modified = [self.rootNode.allChildren filter:^BOOL(Node * _Nonnull obj) {
+        return obj.fields.contentVersion > since;
+    }];
+    
+    [self refreshFastMapsForItems:modified];
+}
 
-        DatabaseFormat format = self.format;
-        Node* keePass1BackupNode = (format == kKeePass1) ? self.keePass1BackupNode : nil;
-        Node* kp2RecycleBin = (format == kKeePass || format == kKeePass4 ) ? self.recycleBinNode : nil;
-        Node* recycler = kp2RecycleBin ? kp2RecycleBin : keePass1BackupNode;
+- (void)addSubtreeToIndexes:(Node*)subtreeRoot {
+    NSUUID* recyclerId = self.fastMapsRecyclerId;
+    Node* keePass1Backup = self.fastMapsKeePass1Backup;
+    DatabaseSearchIndex* searchIndex = self.searchIndex;
+    self.sprCache = nil;
+    
+    [self.fastMaps addNode:subtreeRoot indexed:[self isFastMapsIndexed:subtreeRoot recyclerId:recyclerId keePass1Backup:keePass1Backup]];
+    [searchIndex addNode:subtreeRoot];
+    
+    for ( Node* node in subtreeRoot.allChildren ) {
+        [self.fastMaps addNode:node indexed:[self isFastMapsIndexed:node recyclerId:recyclerId keePass1Backup:keePass1Backup]];
+        [searchIndex addNode:node];
+    }
+}
 
-        for (Node* node in self.rootNode.allChildren) { 
-            if ( recycler != nil && (node == recycler || [recycler contains:node]) ) {
-                continue;
-            }
-            
-            if ( self.format == kKeePass || self.format == kKeePass4 ) {
-                if ( !node.isSearchable ) {
-                    continue;
-                }
-            }
-            
-            
-            
-            if ( node.fields.expires != nil ) {
-                [expirySet addObject:node.uuid];
-            }
-            
-            
-            
-            if ( node.fields.attachments.count > 0 ) {
-                [attachmentSet addObject:node.uuid];
-            }
-            
-            
-            
-            if ( node.fields.otpToken != nil ) {
-                [totpSet addObject:node.uuid];
-            }
-            
-            
-            
-            for ( NSString* tag in node.fields.tags ) {
-                NSMutableSet<NSUUID*>* set = tagMap[tag];
-                
-                if ( set == nil ) {
-                    tagMap[tag] = NSMutableSet.set;
-                    set = tagMap[tag];
-                }
-                                
-                [set addObject:node.uuid];
-            }
-            
-            
+- (void)removeSubtreeFromIndexes:(Node*)subtreeRoot {
+    DatabaseSearchIndex* searchIndex = self.searchIndex;
+    self.sprCache = nil;
 
-            NSString* username = [Utils trim:node.fields.username];
-            if ( username.length ) {
-                [usernameSet addObject:username];
-            }
+    [self.fastMaps removeNode:subtreeRoot];
+    [searchIndex removeNode:subtreeRoot];
+    
+    for ( Node* node in subtreeRoot.allChildren ) {
+        [self.fastMaps removeNode:node];
+        [searchIndex removeNode:node];
+    }
+}
 
-            
-            
-            NSString* email = [Utils trim:node.fields.email];
-            if ( email.length ) {
-                [emailSet addObject:email];
-            }
+- (void)reindexSubtree:(Node*)subtreeRoot {
+    NSUUID* recyclerId = self.fastMapsRecyclerId;
+    Node* keePass1Backup = self.fastMapsKeePass1Backup;
+    self.sprCache = nil;
+    
+    [self.fastMaps updateNode:subtreeRoot indexed:[self isFastMapsIndexed:subtreeRoot recyclerId:recyclerId keePass1Backup:keePass1Backup]];
+    
+    for ( Node* node in subtreeRoot.allChildren ) {
+        [self.fastMaps updateNode:node indexed:[self isFastMapsIndexed:node recyclerId:recyclerId keePass1Backup:keePass1Backup]];
+    }
+}
 
-            
-            
-            for (NSString* key in node.fields.customFields.allKeys) {
-                [customFieldKeySet addObject:key];
-            }
+- (void)finishIncrementalFastMapsRemoval {
+    if ( self.format == kKeePass1 ) {
+        [self rebuildFastMaps]; 
+    }
+}
 
-            
-            
-            NSString* url = [Utils trim:node.fields.url];
-            if ( url.length ) {
-                [urlSet addObject:url];
-            }
-        }
+- (NSUUID*)fastMapsRecyclerId {
+    return (self.format == kKeePass || self.format == kKeePass4) ? self.recycleBinNodeUuid : nil;
+}
+
+- (Node*)fastMapsKeePass1Backup {
+    return self.format == kKeePass1 ? self.keePass1BackupNode : nil;
+}
+
+- (BOOL)isFastMapsIndexed:(Node*)node recyclerId:(NSUUID*)recyclerId keePass1Backup:(Node*)keePass1Backup {
+    if ( node == self.rootNode ) {
+        return NO;
     }
     
-    FastMaps* newMaps = [[FastMaps alloc] initWithUuidMap:uuidMap
-                                          withExpiryDates:expirySet
-                                          withAttachments:attachmentSet
-                                                withTotps:totpSet
-                                                   tagMap:tagMap
-                                              usernameSet:usernameSet
-                                                 emailSet:emailSet
-                                                   urlSet:urlSet
-                                        customFieldKeySet:customFieldKeySet];
+    [self refreshDerivedFlagsIfNeeded:recyclerId keePass1Backup:keePass1Backup];
+    
+    NodeDerivedFlags flags = node.derivedFlags;
+    
+    if ( flags & (kNodeDerivedFlagInRecycleBin | kNodeDerivedFlagInKeePass1Backup) ) {
+        return NO;
+    }
+    
+    if ( self.format == kKeePass || self.format == kKeePass4 ) {
+        if ( !(flags & kNodeDerivedFlagSearchable) ) {
+            return NO;
+        }
+    }
 
-    _fastMaps = newMaps;
+    return YES;
 }
 
 - (NSArray<NSUUID *> *)getItemIdsForTag:(NSString *)tag {
-    NSSet<NSUUID*> *ret = self.fastMaps.tagMap[tag];
+    NSSet<NSUUID*> *ret = [self.fastMaps idsForTag:tag];
 
     return ret ? ret.allObjects : @[];
 }
@@ -1046,7 +1239,7 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
     }
     
     return [ids map:^id _Nonnull(NSUUID * _Nonnull obj, NSUInteger idx) {
-        return self.fastMaps.uuidMap[obj];
+        return [self.fastMaps nodeWithUuid:obj];
     }];
 }
 
@@ -1104,19 +1297,19 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
 }
 
 - (NSSet<NSString*> *)urlSet {
-    return [self.fastMaps.urlSet copy];
+    return self.fastMaps.urlSet;
 }
 
 - (NSSet<NSString*> *)usernameSet {
-    return [self.fastMaps.usernameSet copy];
+    return self.fastMaps.usernameSet;
 }
 
 - (NSSet<NSString*> *)emailSet {
-    return [self.fastMaps.emailSet copy];
+    return self.fastMaps.emailSet;
 }
 
 - (NSSet<NSString*> *)customFieldKeySet {
-    return [self.fastMaps.customFieldKeySet copy];
+    return self.fastMaps.customFieldKeySet;
 }
 
 - (NSString *)mostPopularEmail {
@@ -1136,7 +1329,7 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
 }
 
 - (NSSet<NSString*> *)tagSet {
-    NSArray<NSString*>* trimmed = [self.fastMaps.tagMap.allKeys map:^id _Nonnull(NSString * _Nonnull obj, NSUInteger idx) {
+    NSArray<NSString*>* trimmed = [self.fastMaps.tagCounts.allKeys map:^id _Nonnull(NSString * _Nonnull obj, NSUInteger idx) {
         return [Utils trim:obj];
     }];
 
@@ -1148,20 +1341,12 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
 }
 
 - (NSArray<NSString*>*)mostPopularTags {
-    NSArray<NSString*>* tags = self.fastMaps.tagMap.allKeys;
+    NSDictionary<NSString*, NSNumber*>* tagCounts = self.fastMaps.tagCounts;
+    NSArray<NSString*>* tags = tagCounts.allKeys;
     
     NSArray<NSString*>* sorted = [tags sortedArrayUsingComparator:^(id obj1, id obj2) {
-        NSString* tag1 = obj1;
-        NSString* tag2 = obj2;
-        
-        NSSet<NSUUID*>* set1 = self.fastMaps.tagMap[tag1];
-        NSSet<NSUUID*>* set2 = self.fastMaps.tagMap[tag2];
-        
-        set1 = set1 == nil ? NSSet.set : set1;
-        set2 = set2 == nil ? NSSet.set : set2;
-        
-        NSUInteger n = set1.count;
-        NSUInteger m = set2.count;
+        NSUInteger n = tagCounts[obj1].unsignedIntegerValue;
+        NSUInteger m = tagCounts[obj2].unsignedIntegerValue;
         
         return (n <= m) ? (n < m)? NSOrderedDescending : NSOrderedSame : NSOrderedAscending;
     }];
@@ -1421,7 +1606,7 @@ static const DatabaseFormat kDefaultDatabaseFormat = kKeePass4;
     
     Node* item = [self getItemById:itemId];
     if(item && self.recycleBinEnabled && self.recycleBinNode) {
-        if([self.recycleBinNode contains:item] || [self.recycleBinNode.uuid isEqual:itemId]) {
+        if([item isChildOf:self.recycleBinNode] || [self.recycleBinNode.uuid isEqual:itemId]) {
             willRecycle = NO;
         }
     }
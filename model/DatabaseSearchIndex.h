@@ -0,0 +1,38 @@
+//
+//  DatabaseSearchIndex.h
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "Node.h"
+#import "DatabaseFormat.h"
+#import "SearchScope.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface DatabaseSearchIndex : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithFormat:(DatabaseFormat)format;
+
+- (void)addNode:(Node*)node;
+- (void)removeNode:(Node*)node;
+- (void)updateNode:(Node*)node;
+
+@property (readonly) NSUInteger count;
+
+
+
+- (NSSet<Node*>*)candidatesForTerm:(NSString*)term
+                             scope:(SearchScope)scope
+                       dereference:(BOOL)dereference;
+
++ (NSString*)normalize:(NSString*)string;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,394 @@
+//
+//  DatabaseSearchIndex.m
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import "DatabaseSearchIndex.h"
+#import "NSString+Extensions.h"
+#import "Constants.h"
+
+static const NSUInteger kMaxGramLength = 3;
+static const NSUInteger kMinTombstonesForCompaction = 1024;
+
+typedef struct {
+    uint64_t* keys;
+    NSUInteger count;
+    NSUInteger capacity;
+} GramBuffer;
+
+static void gramBufferAppend(GramBuffer* buffer, uint64_t key) {
+    if ( buffer->count == buffer->capacity ) {
+        buffer->capacity = buffer->capacity ? buffer->capacity * 2 : 256;
+        buffer->keys = realloc(buffer->keys, buffer->capacity * sizeof(uint64_t));
+    }
+
+    buffer->keys[buffer->count++] = key;
+}
+
+static int compareGramKeys(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static inline uint64_t gramKey(SearchScope scope, const unichar* chars, NSUInteger length) {
+    uint64_t key = ((uint64_t)scope << 56) | ((uint64_t)length << 48);
+
+    for ( NSUInteger i = 0; i < length; i++ ) {
+        key |= (uint64_t)chars[i] << (32 - (16 * i));
+    }
+
+    return key;
+}
+
+@interface DatabaseSearchIndexEntry : NSObject
+
+@property NSUInteger nodeId;
+@property BOOL dereferenceable;
+
+@end
+
+@implementation DatabaseSearchIndexEntry
+
+@end
+
+@interface DatabaseSearchIndex ()
+
+@property (readonly) DatabaseFormat format;
+@property (readonly) NSMapTable<Node*, DatabaseSearchIndexEntry*>* entries;
+@property (readonly) NSMutableArray* nodesById;
+@property (readonly) NSMapTable* postings;
+@property (readonly) NSMutableIndexSet* dereferenceableIds;
+@property NSUInteger tombstones;
+
+@end
+
+@implementation DatabaseSearchIndex
+
+- (instancetype)initWithFormat:(DatabaseFormat)format {
+    if (self = [super init]) {
+        _format = format;
+
+        _entries = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                         valueOptions:NSPointerFunctionsStrongMemory];
+        _nodesById = NSMutableArray.array;
+        _postings = [[NSMapTable alloc] initWithKeyOptions:NSPointerFunctionsOpaqueMemory | NSPointerFunctionsIntegerPersonality
+                                              valueOptions:NSPointerFunctionsStrongMemory
+                                                  capacity:1 << 16];
+        _dereferenceableIds = NSMutableIndexSet.indexSet;
+    }
+
+    return self;
+}
+
++ (NSCharacterSet*)expandedOrIgnorableCharacters {
+    static NSCharacterSet* characters;
+    static dispatch_once_t onceToken;
+    
+    dispatch_once(&onceToken, ^{
+        NSMutableCharacterSet* set = NSCharacterSet.controlCharacterSet.mutableCopy;
+        [set addCharactersInString:@"æœßẞ"];
+        characters = set.copy;
+    });
+    
+    return characters;
+}
+
++ (NSString *)normalize:(NSString *)string {
+    NSString* folded = [string.precomposedStringWithCompatibilityMapping.uppercaseString stringByFoldingWithOptions:NSCaseInsensitiveSearch | NSDiacriticInsensitiveSearch | NSWidthInsensitiveSearch
+                                                                                                                 locale:NSLocale.currentLocale];
+    
+    NSCharacterSet* expandedOrIgnorable = DatabaseSearchIndex.expandedOrIgnorableCharacters;
+    if ( [folded rangeOfCharacterFromSet:expandedOrIgnorable].location == NSNotFound ) {
+        return folded;
+    }
+    
+    NSUInteger length = folded.length;
+    NSMutableString* ret = [NSMutableString stringWithCapacity:length + 8];
+    
+    for ( NSUInteger i = 0; i < length; i++ ) {
+        unichar c = [folded characterAtIndex:i];
+        
+        if ( c == 0x00E6 ) {
+            [ret appendString:@"ae"];
+        }
+        else if ( c == 0x0153 ) {
+            [ret appendString:@"oe"];
+        }
+        else if ( c == 0x00DF || c == 0x1E9E ) {
+            [ret appendString:@"ss"];
+        }
+        else if ( ![expandedOrIgnorable characterIsMember:c] ) {
+            [ret appendString:[NSString stringWithCharacters:&c length:1]];
+        }
+    }
+    
+    return ret;
+}
+
+- (NSUInteger)count {
+    @synchronized (self) {
+        return self.entries.count;
+    }
+}
+
+
+
+- (void)addNode:(Node *)node {
+    @synchronized (self) {
+        [self addNodeInternal:node];
+    }
+}
+
+- (void)removeNode:(Node *)node {
+    @synchronized (self) {
+        [self removeNodeInternal:node];
+
+        if ( self.tombstones > kMinTombstonesForCompaction && self.tombstones > self.entries.count ) {
+            [self compact];
+        }
+    }
+}
+
+- (void)updateNode:(Node *)node {
+    @synchronized (self) {
+        [self removeNodeInternal:node];
+        [self addNodeInternal:node];
+    }
+}
+
+- (void)addNodeInternal:(Node*)node {
+    if ( [self.entries objectForKey:node] != nil ) {
+        return;
+    }
+
+    DatabaseSearchIndexEntry* entry = [[DatabaseSearchIndexEntry alloc] init];
+    entry.nodeId = self.nodesById.count;
+    [self.nodesById addObject:node];
+    [self.entries setObject:entry forKey:node];
+
+    GramBuffer buffer = { 0 };
+
+    [self collectGrams:node entry:entry buffer:&buffer];
+
+    if ( buffer.count ) {
+        qsort(buffer.keys, buffer.count, sizeof(uint64_t), compareGramKeys);
+
+        uint64_t previous = 0;
+        for ( NSUInteger i = 0; i < buffer.count; i++ ) {
+            uint64_t key = buffer.keys[i];
+            if ( key == previous ) {
+                continue;
+            }
+            previous = key;
+
+            NSMutableIndexSet* posting = [self.postings objectForKey:(__bridge id)(void*)(uintptr_t)key];
+            if ( posting == nil ) {
+                posting = NSMutableIndexSet.indexSet;
+                [self.postings setObject:posting forKey:(__bridge id)(void*)(uintptr_t)key];
+            }
+
+            [posting addIndex:entry.nodeId];
+        }
+    }
+
+    free(buffer.keys);
+
+    if ( entry.dereferenceable ) {
+        [self.dereferenceableIds addIndex:entry.nodeId];
+    }
+}
+
+- (void)removeNodeInternal:(Node*)node {
+    DatabaseSearchIndexEntry* entry = [self.entries objectForKey:node];
+    if ( entry == nil ) {
+        return;
+    }
+
+    self.nodesById[entry.nodeId] = NSNull.null;
+    [self.dereferenceableIds removeIndex:entry.nodeId];
+    [self.entries removeObjectForKey:node];
+
+    self.tombstones++;
+}
+
+- (void)compact {
+    NSArray* live = [self.nodesById filteredArrayUsingPredicate:[NSPredicate predicateWithBlock:^BOOL(id  _Nullable obj, NSDictionary<NSString *,id> * _Nullable bindings) {
+        return obj != NSNull.null;
+    }]];
+
+    [self.entries removeAllObjects];
+    [self.nodesById removeAllObjects];
+    [self.postings removeAllObjects];
+    [self.dereferenceableIds removeAllIndexes];
+    self.tombstones = 0;
+
+    for ( Node* node in live ) {
+        [self addNodeInternal:node];
+    }
+}
+
+
+
+- (void)collectGrams:(Node*)node entry:(DatabaseSearchIndexEntry*)entry buffer:(GramBuffer*)buffer {
+    NodeFields* fields = node.fields;
+    MutableOrderedDictionary<NSString*, StringValue*>* customFields = fields.customFields;
+
+    [self addText:node.title scope:kSearchScopeTitle dereferenceable:YES fields:fields entry:entry buffer:buffer];
+    [self addText:fields.username scope:kSearchScopeUsername dereferenceable:YES fields:fields entry:entry buffer:buffer];
+    [self addText:fields.password scope:kSearchScopePassword dereferenceable:YES fields:fields entry:entry buffer:buffer];
+    [self addText:customFields[kCanonicalEmailFieldName].value scope:kSearchScopeAll dereferenceable:YES fields:fields entry:entry buffer:buffer];
+    [self addText:fields.url scope:kSearchScopeUrl dereferenceable:YES fields:fields entry:entry buffer:buffer];
+
+    for ( NSString* altUrl in fields.alternativeUrls ) {
+        [self addText:altUrl scope:kSearchScopeUrl dereferenceable:YES fields:fields entry:entry buffer:buffer];
+    }
+
+    [self addText:fields.notes scope:kSearchScopeAll dereferenceable:YES fields:fields entry:entry buffer:buffer];
+
+    for ( NSString* tag in fields.tags ) {
+        [self addText:tag scope:kSearchScopeTags dereferenceable:NO fields:fields entry:entry buffer:buffer];
+    }
+
+    if ( self.format == kKeePass4 || self.format == kKeePass ) {
+        for ( NSString* key in customFields.allKeys ) {
+            [self addText:key scope:kSearchScopeAll dereferenceable:NO fields:fields entry:entry buffer:buffer];
+            [self addText:customFields[key].value scope:kSearchScopeAll dereferenceable:YES fields:fields entry:entry buffer:buffer];
+        }
+    }
+
+    if ( self.format != kPasswordSafe ) {
+        for ( NSString* filename in fields.attachments.allKeys ) {
+            [self addText:filename scope:kSearchScopeAll dereferenceable:NO fields:fields entry:entry buffer:buffer];
+        }
+    }
+}
+
+- (void)addText:(NSString*)text
+          scope:(SearchScope)scope
+dereferenceable:(BOOL)dereferenceable
+         fields:(NodeFields*)fields
+          entry:(DatabaseSearchIndexEntry*)entry
+         buffer:(GramBuffer*)buffer {
+    if ( text.length == 0 ) {
+        return;
+    }
+
+    if ( dereferenceable && self.format != kPasswordSafe && !entry.dereferenceable && [text rangeOfString:@"{"].location != NSNotFound ) {
+        entry.dereferenceable = YES;
+    }
+
+    [self addGrams:text scope:scope buffer:buffer];
+
+    NSString* pinYin = [fields pinYinForText:text];
+    if ( pinYin ) {
+        [self addGrams:pinYin scope:scope buffer:buffer];
+    }
+}
+
+- (void)addGrams:(NSString*)text scope:(SearchScope)scope buffer:(GramBuffer*)buffer {
+    NSString* normalized = [DatabaseSearchIndex normalize:text];
+    NSUInteger length = normalized.length;
+
+    unichar stackChars[256];
+    unichar* chars = length <= 256 ? stackChars : malloc(length * sizeof(unichar));
+    [normalized getCharacters:chars range:NSMakeRange(0, length)];
+
+    for ( NSUInteger i = 0; i < length; i++ ) {
+        NSUInteger maxLen = MIN(kMaxGramLength, length - i);
+
+        for ( NSUInteger len = 1; len <= maxLen; len++ ) {
+            if ( scope != kSearchScopeAll ) {
+                gramBufferAppend(buffer, gramKey(scope, chars + i, len));
+            }
+
+            gramBufferAppend(buffer, gramKey(kSearchScopeAll, chars + i, len));
+        }
+    }
+
+    if ( chars != stackChars ) {
+        free(chars);
+    }
+}
+
+
+
+- (NSSet<Node *> *)candidatesForTerm:(NSString *)term
+                               scope:(SearchScope)scope
+                         dereference:(BOOL)dereference {
+    SearchScope effectiveScope = (scope >= kSearchScopeTitle && scope <= kSearchScopeTags) ? scope : kSearchScopeAll;
+
+    NSString* normalized = [DatabaseSearchIndex normalize:term];
+    NSUInteger length = normalized.length;
+
+    if ( length == 0 ) {
+        return NSSet.set;
+    }
+
+    unichar* chars = malloc(length * sizeof(unichar));
+    [normalized getCharacters:chars range:NSMakeRange(0, length)];
+
+    @synchronized (self) {
+        NSMutableArray<NSIndexSet*>* lists = NSMutableArray.array;
+        BOOL emptyPosting = NO;
+
+        NSUInteger gramLength = MIN(kMaxGramLength, length);
+
+        for ( NSUInteger i = 0; i + gramLength <= length; i++ ) {
+            uint64_t key = gramKey(effectiveScope, chars + i, gramLength);
+            NSIndexSet* posting = [self.postings objectForKey:(__bridge id)(void*)(uintptr_t)key];
+
+            if ( posting == nil ) {
+                emptyPosting = YES;
+                break;
+            }
+
+            [lists addObject:posting];
+        }
+
+        free(chars);
+
+        NSMutableIndexSet* ids = emptyPosting ? NSMutableIndexSet.indexSet : [self intersect:lists];
+
+        if ( dereference ) {
+            [ids addIndexes:self.dereferenceableIds];
+        }
+
+        NSMutableSet<Node*>* ret = [NSMutableSet setWithCapacity:ids.count];
+        NSArray* nodesById = self.nodesById;
+
+        [ids enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL * _Nonnull stop) {
+            id node = nodesById[idx];
+            if ( node != NSNull.null ) {
+                [ret addObject:node];
+            }
+        }];
+
+        return ret;
+    }
+}
+
+- (NSMutableIndexSet*)intersect:(NSArray<NSIndexSet*>*)lists {
+    NSArray<NSIndexSet*>* sorted = [lists sortedArrayUsingComparator:^NSComparisonResult(NSIndexSet*  _Nonnull obj1, NSIndexSet*  _Nonnull obj2) {
+        return obj1.count < obj2.count ? NSOrderedAscending : (obj1.count > obj2.count ? NSOrderedDescending : NSOrderedSame);
+    }];
+
+    NSMutableIndexSet* result = sorted.firstObject.mutableCopy;
+
+    for ( NSUInteger i = 1; i < sorted.count && result.count; i++ ) {
+        NSIndexSet* other = sorted[i];
+
+        NSIndexSet* missing = [result indexesPassingTest:^BOOL(NSUInteger idx, BOOL * _Nonnull stop) {
+            return ![other containsIndex:idx];
+        }];
+
+        [result removeIndexes:missing];
+    }
+
+    return result ? result : NSMutableIndexSet.indexSet;
+}
+
+@end
@@ -0,0 +1,164 @@
+//
+//  DatabaseSearchIndexTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "DatabaseModel.h"
+#import "Node.h"
+#import "NSArray+Extensions.h"
+
+@interface DatabaseSearchIndexTests : XCTestCase
+
+@end
+
+@implementation DatabaseSearchIndexTests
+
+- (DatabaseModel*)createDatabase {
+    DatabaseModel* database = [[DatabaseModel alloc] initWithFormat:kKeePass4];
+    Node* root = database.effectiveRootGroup;
+
+    NSArray<NSArray<NSString*>*>* records = @[
+        @[@"Café Crème", @"josé", @"https://café.example.com", @"Résumé notes"],
+        @[@"CAFE CREME", @"JOSE", @"https://cafe.example.com", @"resume NOTES"],
+        @[@"Ｗｉｄｅ Title", @"ｕｓｅｒ", @"", @"fullwidth"],
+        @[@"Straße", @"Müller", @"https://strasse.example.de", @"Übung"],
+        @[@"naïve", @"Zoë", @"", @"coöperate"],
+        @[@"Bank", @"bob", @"https://bank.example.com", @"pin 1234"],
+    ];
+
+    NSMutableArray<Node*>* nodes = NSMutableArray.array;
+
+    for ( NSArray<NSString*>* record in records ) {
+        Node* node = [[Node alloc] initAsRecord:record[0] parent:root];
+        node.fields.username = record[1];
+        node.fields.url = record[2];
+        node.fields.notes = record[3];
+        [node.fields.tags addObject:[record[0] stringByAppendingString:@"-Tag"]];
+        [nodes addObject:node];
+    }
+
+    [database addChildren:nodes destination:root];
+
+    return database;
+}
+
+- (NSArray<Node*>*)linearSearch:(DatabaseModel*)database text:(NSString*)text scope:(SearchScope)scope {
+    return [self search:database text:text scope:scope nodes:database.allSearchableIncludingRecycled];
+}
+
+- (NSArray<Node*>*)indexedSearch:(DatabaseModel*)database text:(NSString*)text scope:(SearchScope)scope {
+    NSArray<NSString*>* terms = [database getSearchTerms:text];
+    NSSet<Node*>* candidates = [database getSearchCandidates:terms scope:scope dereference:NO];
+    NSArray<Node*>* nodes = candidates ? [database searchableIncludingRecycledFromCandidates:candidates trueRoot:NO] : database.allSearchableIncludingRecycled;
+
+    return [self search:database text:text scope:scope nodes:nodes];
+}
+
+- (NSArray<Node*>*)search:(DatabaseModel*)database text:(NSString*)text scope:(SearchScope)scope nodes:(NSArray<Node*>*)nodes {
+    NSArray<NSString*>* terms = [database getSearchTerms:text];
+
+    return [nodes filter:^BOOL(Node * _Nonnull node) {
+        for ( NSString* term in terms ) {
+            if ( ![self isMatch:database term:term node:node scope:scope] ) {
+                return NO;
+            }
+        }
+
+        return YES;
+    }];
+}
+
+- (BOOL)isMatch:(DatabaseModel*)database term:(NSString*)term node:(Node*)node scope:(SearchScope)scope {
+    switch ( scope ) {
+        case kSearchScopeTitle:
+            return [database isTitleMatches:term node:node dereference:NO checkPinYin:NO];
+        case kSearchScopeUsername:
+            return [database isUsernameMatches:term node:node dereference:NO checkPinYin:NO];
+        case kSearchScopeUrl:
+            return [database isUrlMatches:term node:node dereference:NO checkPinYin:NO];
+        case kSearchScopeTags:
+            return [database isTagsMatches:term node:node checkPinYin:NO];
+        default:
+            return [database isAllFieldsMatches:term node:node dereference:NO checkPinYin:NO];
+    }
+}
+
+- (void)assertIndexedMatchesLinear:(DatabaseModel*)database {
+    [self assertIndexedMatchesLinear:database queries:@[@"cafe", @"CAFÉ", @"crème", @"Creme", @"jose", @"JOSÉ", @"wide", @"ＵＳＥＲ",
+                                                        @"strasse", @"straße", @"muller", @"MÜLLER", @"naive", @"zoe", @"cooperate",
+                                                        @"resume notes", @"ba", @"b", @"tag", @"example com", @"nothing-here", @"1234"]];
+}
+
+- (void)assertIndexedMatchesLinear:(DatabaseModel*)database queries:(NSArray<NSString*>*)queries {
+    NSArray<NSNumber*>* scopes = @[@(kSearchScopeTitle), @(kSearchScopeUsername), @(kSearchScopeUrl), @(kSearchScopeTags), @(kSearchScopeAll)];
+
+    for ( NSString* query in queries ) {
+        for ( NSNumber* scope in scopes ) {
+            NSArray* linear = [self linearSearch:database text:query scope:scope.integerValue];
+            NSArray* indexed = [self indexedSearch:database text:query scope:scope.integerValue];
+
+            XCTAssertEqualObjects(indexed, linear, @"Query [%@] scope [%@]", query, scope);
+        }
+    }
+}
+
+- (void)testIndexedSearchMatchesLinearScan {
+    DatabaseModel* database = [self createDatabase];
+
+    [self assertIndexedMatchesLinear:database];
+
+    XCTAssertEqual([self linearSearch:database text:@"cafe" scope:kSearchScopeTitle].count, 2);
+    XCTAssertEqual([self linearSearch:database text:@"JOSÉ" scope:kSearchScopeUsername].count, 2);
+}
+
+- (void)testIndexedSearchMatchesLinearScanForCollationEquivalents {
+    DatabaseModel* database = [[DatabaseModel alloc] initWithFormat:kKeePass4];
+    Node* root = database.effectiveRootGroup;
+
+    NSArray<NSString*>* titles = @[@"Straße", @"STRASSE", @"Fußball", @"Encyclopædia", @"Cœur", @"ﬁnance", @"Pass\u00ADword", @"Ｆｕｌｌ", @"plain"];
+    NSMutableArray<Node*>* nodes = NSMutableArray.array;
+
+    for ( NSString* title in titles ) {
+        Node* node = [[Node alloc] initAsRecord:title parent:root];
+        node.fields.notes = [@"Notes " stringByAppendingString:title];
+        [nodes addObject:node];
+    }
+
+    [database addChildren:nodes destination:root];
+
+    NSArray<NSString*>* queries = @[@"strasse", @"straße", @"STRAẞE", @"sse", @"ße", @"fussball", @"fußball", @"encyclopaedia", @"encyclopædia",
+                                    @"ædia", @"coeur", @"cœur", @"finance", @"ﬁ", @"password", @"full", @"ＦＵＬＬ", @"plain"];
+
+    [self assertIndexedMatchesLinear:database queries:queries];
+
+    XCTAssertEqual([self linearSearch:database text:@"straße" scope:kSearchScopeTitle].count, 2);
+}
+
+- (void)testIndexedSearchSeesFieldEditsWithoutExplicitRefresh {
+    DatabaseModel* database = [self createDatabase];
+
+    [self assertIndexedMatchesLinear:database];
+
+    Node* bank = [database.allSearchableEntries firstOrDefault:^BOOL(Node * _Nonnull obj) {
+        return [obj.title isEqualToString:@"Bank"];
+    }];
+    XCTAssertNotNil(bank);
+
+    bank.fields.notes = @"Ärger und Café";
+    bank.fields.username = @"ÉLODIE";
+    [bank setTitle:@"Crédit" keePassGroupTitleRules:YES];
+    XCTAssertTrue([database addTag:bank.uuid tag:@"Naïve-Tag"]);
+
+    [self assertIndexedMatchesLinear:database];
+
+    XCTAssertTrue([[self indexedSearch:database text:@"elodie" scope:kSearchScopeUsername] containsObject:bank]);
+    XCTAssertTrue([[self indexedSearch:database text:@"credit" scope:kSearchScopeTitle] containsObject:bank]);
+    XCTAssertTrue([[self indexedSearch:database text:@"arger cafe" scope:kSearchScopeAll] containsObject:bank]);
+    XCTAssertFalse([[self indexedSearch:database text:@"bank" scope:kSearchScopeTitle] containsObject:bank]);
+}
+
+@end
@@ -7,36 +7,35 @@
 //
 
 #import <Foundation/Foundation.h>
-#import "ConcurrentMutableDictionary.h"
-#import "ConcurrentMutableDictionary.h"
 #import "Node.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
 @interface FastMaps : NSObject
 
-- (instancetype)init NS_UNAVAILABLE;
+- (instancetype)init;
 
-- (instancetype)initWithUuidMap:(NSDictionary<NSUUID*, Node*>*)uuidMap
-                withExpiryDates:(NSSet<NSUUID*>*)withExpiryDates
-                withAttachments:(NSSet<NSUUID*>*)withAttachments
-                      withTotps:(NSSet<NSUUID*>*)withTotps
-                         tagMap:(NSDictionary<NSString*, NSSet<NSUUID*>*>* )tagMap
-                    usernameSet:(NSCountedSet<NSString*> *)usernameSet
-                       emailSet:(NSCountedSet<NSString*> *)emailSet
-                         urlSet:(NSCountedSet<NSString*> *)urlSet
-              customFieldKeySet:(NSCountedSet<NSString*> *)customFieldKeySet;
-
-@property (readonly) NSDictionary<NSUUID*, Node*>* uuidMap;
 @property (readonly) NSSet<NSUUID*> *withExpiryDates;
 @property (readonly) NSSet<NSUUID*> *withAttachments;
 @property (readonly) NSSet<NSUUID*> *withTotps;
-@property (readonly) NSDictionary<NSString*, NSSet<NSUUID*>*>* tagMap;
+@property (readonly) NSDictionary<NSString*, NSNumber*>* tagCounts;
 @property (readonly) NSCountedSet<NSString*> *usernameSet;
 @property (readonly) NSCountedSet<NSString*> *emailSet;
 @property (readonly) NSCountedSet<NSString*> *urlSet;
 @property (readonly) NSCountedSet<NSString*> *customFieldKeySet;
 
+- (Node*_Nullable)nodeWithUuid:(NSUUID*)uuid;
+- (NSSet<NSUUID*>*_Nullable)idsForTag:(NSString*)tag;
+
+- (BOOL)containsNode:(Node*)node;
+
+
+
+- (void)addNode:(Node*)node indexed:(BOOL)indexed;
+- (void)addNodes:(NSArray<Node*>*)nodes indexed:(BOOL (^)(Node* node))indexed;
+- (void)removeNode:(Node*)node;
+- (void)updateNode:(Node*)node indexed:(BOOL)indexed;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -7,34 +7,376 @@
 //
 
 #import "FastMaps.h"
+#import "Utils.h"
+
+static NSString* const kSnapshotWithExpiryDates = @"withExpiryDates";
+static NSString* const kSnapshotWithAttachments = @"withAttachments";
+static NSString* const kSnapshotWithTotps = @"withTotps";
+static NSString* const kSnapshotTagCounts = @"tagCounts";
+static NSString* const kSnapshotUsernames = @"usernames";
+static NSString* const kSnapshotEmails = @"emails";
+static NSString* const kSnapshotUrls = @"urls";
+static NSString* const kSnapshotCustomFieldKeys = @"customFieldKeys";
+
+@interface FastMapsNodeEntry : NSObject
+
+@property BOOL indexed;
+@property BOOL hasExpiry;
+@property BOOL hasAttachments;
+@property BOOL hasTotp;
+@property (nullable) NSArray<NSString*>* tags;
+@property (nullable) NSString* username;
+@property (nullable) NSString* email;
+@property (nullable) NSString* url;
+@property (nullable) NSArray<NSString*>* customFieldKeys;
+
+@end
+
+@implementation FastMapsNodeEntry
+
+@end
+
+@interface FastMaps ()
+
+@property (strong, nonatomic) dispatch_queue_t dataQueue;
+
+@property (readonly) NSMutableDictionary<NSUUID*, Node*>* mutableUuidMap;
+@property (readonly) NSCountedSet<NSUUID*>* registeredIds;
+@property (readonly) NSMapTable<Node*, FastMapsNodeEntry*>* entries;
+
+@property (readonly) NSCountedSet<NSUUID*>* mutableWithExpiryDates;
+@property (readonly) NSCountedSet<NSUUID*>* mutableWithAttachments;
+@property (readonly) NSCountedSet<NSUUID*>* mutableWithTotps;
+@property (readonly) NSMutableDictionary<NSString*, NSCountedSet<NSUUID*>*>* mutableTagMap;
+@property (readonly) NSCountedSet<NSString*> *mutableUsernameSet;
+@property (readonly) NSCountedSet<NSString*> *mutableEmailSet;
+@property (readonly) NSCountedSet<NSString*> *mutableUrlSet;
+@property (readonly) NSCountedSet<NSString*> *mutableCustomFieldKeySet;
+
+@property (readonly) NSMutableDictionary<NSString*, id>* snapshots;
+
+@end
 
 @implementation FastMaps
 
-- (instancetype)initWithUuidMap:(NSDictionary<NSUUID *,Node *> *)uuidMap
-                withExpiryDates:(NSSet<NSUUID *> *)withExpiryDates
-                withAttachments:(NSSet<NSUUID *> *)withAttachments
-                      withTotps:(NSSet<NSUUID *> *)withTotps
-                         tagMap:(NSDictionary<NSString *,NSSet<NSUUID *> *> *)tagMap
-                    usernameSet:(NSCountedSet<NSString *> *)usernameSet
-                       emailSet:(NSCountedSet<NSString *> *)emailSet
-                         urlSet:(NSCountedSet<NSString *> *)urlSet
-              customFieldKeySet:(NSCountedSet<NSString *> *)customFieldKeySet {
+- (instancetype)init {
     if (self = [super init]) {
-        _uuidMap = [uuidMap copy];
-        _withExpiryDates = [withExpiryDates copy];
-        _withAttachments = [withAttachments copy];
-        _withTotps = [withTotps copy];
-        _tagMap = [tagMap copy];
+        _dataQueue = dispatch_queue_create("FastMaps", DISPATCH_QUEUE_CONCURRENT);
+
+        _mutableUuidMap = NSMutableDictionary.dictionary;
+        _registeredIds = NSCountedSet.set;
+        _entries = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                         valueOptions:NSPointerFunctionsStrongMemory];
+
+        _mutableWithExpiryDates = NSCountedSet.set;
+        _mutableWithAttachments = NSCountedSet.set;
+        _mutableWithTotps = NSCountedSet.set;
+        _mutableTagMap = NSMutableDictionary.dictionary;
+        _mutableUsernameSet = NSCountedSet.set;
+        _mutableEmailSet = NSCountedSet.set;
+        _mutableUrlSet = NSCountedSet.set;
+        _mutableCustomFieldKeySet = NSCountedSet.set;
         
+        _snapshots = NSMutableDictionary.dictionary;
+    }
+
+    return self;
+}
+
+
+
+- (NSSet<NSUUID *> *)withExpiryDates {
+    return [self snapshotForKey:kSnapshotWithExpiryDates build:^id{
+        return [NSSet setWithSet:self.mutableWithExpiryDates];
+    }];
+}
+
+- (NSSet<NSUUID *> *)withAttachments {
+    return [self snapshotForKey:kSnapshotWithAttachments build:^id{
+        return [NSSet setWithSet:self.mutableWithAttachments];
+    }];
+}
+
+- (NSSet<NSUUID *> *)withTotps {
+    return [self snapshotForKey:kSnapshotWithTotps build:^id{
+        return [NSSet setWithSet:self.mutableWithTotps];
+    }];
+}
+
+- (NSDictionary<NSString *,NSNumber *> *)tagCounts {
+    return [self snapshotForKey:kSnapshotTagCounts build:^id{
+        NSMutableDictionary* result = [NSMutableDictionary dictionaryWithCapacity:self.mutableTagMap.count];
         
+        for ( NSString* tag in self.mutableTagMap ) {
+            result[tag] = @(self.mutableTagMap[tag].count);
+        }
         
-        _usernameSet = usernameSet;
-        _emailSet = emailSet;
-        _urlSet = urlSet;
-        _customFieldKeySet = customFieldKeySet;
+        return result.copy;
+    }];
+}
+
+- (NSCountedSet<NSString *> *)usernameSet {
+    return [self snapshotForKey:kSnapshotUsernames build:^id{
+        return self.mutableUsernameSet.copy;
+    }];
+}
+
+- (NSCountedSet<NSString *> *)emailSet {
+    return [self snapshotForKey:kSnapshotEmails build:^id{
+        return self.mutableEmailSet.copy;
+    }];
+}
+
+- (NSCountedSet<NSString *> *)urlSet {
+    return [self snapshotForKey:kSnapshotUrls build:^id{
+        return self.mutableUrlSet.copy;
+    }];
+}
+
+- (NSCountedSet<NSString *> *)customFieldKeySet {
+    return [self snapshotForKey:kSnapshotCustomFieldKeys build:^id{
+        return self.mutableCustomFieldKeySet.copy;
+    }];
+}
+
+- (id)snapshotForKey:(NSString*)key build:(id (^)(void))build {
+    __block id result;
+    dispatch_sync(self.dataQueue, ^{ result = self.snapshots[key]; });
+    
+    if ( result == nil ) {
+        dispatch_barrier_sync(self.dataQueue, ^{
+            result = self.snapshots[key];
+            
+            if ( result == nil ) {
+                result = build();
+                self.snapshots[key] = result;
+            }
+        });
     }
     
-    return self;
+    return result;
+}
+
+- (Node *)nodeWithUuid:(NSUUID *)uuid {
+    __block Node* result;
+    dispatch_sync(self.dataQueue, ^{ result = self.mutableUuidMap[uuid]; });
+    return result;
+}
+
+- (NSSet<NSUUID *> *)idsForTag:(NSString *)tag {
+    __block NSSet* result;
+
+    dispatch_sync(self.dataQueue, ^{
+        NSCountedSet* set = self.mutableTagMap[tag];
+        result = set ? [NSSet setWithSet:set] : nil;
+    });
+
+    return result;
+}
+
+- (BOOL)containsNode:(Node *)node {
+    __block BOOL result;
+    dispatch_sync(self.dataQueue, ^{ result = [self.entries objectForKey:node] != nil; });
+    return result;
+}
+
+
+
+- (void)addNode:(Node *)node indexed:(BOOL)indexed {
+    dispatch_barrier_sync(self.dataQueue, ^{
+        if ( [self.entries objectForKey:node] != nil ) {
+            NSLog(@"🔴 WARNWARN: FastMaps - Node already registered [%@]", node);
+            return;
+        }
+
+        Node* existing = self.mutableUuidMap[node.uuid];
+        if ( existing ) {
+            NSLog(@"🔴 WARNWARN: Duplicate ID in database => [%@] - [%@] - [%@]", existing, node, node.uuid);
+        }
+        else {
+            self.mutableUuidMap[node.uuid] = node;
+        }
+
+        [self.registeredIds addObject:node.uuid];
+
+        FastMapsNodeEntry* entry = [self entryForNode:node indexed:indexed];
+        [self.entries setObject:entry forKey:node];
+        [self applyEntry:entry uuid:node.uuid add:YES];
+    });
+}
+
+- (void)addNodes:(NSArray<Node *> *)nodes indexed:(BOOL (^)(Node * _Nonnull))indexed {
+    static FastMapsNodeEntry* unindexedEntry;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        unindexedEntry = [[FastMapsNodeEntry alloc] init];
+    });
+    
+    dispatch_barrier_sync(self.dataQueue, ^{
+        if ( self.entries.count == 0 ) {
+            self->_mutableUuidMap = [NSMutableDictionary dictionaryWithCapacity:nodes.count];
+        }
+        
+        for ( Node* node in nodes ) {
+            if ( [self.entries objectForKey:node] != nil ) {
+                NSLog(@"🔴 WARNWARN: FastMaps - Node already registered [%@]", node);
+                continue;
+            }
+            
+            Node* existing = self.mutableUuidMap[node.uuid];
+            if ( existing ) {
+                NSLog(@"🔴 WARNWARN: Duplicate ID in database => [%@] - [%@] - [%@]", existing, node, node.uuid);
+            }
+            else {
+                self.mutableUuidMap[node.uuid] = node;
+            }
+            
+            [self.registeredIds addObject:node.uuid];
+            
+            if ( !indexed(node) ) {
+                [self.entries setObject:unindexedEntry forKey:node];
+                continue;
+            }
+            
+            FastMapsNodeEntry* entry = [self entryForNode:node indexed:YES];
+            [self.entries setObject:entry forKey:node];
+            [self applyEntry:entry uuid:node.uuid add:YES];
+        }
+    });
+}
+
+- (void)removeNode:(Node *)node {
+    dispatch_barrier_sync(self.dataQueue, ^{
+        FastMapsNodeEntry* entry = [self.entries objectForKey:node];
+        if ( entry == nil ) {
+            return;
+        }
+
+        [self applyEntry:entry uuid:node.uuid add:NO];
+        [self.entries removeObjectForKey:node];
+        [self.registeredIds removeObject:node.uuid];
+
+        if ( self.mutableUuidMap[node.uuid] == node ) {
+            [self.mutableUuidMap removeObjectForKey:node.uuid];
+
+            if ( [self.registeredIds countForObject:node.uuid] > 0 ) {
+                for ( Node* other in self.entries.keyEnumerator ) {
+                    if ( [other.uuid isEqual:node.uuid] ) {
+                        self.mutableUuidMap[node.uuid] = other;
+                        break;
+                    }
+                }
+            }
+        }
+    });
+}
+
+- (void)updateNode:(Node *)node indexed:(BOOL)indexed {
+    dispatch_barrier_sync(self.dataQueue, ^{
+        FastMapsNodeEntry* old = [self.entries objectForKey:node];
+        if ( old == nil ) {
+            NSLog(@"🔴 WARNWARN: FastMaps - Attempt to update unregistered node [%@]", node);
+            return;
+        }
+
+        FastMapsNodeEntry* entry = [self entryForNode:node indexed:indexed];
+
+        [self applyEntry:old uuid:node.uuid add:NO];
+        [self applyEntry:entry uuid:node.uuid add:YES];
+
+        [self.entries setObject:entry forKey:node];
+    });
+}
+
+- (FastMapsNodeEntry*)entryForNode:(Node*)node indexed:(BOOL)indexed {
+    FastMapsNodeEntry* entry = [[FastMapsNodeEntry alloc] init];
+
+    entry.indexed = indexed;
+
+    if ( !indexed ) {
+        return entry;
+    }
+
+    entry.hasExpiry = node.fields.expires != nil;
+    entry.hasAttachments = node.fields.attachments.count > 0;
+    entry.hasTotp = node.fields.otpToken != nil;
+    entry.tags = node.fields.tags.allObjects;
+    entry.customFieldKeys = node.fields.customFields.allKeys;
+
+    NSString* username = [Utils trim:node.fields.username];
+    entry.username = username.length ? username : nil;
+
+    NSString* email = [Utils trim:node.fields.email];
+    entry.email = email.length ? email : nil;
+
+    NSString* url = [Utils trim:node.fields.url];
+    entry.url = url.length ? url : nil;
+
+    return entry;
+}
+
+- (void)applyEntry:(FastMapsNodeEntry*)entry uuid:(NSUUID*)uuid add:(BOOL)add {
+    if ( !entry.indexed ) {
+        return;
+    }
+
+    if ( entry.hasExpiry ) {
+        [self applyTo:self.mutableWithExpiryDates object:uuid add:add snapshot:kSnapshotWithExpiryDates];
+    }
+
+    if ( entry.hasAttachments ) {
+        [self applyTo:self.mutableWithAttachments object:uuid add:add snapshot:kSnapshotWithAttachments];
+    }
+
+    if ( entry.hasTotp ) {
+        [self applyTo:self.mutableWithTotps object:uuid add:add snapshot:kSnapshotWithTotps];
+    }
+
+    for ( NSString* tag in entry.tags ) {
+        NSCountedSet<NSUUID*>* set = self.mutableTagMap[tag];
+
+        if ( set == nil ) {
+            if ( !add ) {
+                continue;
+            }
+
+            set = NSCountedSet.set;
+            self.mutableTagMap[tag] = set;
+        }
+
+        [self applyTo:set object:uuid add:add snapshot:kSnapshotTagCounts];
+
+        if ( set.count == 0 ) {
+            [self.mutableTagMap removeObjectForKey:tag];
+        }
+    }
+
+    if ( entry.username ) {
+        [self applyTo:self.mutableUsernameSet object:entry.username add:add snapshot:kSnapshotUsernames];
+    }
+
+    if ( entry.email ) {
+        [self applyTo:self.mutableEmailSet object:entry.email add:add snapshot:kSnapshotEmails];
+    }
+
+    for ( NSString* key in entry.customFieldKeys ) {
+        [self applyTo:self.mutableCustomFieldKeySet object:key add:add snapshot:kSnapshotCustomFieldKeys];
+    }
+
+    if ( entry.url ) {
+        [self applyTo:self.mutableUrlSet object:entry.url add:add snapshot:kSnapshotUrls];
+    }
+}
+
+- (void)applyTo:(NSCountedSet*)set object:(id)object add:(BOOL)add snapshot:(NSString*)snapshotKey {
+    [self.snapshots removeObjectForKey:snapshotKey];
+    
+    if ( add ) {
+        [set addObject:object];
+    }
+    else {
+        [set removeObject:object];
+    }
 }
 
 @end
@@ -0,0 +1,150 @@
+//
+//  FastMapsTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "DatabaseModel.h"
+#import "DatabaseAttachment.h"
+#import "StringValue.h"
+#import "NSArray+Extensions.h"
+
+static const NSUInteger kEntriesPerGroup = 12;
+
+@interface FastMapsTests : XCTestCase
+
+@end
+
+@implementation FastMapsTests
+
+- (Node*)addGroup:(NSString*)title parent:(Node*)parent database:(DatabaseModel*)database {
+    Node* group = [[Node alloc] initAsGroup:title parent:parent keePassGroupTitleRules:YES uuid:nil];
+    XCTAssertTrue([database addChildren:@[group] destination:parent]);
+    return group;
+}
+
+- (void)addEntries:(Node*)parent database:(DatabaseModel*)database {
+    NSMutableArray<Node*>* entries = NSMutableArray.array;
+    NSDate* past = [NSDate dateWithTimeIntervalSinceNow:-86400];
+
+    for ( NSUInteger i = 0; i < kEntriesPerGroup; i++ ) {
+        Node* entry = [[Node alloc] initAsRecord:[NSString stringWithFormat:@"%@ %lu", parent.title, (unsigned long)i] parent:parent];
+
+        entry.fields.username = [NSString stringWithFormat:@"user%lu", (unsigned long)(i % 3)];
+        entry.fields.email = (i % 2) ? [NSString stringWithFormat:@"%@@example.com", parent.title.lowercaseString] : @"";
+        entry.fields.url = [NSString stringWithFormat:@"https://site%lu.example.com", (unsigned long)(i % 4)];
+        entry.fields.tags = [NSMutableSet setWithArray:@[[NSString stringWithFormat:@"tag-%lu", (unsigned long)(i % 4)], parent.title]];
+        entry.fields.expires = (i % 5) == 0 ? past : nil;
+
+        [entry.fields setCustomField:[NSString stringWithFormat:@"Key %lu", (unsigned long)(i % 2)] value:[StringValue valueWithString:@"Value"]];
+
+        if ( i % 3 == 0 ) {
+            NSData* data = [[NSString stringWithFormat:@"attachment %lu", (unsigned long)i] dataUsingEncoding:NSUTF8StringEncoding];
+            entry.fields.attachments[@"file.txt"] = [[DatabaseAttachment alloc] initNonPerformantWithData:data compressed:YES protectedInMemory:YES];
+        }
+
+        [entries addObject:entry];
+    }
+
+    XCTAssertTrue([database addChildren:entries destination:parent]);
+}
+
+- (NSSet<NSUUID*>*)idsOf:(NSArray<Node*>*)nodes {
+    return [NSSet setWithArray:[nodes map:^id _Nonnull(Node * _Nonnull obj, NSUInteger idx) {
+        return obj.uuid;
+    }]];
+}
+
+- (void)assertMatchesFullRebuild:(DatabaseModel*)database {
+    DatabaseModel* rebuilt = [database clone];
+
+    XCTAssertEqualObjects(database.usernameSet, rebuilt.usernameSet);
+    XCTAssertEqualObjects(database.emailSet, rebuilt.emailSet);
+    XCTAssertEqualObjects(database.urlSet, rebuilt.urlSet);
+    XCTAssertEqualObjects(database.customFieldKeySet, rebuilt.customFieldKeySet);
+    XCTAssertEqualObjects(database.tagSet, rebuilt.tagSet);
+    XCTAssertEqualObjects(database.mostPopularUsername, rebuilt.mostPopularUsername);
+
+    for ( NSString* tag in rebuilt.tagSet ) {
+        XCTAssertEqualObjects([NSSet setWithArray:[database getItemIdsForTag:tag]], [NSSet setWithArray:[rebuilt getItemIdsForTag:tag]], @"%@", tag);
+    }
+
+    XCTAssertEqualObjects([self idsOf:database.expiredEntries], [self idsOf:rebuilt.expiredEntries]);
+    XCTAssertEqualObjects([self idsOf:database.attachmentEntries], [self idsOf:rebuilt.attachmentEntries]);
+    XCTAssertEqualObjects([self idsOf:database.totpEntries], [self idsOf:rebuilt.totpEntries]);
+
+    for ( Node* node in rebuilt.rootNode.allChildren ) {
+        XCTAssertEqualObjects([database getItemById:node.uuid].uuid, node.uuid);
+    }
+}
+
+- (void)testIncrementalUpdatesMatchFullRebuild {
+    DatabaseModel* database = [[DatabaseModel alloc] initWithFormat:kKeePass4];
+    database.meta.recycleBinEnabled = YES;
+
+    Node* root = database.effectiveRootGroup;
+    Node* work = [self addGroup:@"Work" parent:root database:database];
+    Node* home = [self addGroup:@"Home" parent:root database:database];
+    Node* hidden = [self addGroup:@"Hidden" parent:root database:database];
+
+    [self addEntries:work database:database];
+    [self addEntries:home database:database];
+    [self addEntries:hidden database:database];
+
+    [self assertMatchesFullRebuild:database];
+
+    Node* first = work.childRecords.firstObject;
+    XCTAssertTrue([database setItemTitle:first title:@"Renamed"]);
+    XCTAssertTrue([database addTag:first.uuid tag:@"Added"]);
+    XCTAssertTrue([database removeTag:first.uuid tag:@"Work"]);
+
+    [self assertMatchesFullRebuild:database];
+
+    hidden.fields.enableSearching = @NO;
+    [database refreshFastMapsForItems:hidden.allChildren];
+
+    [self assertMatchesFullRebuild:database];
+
+    XCTAssertTrue([database moveItems:@[home.childRecords.firstObject, home.childRecords.lastObject] destination:work]);
+    XCTAssertTrue([database recycleItems:@[work.childRecords[1]]]);
+    [database deleteItems:@[home.childRecords.firstObject]];
+
+    [self assertMatchesFullRebuild:database];
+
+    NSArray<NodeHierarchyReconstructionData*>* undoData;
+    XCTAssertTrue([database recycleItems:@[home] undoData:&undoData]);
+    [self assertMatchesFullRebuild:database];
+
+    [database undoRecycle:undoData];
+    [self assertMatchesFullRebuild:database];
+}
+
+- (void)testModifiedItemsRefreshTracksEditsRatherThanDates {
+    DatabaseModel* database = [[DatabaseModel alloc] initWithFormat:kKeePass4];
+    Node* work = [self addGroup:@"Work" parent:database.effectiveRootGroup database:database];
+    [self addEntries:work database:database];
+
+    NSArray<Node*>* entries = work.childRecords;
+    NSDate* older = [NSDate dateWithTimeIntervalSinceNow:-7 * 86400];
+
+    entries[0].fields.username = @"untouched-edit";
+
+    entries[1].fields.tags = [NSMutableSet setWithObject:@"Restored"];
+    [entries[1] setModifiedDateExplicit:older setParents:NO];
+
+    entries[5].fields.expires = nil;
+    entries[10].fields.expires = nil;
+
+    [database refreshFastMapsForModifiedItems];
+
+    XCTAssertTrue([database.usernameSet containsObject:@"untouched-edit"]);
+    XCTAssertEqualObjects([database getItemIdsForTag:@"Restored"], @[entries[1].uuid]);
+    XCTAssertEqual(database.expiredEntries.count, 1);
+
+    [self assertMatchesFullRebuild:database];
+}
+
+@end
@@ -0,0 +1,52 @@
+//
+//  HibpRangeCache.h
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef void (^HibpRangeProgressBlock)(NSUInteger completed, NSUInteger total);
+typedef BOOL (^HibpRangeCancelledBlock)(void);
+
+@interface HibpRangeCache : NSObject
+
++ (instancetype)sharedInstance;
+
+- (instancetype)init NS_UNAVAILABLE;
+- (instancetype)initWithDirectory:(NSURL*)directory key:(NSData*)key NS_DESIGNATED_INITIALIZER;
+
+@property NSURL* baseUrl;
+@property NSUInteger maxConcurrentRequests;
+@property NSTimeInterval requestTimeout;
+
++ (NSString*)prefixForSha1Hex:(NSString*)sha1Hex;
+
+- (BOOL)hasRangeForPrefix:(NSString*)prefix maxAge:(NSTimeInterval)maxAge;
+
+
+
+- (NSNumber*_Nullable)isPwned:(NSString*)sha1Hex;
+
+
+
+- (NSUInteger)prefetchPrefixes:(NSSet<NSString*>*)prefixes
+                        maxAge:(NSTimeInterval)maxAge
+                      progress:(HibpRangeProgressBlock _Nullable)progress
+                     cancelled:(HibpRangeCancelledBlock _Nullable)cancelled;
+
+- (void)lookup:(NSString*)sha1Hex
+       offline:(BOOL)offline
+    completion:(void (^)(BOOL pwned, NSError*_Nullable error))completion;
+
+
+
+- (void)clear;
+
+@end
+
+NS_ASSUME_NONNULL_END
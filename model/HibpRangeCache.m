@@ -0,0 +1,456 @@
+//
+//  HibpRangeCache.m
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import "HibpRangeCache.h"
+#import "UrlRequestOperation.h"
+#import "FileManager.h"
+#import "Utils.h"
+#import "SecretStore.h"
+#import "NSData+Extensions.h"
+#import "sodium.h"
+
+static NSString* const kDefaultBaseUrl = @"https://api.pwnedpasswords.com/range/";
+static NSString* const kRangeFileExtension = @"range";
+static NSString* const kSecretStoreHibpRangeCacheKey = @"SecretStoreHibpRangeCacheKey";
+
+static const uint32_t kRangeMagic = 0x52424948;
+static const uint16_t kRangeVersion = 2;
+
+static const NSUInteger kPrefixHexLength = 5;
+static const NSUInteger kSuffixHexLength = 35;
+static const NSUInteger kSha1HexLength = kPrefixHexLength + kSuffixHexLength;
+static const NSUInteger kSuffixKeyLength = 18;
+static const NSUInteger kFileNameHashLength = 16;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;
+    uint32_t count;
+    uint32_t reserved;
+    double fetched;
+} HibpRangeHeader;
+
+static inline int hexValue(char c) {
+    if ( c >= '0' && c <= '9' ) return c - '0';
+    if ( c >= 'A' && c <= 'F' ) return c - 'A' + 10;
+    if ( c >= 'a' && c <= 'f' ) return c - 'a' + 10;
+    return -1;
+}
+
+static BOOL packSuffix(const char* hex, uint8_t* key) {
+    int first = hexValue(hex[0]);
+    if ( first < 0 ) {
+        return NO;
+    }
+
+    key[0] = (uint8_t)first;
+
+    for ( NSUInteger i = 1; i < kSuffixKeyLength; i++ ) {
+        int hi = hexValue(hex[2 * i - 1]);
+        int lo = hexValue(hex[2 * i]);
+
+        if ( hi < 0 || lo < 0 ) {
+            return NO;
+        }
+
+        key[i] = (uint8_t)((hi << 4) | lo);
+    }
+
+    return YES;
+}
+
+static BOOL parseCount(const char* chars, NSUInteger length, unsigned long long* count) {
+    unsigned long long value = 0;
+    NSUInteger digits = 0;
+
+    for ( NSUInteger i = 0; i < length; i++ ) {
+        char c = chars[i];
+
+        if ( c >= '0' && c <= '9' ) {
+            value = value * 10 + (c - '0');
+            digits++;
+        }
+        else if ( c != '\r' && c != ' ' ) {
+            return NO;
+        }
+    }
+
+    *count = value;
+    return digits > 0;
+}
+
+static int compareKeys(const void* a, const void* b) {
+    return memcmp(a, b, kSuffixKeyLength);
+}
+
+static void enumerateLines(const char* bytes, NSUInteger length, void (^block)(const char* line, NSUInteger length)) {
+    NSUInteger start = 0;
+
+    for ( NSUInteger i = 0; i <= length; i++ ) {
+        if ( i == length || bytes[i] == '\n' ) {
+            if ( i > start ) {
+                block(bytes + start, i - start);
+            }
+
+            start = i + 1;
+        }
+    }
+}
+
+static BOOL parseRangeLine(const char* line, NSUInteger length, NSUInteger hashLength, uint8_t* key) {
+    if ( length <= hashLength + 1 || line[hashLength] != ':' ) {
+        return NO;
+    }
+
+    unsigned long long count = 0;
+    if ( !parseCount(line + hashLength + 1, length - hashLength - 1, &count) || count == 0 ) {
+        return NO;
+    }
+
+    return packSuffix(line + (hashLength - kSuffixHexLength), key);
+}
+
+@interface HibpRangeCache ()
+
+@property NSURL* directory;
+@property NSData* key;
+@property NSCache<NSString*, NSData*>* ranges;
+@property NSOperationQueue* lookupQueue;
+
+@end
+
+@implementation HibpRangeCache
+
++ (instancetype)sharedInstance {
+    static HibpRangeCache *sharedInstance = nil;
+    static dispatch_once_t onceToken;
+
+    dispatch_once(&onceToken, ^{
+        sharedInstance = [[HibpRangeCache alloc] initWithDirectory:FileManager.sharedInstance.hibpRangeCacheDirectory key:HibpRangeCache.storedKey];
+    });
+
+    return sharedInstance;
+}
+
++ (NSData*)storedKey {
+    NSData* key = [SecretStore.sharedInstance getSecureObject:kSecretStoreHibpRangeCacheKey];
+    
+    if ( ![key isKindOfClass:NSData.class] || key.length != crypto_secretbox_KEYBYTES ) {
+        NSMutableData* fresh = [NSMutableData dataWithLength:crypto_secretbox_KEYBYTES];
+        randombytes_buf(fresh.mutableBytes, fresh.length);
+        key = fresh.copy;
+        
+        if ( ![SecretStore.sharedInstance setSecureObject:key forIdentifier:kSecretStoreHibpRangeCacheKey] ) {
+            NSLog(@"🔴 WARNWARN: HibpRangeCache - Could not store range cache key. Cached ranges will not survive a restart.");
+        }
+    }
+    
+    return key;
+}
+
+- (instancetype)initWithDirectory:(NSURL *)directory key:(NSData *)key {
+    if ( self = [super init] ) {
+        if ( sodium_init() == -1 ) {
+            NSLog(@"🔴 WARNWARN: HibpRangeCache - Could not initialize libsodium");
+        }
+        
+        _directory = directory;
+        _key = key;
+        _ranges = [[NSCache alloc] init];
+        _ranges.countLimit = 4096;
+
+        _lookupQueue = [NSOperationQueue new];
+        _lookupQueue.maxConcurrentOperationCount = 4;
+
+        _baseUrl = [NSURL URLWithString:kDefaultBaseUrl];
+        _maxConcurrentRequests = 8;
+        _requestTimeout = 5.0f;
+        
+        [self removeLegacyRanges];
+    }
+
+    return self;
+}
+
+- (void)removeLegacyRanges {
+    NSArray<NSURL*>* files = [NSFileManager.defaultManager contentsOfDirectoryAtURL:self.directory includingPropertiesForKeys:nil options:kNilOptions error:nil];
+    
+    for ( NSURL* file in files ) {
+        if ( [file.pathExtension isEqualToString:kRangeFileExtension] && file.URLByDeletingPathExtension.lastPathComponent.length == kPrefixHexLength ) {
+            [NSFileManager.defaultManager removeItemAtURL:file error:nil];
+        }
+    }
+}
+
++ (NSString *)prefixForSha1Hex:(NSString *)sha1Hex {
+    return [sha1Hex substringToIndex:kPrefixHexLength].uppercaseString;
+}
+
+
+
+- (NSURL*)urlForPrefix:(NSString*)prefix {
+    const char* utf8 = prefix.UTF8String;
+    uint8_t hash[kFileNameHashLength];
+    
+    crypto_generichash(hash, sizeof(hash), (const uint8_t*)utf8, strlen(utf8), self.key.bytes, self.key.length);
+    
+    NSString* name = [[NSData dataWithBytes:hash length:sizeof(hash)] hexString];
+    
+    return [[self.directory URLByAppendingPathComponent:name] URLByAppendingPathExtension:kRangeFileExtension];
+}
+
+- (NSData*)rangeForPrefix:(NSString*)prefix {
+    NSData* cached = [self.ranges objectForKey:prefix];
+    if ( cached ) {
+        return cached;
+    }
+
+    NSData* sealed = [NSData dataWithContentsOfURL:[self urlForPrefix:prefix] options:kNilOptions error:nil];
+    if ( !sealed ) {
+        return nil;
+    }
+    
+    if ( sealed.length < crypto_secretbox_NONCEBYTES + crypto_secretbox_MACBYTES ) {
+        NSLog(@"🔴 WARNWARN: HibpRangeCache - Truncated range file for [%@]", prefix);
+        return nil;
+    }
+    
+    const uint8_t* nonce = sealed.bytes;
+    NSMutableData* data = [NSMutableData dataWithLength:sealed.length - crypto_secretbox_NONCEBYTES - crypto_secretbox_MACBYTES];
+    
+    if ( crypto_secretbox_open_easy(data.mutableBytes, nonce + crypto_secretbox_NONCEBYTES, sealed.length - crypto_secretbox_NONCEBYTES, nonce, self.key.bytes) != 0 ) {
+        NSLog(@"🔴 WARNWARN: HibpRangeCache - Could not decrypt range file for [%@]", prefix);
+        return nil;
+    }
+
+    if ( data.length < sizeof(HibpRangeHeader) ) {
+        NSLog(@"🔴 WARNWARN: HibpRangeCache - Truncated range file for [%@]", prefix);
+        return nil;
+    }
+
+    const HibpRangeHeader* header = data.bytes;
+    if ( header->magic != kRangeMagic || header->version != kRangeVersion || data.length != sizeof(HibpRangeHeader) + ((NSUInteger)header->count * kSuffixKeyLength) ) {
+        NSLog(@"🔴 WARNWARN: HibpRangeCache - Invalid range file for [%@]", prefix);
+        return nil;
+    }
+
+    [self.ranges setObject:data forKey:prefix];
+
+    return data;
+}
+
+- (BOOL)writeRange:(NSData*)keys prefix:(NSString*)prefix {
+    HibpRangeHeader header = { 0 };
+
+    header.magic = kRangeMagic;
+    header.version = kRangeVersion;
+    header.count = (uint32_t)(keys.length / kSuffixKeyLength);
+    header.fetched = NSDate.timeIntervalSinceReferenceDate;
+
+    NSMutableData* data = [NSMutableData dataWithBytes:&header length:sizeof(header)];
+    [data appendData:keys];
+
+    NSMutableData* sealed = [NSMutableData dataWithLength:crypto_secretbox_NONCEBYTES + crypto_secretbox_MACBYTES + data.length];
+    uint8_t* nonce = sealed.mutableBytes;
+    
+    randombytes_buf(nonce, crypto_secretbox_NONCEBYTES);
+    crypto_secretbox_easy(nonce + crypto_secretbox_NONCEBYTES, data.bytes, data.length, nonce, self.key.bytes);
+
+    NSError* error;
+    if ( ![sealed writeToURL:[self urlForPrefix:prefix] options:NSDataWritingAtomic error:&error] ) {
+        NSLog(@"🔴 WARNWARN: HibpRangeCache - Could not write range [%@] - [%@]", prefix, error);
+        return NO;
+    }
+
+    [self.ranges setObject:data forKey:prefix];
+
+    return YES;
+}
+
+- (BOOL)hasRangeForPrefix:(NSString *)prefix maxAge:(NSTimeInterval)maxAge {
+    NSData* data = [self rangeForPrefix:prefix.uppercaseString];
+    if ( !data ) {
+        return NO;
+    }
+
+    const HibpRangeHeader* header = data.bytes;
+
+    return (NSDate.timeIntervalSinceReferenceDate - header->fetched) <= maxAge;
+}
+
+- (NSNumber *)isPwned:(NSString *)sha1Hex {
+    if ( sha1Hex.length != kSha1HexLength ) {
+        return nil;
+    }
+
+    NSData* data = [self rangeForPrefix:[HibpRangeCache prefixForSha1Hex:sha1Hex]];
+    if ( !data ) {
+        return nil;
+    }
+
+    uint8_t key[kSuffixKeyLength];
+    if ( !packSuffix([sha1Hex substringFromIndex:kPrefixHexLength].UTF8String, key) ) {
+        return nil;
+    }
+
+    const HibpRangeHeader* header = data.bytes;
+    const uint8_t* keys = ((const uint8_t*)data.bytes) + sizeof(HibpRangeHeader);
+
+    return @(bsearch(key, keys, header->count, kSuffixKeyLength, compareKeys) != NULL);
+}
+
+
+
+- (NSURLRequest*)requestForPrefix:(NSString*)prefix {
+    NSURL* url = [self.baseUrl URLByAppendingPathComponent:prefix];
+
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:url cachePolicy:NSURLRequestReloadIgnoringLocalCacheData timeoutInterval:self.requestTimeout];
+    [request addValue:@"true" forHTTPHeaderField:@"Add-Padding"];
+
+    return request.copy;
+}
+
+- (BOOL)storeResponse:(NSData*)data response:(NSURLResponse*)response error:(NSError*)error prefix:(NSString*)prefix {
+    if ( error ) {
+        NSLog(@"HIBP Range [%@] - ERROR: [%@]", prefix, error);
+        return NO;
+    }
+
+    NSHTTPURLResponse* httpResponse = (NSHTTPURLResponse*)response;
+    if ( httpResponse.statusCode != 200 || data == nil ) {
+        NSLog(@"HIBP Range [%@] - HTTP [%ld]", prefix, (long)httpResponse.statusCode);
+        return NO;
+    }
+
+    NSMutableData* keys = [NSMutableData dataWithCapacity:(data.length / (kSuffixHexLength + 4)) * kSuffixKeyLength];
+
+    enumerateLines(data.bytes, data.length, ^(const char *line, NSUInteger length) {
+        uint8_t key[kSuffixKeyLength];
+
+        if ( parseRangeLine(line, length, kSuffixHexLength, key) ) {
+            [keys appendBytes:key length:kSuffixKeyLength];
+        }
+    });
+
+    qsort(keys.mutableBytes, keys.length / kSuffixKeyLength, kSuffixKeyLength, compareKeys);
+
+    return [self writeRange:keys prefix:prefix];
+}
+
+- (UrlRequestOperation*)fetchOperation:(NSString*)prefix completion:(void (^)(BOOL success))completion {
+    return [[UrlRequestOperation alloc] initWithRequest:[self requestForPrefix:prefix] dataTaskCompletionHandler:^(NSData * _Nullable data, NSURLResponse * _Nullable response, NSError * _Nullable error) {
+        completion([self storeResponse:data response:response error:error prefix:prefix]);
+    }];
+}
+
+- (NSUInteger)prefetchPrefixes:(NSSet<NSString *> *)prefixes
+                        maxAge:(NSTimeInterval)maxAge
+                      progress:(HibpRangeProgressBlock)progress
+                     cancelled:(HibpRangeCancelledBlock)cancelled {
+    NSMutableArray<NSString*>* needed = NSMutableArray.array;
+    for ( NSString* prefix in prefixes ) {
+        if ( ![self hasRangeForPrefix:prefix maxAge:maxAge] ) {
+            [needed addObject:prefix.uppercaseString];
+        }
+    }
+
+    NSLog(@"HIBP: Prefetching %lu of %lu ranges", (unsigned long)needed.count, (unsigned long)prefixes.count);
+
+    if ( needed.count == 0 ) {
+        return 0;
+    }
+
+    NSOperationQueue* queue = [NSOperationQueue new];
+    queue.maxConcurrentOperationCount = MAX(1, self.maxConcurrentRequests);
+    queue.suspended = YES;
+
+    NSObject* lock = [[NSObject alloc] init];
+    __block NSUInteger completed = 0;
+    __block NSUInteger errors = 0;
+
+    dispatch_group_t group = dispatch_group_create();
+
+    for ( NSString* prefix in needed ) {
+        UrlRequestOperation* operation = [self fetchOperation:prefix completion:^(BOOL success) {
+            @synchronized ( lock ) {
+                completed++;
+                errors += success ? 0 : 1;
+
+                if ( progress ) {
+                    progress(completed, needed.count);
+                }
+            }
+        }];
+
+        dispatch_group_enter(group);
+        operation.completionBlock = ^{
+            dispatch_group_leave(group);
+        };
+
+        [queue addOperation:operation];
+    }
+
+    queue.suspended = NO;
+
+    while ( dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, 100 * NSEC_PER_MSEC)) != 0 ) {
+        if ( cancelled && cancelled() ) {
+            [queue cancelAllOperations];
+            dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+            break;
+        }
+    }
+
+    @synchronized ( lock ) {
+        return errors + (needed.count - completed);
+    }
+}
+
+- (void)lookup:(NSString *)sha1Hex offline:(BOOL)offline completion:(void (^)(BOOL, NSError * _Nullable))completion {
+    if ( offline ) {
+        NSNumber* local = [self isPwned:sha1Hex];
+
+        if ( local == nil ) {
+            completion(NO, [Utils createNSError:@"No local HIBP range available for this password" errorCode:-2346]);
+        }
+        else {
+            completion(local.boolValue, nil);
+        }
+
+        return;
+    }
+
+    NSString* prefix = [HibpRangeCache prefixForSha1Hex:sha1Hex];
+
+    [self.lookupQueue addOperation:[self fetchOperation:prefix completion:^(BOOL success) {
+        NSNumber* local = [self isPwned:sha1Hex];
+
+        if ( local == nil ) {
+            completion(NO, [Utils createNSError:@"Could not retrieve HIBP range" errorCode:-2345]);
+        }
+        else {
+            completion(local.boolValue, nil);
+        }
+    }]];
+}
+
+
+
+- (void)clear {
+    [self.ranges removeAllObjects];
+
+    NSArray<NSURL*>* files = [NSFileManager.defaultManager contentsOfDirectoryAtURL:self.directory includingPropertiesForKeys:nil options:kNilOptions error:nil];
+
+    for ( NSURL* file in files ) {
+        if ( [file.pathExtension isEqualToString:kRangeFileExtension] ) {
+            [NSFileManager.defaultManager removeItemAtURL:file error:nil];
+        }
+    }
+}
+
+@end
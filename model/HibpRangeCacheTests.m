@@ -0,0 +1,185 @@
+//
+//  HibpRangeCacheTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "HibpRangeCache.h"
+
+static NSString* const kStubHost = @"hibp-range.test";
+static NSString* const kPwnedSuffix = @"1E4C9B93F3F0682250B6CF8331B7EE68FD8";
+static NSTimeInterval stubDelay = 0;
+static NSUInteger stubRequestCount = 0;
+
+@interface HibpRangeStubProtocol : NSURLProtocol
+
+@end
+
+@implementation HibpRangeStubProtocol
+
++ (BOOL)canInitWithRequest:(NSURLRequest *)request {
+    return [request.URL.host isEqualToString:kStubHost];
+}
+
++ (NSURLRequest *)canonicalRequestForRequest:(NSURLRequest *)request {
+    return request;
+}
+
+- (void)startLoading {
+    @synchronized (HibpRangeStubProtocol.class) {
+        stubRequestCount++;
+    }
+
+    [self performSelector:@selector(respond) withObject:nil afterDelay:stubDelay];
+}
+
+- (void)respond {
+    NSString* body = [NSString stringWithFormat:@"%@:3861493\r\n0000000000000000000000000000000000A:0\r\n", kPwnedSuffix];
+
+    NSHTTPURLResponse* response = [[NSHTTPURLResponse alloc] initWithURL:self.request.URL statusCode:200 HTTPVersion:@"HTTP/1.1" headerFields:@{ @"Content-Type" : @"text/plain" }];
+
+    [self.client URLProtocol:self didReceiveResponse:response cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+    [self.client URLProtocol:self didLoadData:[body dataUsingEncoding:NSUTF8StringEncoding]];
+    [self.client URLProtocolDidFinishLoading:self];
+}
+
+- (void)stopLoading {
+    [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(respond) object:nil];
+}
+
+@end
+
+@interface HibpRangeCacheTests : XCTestCase
+
+@property NSURL* directory;
+@property NSData* key;
+@property HibpRangeCache* cache;
+
+@end
+
+@implementation HibpRangeCacheTests
+
+- (void)setUp {
+    [NSURLProtocol registerClass:HibpRangeStubProtocol.class];
+
+    stubDelay = 0;
+    stubRequestCount = 0;
+
+    self.directory = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString]];
+    [NSFileManager.defaultManager createDirectoryAtURL:self.directory withIntermediateDirectories:YES attributes:nil error:nil];
+
+    NSMutableData* key = [NSMutableData dataWithLength:32];
+    arc4random_buf(key.mutableBytes, key.length);
+    self.key = key;
+
+    self.cache = [self cacheWithKey:self.key];
+}
+
+- (HibpRangeCache*)cacheWithKey:(NSData*)key {
+    HibpRangeCache* cache = [[HibpRangeCache alloc] initWithDirectory:self.directory key:key];
+    cache.baseUrl = [NSURL URLWithString:[NSString stringWithFormat:@"https://%@/range/", kStubHost]];
+
+    return cache;
+}
+
+- (void)tearDown {
+    [NSURLProtocol unregisterClass:HibpRangeStubProtocol.class];
+    [NSFileManager.defaultManager removeItemAtURL:self.directory error:nil];
+}
+
+- (NSSet<NSString*>*)prefixes:(NSUInteger)count {
+    NSMutableSet<NSString*>* ret = NSMutableSet.set;
+
+    for ( NSUInteger i = 0; i < count; i++ ) {
+        [ret addObject:[NSString stringWithFormat:@"%05lX", (unsigned long)i]];
+    }
+
+    return ret;
+}
+
+- (void)testPrefetchStoresRanges {
+    NSSet<NSString*>* prefixes = [self prefixes:24];
+
+    __block NSUInteger lastCompleted = 0;
+    NSUInteger errors = [self.cache prefetchPrefixes:prefixes maxAge:3600 progress:^(NSUInteger completed, NSUInteger total) {
+        lastCompleted = completed;
+    } cancelled:nil];
+
+    XCTAssertEqual(errors, 0);
+    XCTAssertEqual(lastCompleted, prefixes.count);
+
+    for ( NSString* prefix in prefixes ) {
+        XCTAssertTrue([self.cache hasRangeForPrefix:prefix maxAge:3600]);
+        XCTAssertEqualObjects([self.cache isPwned:[prefix stringByAppendingString:kPwnedSuffix]], @YES);
+        XCTAssertEqualObjects([self.cache isPwned:[prefix stringByAppendingString:@"1E4C9B93F3F0682250B6CF8331B7EE68FD9"]], @NO);
+    }
+
+    stubRequestCount = 0;
+    XCTAssertEqual([self.cache prefetchPrefixes:prefixes maxAge:3600 progress:nil cancelled:nil], 0);
+    XCTAssertEqual(stubRequestCount, 0);
+}
+
+- (void)testStoredRangesDoNotRevealPrefixesOrSuffixes {
+    NSSet<NSString*>* prefixes = [self prefixes:4];
+
+    XCTAssertEqual([self.cache prefetchPrefixes:prefixes maxAge:3600 progress:nil cancelled:nil], 0);
+
+    NSArray<NSURL*>* files = [NSFileManager.defaultManager contentsOfDirectoryAtURL:self.directory includingPropertiesForKeys:nil options:kNilOptions error:nil];
+    XCTAssertEqual(files.count, prefixes.count);
+
+    NSData* suffixBytes = [NSData dataWithBytes:"\x01\xE4\xC9\xB9\x3F\x3F" length:6];
+
+    for ( NSURL* file in files ) {
+        NSString* name = file.URLByDeletingPathExtension.lastPathComponent;
+
+        for ( NSString* prefix in prefixes ) {
+            XCTAssertEqual([name rangeOfString:prefix options:NSCaseInsensitiveSearch].location, NSNotFound);
+        }
+
+        NSData* contents = [NSData dataWithContentsOfURL:file];
+        XCTAssertEqual([contents rangeOfData:suffixBytes options:kNilOptions range:NSMakeRange(0, contents.length)].location, NSNotFound);
+    }
+
+    HibpRangeCache* reopened = [self cacheWithKey:self.key];
+    NSString* prefix = prefixes.anyObject;
+    XCTAssertEqualObjects([reopened isPwned:[prefix stringByAppendingString:kPwnedSuffix]], @YES);
+
+    NSMutableData* otherKey = [NSMutableData dataWithLength:32];
+    arc4random_buf(otherKey.mutableBytes, otherKey.length);
+
+    HibpRangeCache* other = [self cacheWithKey:otherKey];
+    XCTAssertNil([other isPwned:[prefix stringByAppendingString:kPwnedSuffix]]);
+    XCTAssertFalse([other hasRangeForPrefix:prefix maxAge:3600]);
+}
+
+- (void)testCancelWithQueuedOperationsReturnsWithoutHanging {
+    stubDelay = 0.25;
+    self.cache.maxConcurrentRequests = 1;
+
+    NSSet<NSString*>* prefixes = [self prefixes:50];
+    NSTimeInterval start = NSDate.timeIntervalSinceReferenceDate;
+
+    NSUInteger errors = [self.cache prefetchPrefixes:prefixes maxAge:3600 progress:nil cancelled:^BOOL{
+        return NSDate.timeIntervalSinceReferenceDate - start > 0.3;
+    }];
+
+    XCTAssertGreaterThan(errors, 0);
+    XCTAssertLessThanOrEqual(errors, prefixes.count);
+    XCTAssertLessThan(stubRequestCount, prefixes.count);
+    XCTAssertLessThan(NSDate.timeIntervalSinceReferenceDate - start, 5.0);
+}
+
+- (void)testCancelBeforeAnyRequestStarts {
+    stubDelay = 0.25;
+
+    NSUInteger errors = [self.cache prefetchPrefixes:[self prefixes:16] maxAge:3600 progress:nil cancelled:^BOOL{
+        return YES;
+    }];
+
+    XCTAssertEqual(errors, 16);
+}
+
+@end
@@ -11,15 +11,17 @@
 #import <CommonCrypto/CommonCrypto.h>
 #import "KeePassConstants.h"
 #import "Utils.h"
+#import "Kdbx4Serialization.h"
 
 @interface HmacBlockOutputStream ()
 
 @property NSOutputStream* outputStream;
 @property NSError* error;
-@property int blockNumber;
+@property uint64_t blockNumber;
 @property NSData *hmacKey;
 
-@property NSMutableData* pendingBuffer;
+@property uint8_t* pendingBlock;
+@property size_t pendingLength;
 
 @property BOOL wasOpened, wasClosed;
 @end
@@ -42,6 +44,13 @@ const NSUInteger kLengthLength = 4;
     return self;
 }
 
+- (void)dealloc {
+    if ( self.pendingBlock ) {
+        free(self.pendingBlock);
+        self.pendingBlock = nil;
+    }
+}
+
 - (NSError *)streamError {
     return self.outputStream.streamError ? self.outputStream.streamError : self.error;
 }
@@ -53,7 +62,12 @@ const NSUInteger kLengthLength = 4;
     self.wasOpened = YES;
 
     self.blockNumber = 0;
-    self.pendingBuffer = [NSMutableData data];
+    self.pendingLength = 0;
+    self.pendingBlock = malloc(kDefaultBlockifySize);
+    
+    if ( !self.pendingBlock ) {
+        self.error = [Utils createNSError:@"Could not allocate HMAC Block buffer" errorCode:-1];
+    }
 }
 
 - (void)close {
@@ -62,8 +76,8 @@ const NSUInteger kLengthLength = 4;
     }
     self.wasClosed = YES;
 
-    if ( self.pendingBuffer.length > 0 ) {
-        NSInteger wrote = [self writeBlock:self.pendingBuffer.bytes blockLength:self.pendingBuffer.length];
+    if ( self.pendingLength > 0 ) {
+        NSInteger wrote = [self writeBlock:self.pendingBlock blockLength:self.pendingLength];
         
 
         
@@ -73,11 +87,13 @@ const NSUInteger kLengthLength = 4;
         }
     }
     
-    self.pendingBuffer = nil;
-    
-    NSData* terminatorBlock = [NSData data];
+    if ( self.pendingBlock ) {
+        free(self.pendingBlock);
+        self.pendingBlock = nil;
+    }
+    self.pendingLength = 0;
     
-    NSInteger wrote = [self writeBlock:terminatorBlock.bytes blockLength:terminatorBlock.length];
+    NSInteger wrote = [self writeBlock:NULL blockLength:0];
     if ( wrote < 0 ) {
         NSLog(@"WARNWARN: Error writing Terminator Block");
         return;
@@ -87,51 +103,45 @@ const NSUInteger kLengthLength = 4;
 }
 
 - (NSInteger)write:(const uint8_t *)indata maxLength:(NSUInteger)inlen {
-    if ( !self.wasOpened || self.wasClosed ) {
+    if ( !self.wasOpened || self.wasClosed || !self.pendingBlock ) {
         NSLog(@"WARNWARN: Unopen or not closed. HMAC Block Output Stream");
         return -1;
     }
     
-    [self.pendingBuffer appendBytes:indata length:inlen];
-    
-    
-    
-
-    
-    
-    
-    size_t numberOfFullBlocksThisTime = self.pendingBuffer.length / kDefaultBlockifySize;
-    
-
-
     NSInteger writtenThisTime = 0;
-    
-    for (size_t i=0; i < numberOfFullBlocksThisTime; i++) {
-
-
-        const uint8_t *block = &self.pendingBuffer.bytes[i * kDefaultBlockifySize];
-        NSInteger w = [self writeFullBlock:block];
-        if ( w < 0 ) {
-            NSLog(@"Error writing full HMAC block = [%@]", self.streamError);
-            return w;
+    NSUInteger consumed = 0;
+    
+    while ( consumed < inlen ) {
+        if ( self.pendingLength == 0 && inlen - consumed >= kDefaultBlockifySize ) {
+            NSInteger w = [self writeFullBlock:&indata[consumed]];
+            if ( w < 0 ) {
+                NSLog(@"Error writing full HMAC block = [%@]", self.streamError);
+                return w;
+            }
+            
+            writtenThisTime += w;
+            consumed += kDefaultBlockifySize;
+            continue;
         }
         
-        writtenThisTime += w;
-
-    }
-    
-    if ( numberOfFullBlocksThisTime > 0 ) {
-        NSUInteger offset = numberOfFullBlocksThisTime * kDefaultBlockifySize;
-        NSUInteger remaining = self.pendingBuffer.length - offset;
+        size_t toCopy = MIN(kDefaultBlockifySize - self.pendingLength, inlen - consumed);
+        memcpy(&self.pendingBlock[self.pendingLength], &indata[consumed], toCopy);
         
-        memcpy(self.pendingBuffer.mutableBytes, &self.pendingBuffer.bytes[offset], remaining);
-        [self.pendingBuffer setLength:remaining];
-
+        self.pendingLength += toCopy;
+        consumed += toCopy;
         
+        if ( self.pendingLength == kDefaultBlockifySize ) {
+            NSInteger w = [self writeFullBlock:self.pendingBlock];
+            if ( w < 0 ) {
+                NSLog(@"Error writing full HMAC block = [%@]", self.streamError);
+                return w;
+            }
+            
+            writtenThisTime += w;
+            self.pendingLength = 0;
+        }
     }
     
-
-    
     return writtenThisTime;
 }
 
@@ -139,53 +149,47 @@ const NSUInteger kLengthLength = 4;
     return [self writeBlock:buffer blockLength:kDefaultBlockifySize];
 }
 
-- (NSInteger)writeBlock:(const uint8_t*)buffer blockLength:(size_t)blockLength {
-
-
-    NSData *hmac = getBlockHmacBytes(buffer, blockLength, self.hmacKey, self.blockNumber);
-    
-    NSData* lengthData = Uint32ToLittleEndianData((uint32_t)blockLength);
-
-    NSInteger wrote = [self.outputStream write:hmac.bytes maxLength:hmac.length];
-    if ( wrote < 0 ) {
-        NSLog(@"WARNWARN: Error writing HMAC for Block");
-        
-        if ( self.outputStream.streamError == nil ) {
-            self.error = [Utils createNSError:@"Could not write HMAC Block to output stream and no output stream error" errorCode:wrote];
-        }
-        return wrote;
-    }
+- (NSInteger)writeAll:(const uint8_t*)buffer length:(size_t)length {
+    size_t total = 0;
     
-    wrote = [self.outputStream write:lengthData.bytes maxLength:lengthData.length];
-    if ( wrote < 0 ) {
-        NSLog(@"WARNWARN: Error writing Length for Block");
+    while ( total < length ) {
+        NSInteger wrote = [self.outputStream write:&buffer[total] maxLength:length - total];
         
-        if ( self.outputStream.streamError == nil ) {
-            self.error = [Utils createNSError:@"Could not write HMAC Block to output stream and no output stream error" errorCode:wrote];
+        if ( wrote <= 0 ) {
+            if ( self.outputStream.streamError == nil ) {
+                self.error = [Utils createNSError:@"Could not write HMAC Block to output stream and no output stream error" errorCode:wrote];
+            }
+            return -1;
         }
-        return wrote;
-    }
-
-    wrote = [self.outputStream write:buffer maxLength:blockLength];
-    if ( wrote < 0 ) {
-        NSLog(@"WARNWARN: Error writing Block for Block");
         
-        if ( self.outputStream.streamError == nil ) {
-            self.error = [Utils createNSError:@"Could not write HMAC Block to output stream and no output stream error" errorCode:wrote];
-        }
-        return wrote;
+        total += wrote;
     }
+    
+    return total;
+}
 
+- (NSInteger)writeBlock:(const uint8_t*)buffer blockLength:(size_t)blockLength {
+    HmacBlockHeader header;
     
+    computeBlockHmac(buffer, blockLength, self.hmacKey.bytes, self.hmacKey.length, self.blockNumber, header.hmacSha256);
     
+    for (NSUInteger i = 0; i < kLengthLength; i++) {
+        header.lengthBytes[i] = (uint8_t)((uint32_t)blockLength >> (8 * i));
+    }
 
-
-
-
+    if ( [self writeAll:(const uint8_t*)&header length:SIZE_OF_HMAC_BLOCK_HEADER] < 0 ) {
+        NSLog(@"WARNWARN: Error writing HMAC Header for Block");
+        return -1;
+    }
+    
+    if ( blockLength > 0 && [self writeAll:buffer length:blockLength] < 0 ) {
+        NSLog(@"WARNWARN: Error writing Block for Block");
+        return -1;
+    }
     
     self.blockNumber++;
     
-    return blockLength + hmac.length + lengthData.length;
+    return blockLength + SIZE_OF_HMAC_BLOCK_HEADER;
 }
 
 @end
@@ -0,0 +1,113 @@
+//
+//  HmacBlockStreamTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "HmacBlockInputStream.h"
+#import "HmacBlockOutputStream.h"
+#import "Utils.h"
+
+static const NSUInteger kMegabyte = 1024 * 1024;
+static const NSUInteger kReadChunkSize = 32 * 1024;
+
+@interface HmacBlockStreamTests : XCTestCase
+
+@end
+
+@implementation HmacBlockStreamTests
+
+- (NSData*)hmac:(NSData*)plaintext key:(NSData*)hmacKey {
+    NSOutputStream* memory = [NSOutputStream outputStreamToMemory];
+    [memory open];
+
+    HmacBlockOutputStream* writer = [[HmacBlockOutputStream alloc] initWithStream:memory hmacKey:hmacKey];
+
+    [writer open];
+    XCTAssertEqual([writer write:plaintext.bytes maxLength:plaintext.length], (NSInteger)plaintext.length);
+    [writer close];
+
+    NSData* ret = [memory propertyForKey:NSStreamDataWrittenToMemoryStreamKey];
+    [memory close];
+
+    return ret;
+}
+
+- (NSData*)unhmac:(NSData*)hmaced key:(NSData*)hmacKey error:(NSError**)error {
+    HmacBlockInputStream* reader = [[HmacBlockInputStream alloc] initWithStream:[NSInputStream inputStreamWithData:hmaced] hmacKey:hmacKey];
+    NSMutableData* ret = NSMutableData.data;
+    uint8_t chunk[kReadChunkSize];
+    NSInteger read;
+
+    [reader open];
+    while ( (read = [reader read:chunk maxLength:kReadChunkSize]) > 0 ) {
+        [ret appendBytes:chunk length:read];
+    }
+    [reader close];
+
+    if ( read < 0 ) {
+        if ( error ) {
+            *error = reader.streamError;
+        }
+        return nil;
+    }
+
+    return ret;
+}
+
+- (void)testRoundTrip {
+    NSData* hmacKey = getRandomData(64);
+
+    for ( NSNumber* length in @[@0, @1, @4095, @(kMegabyte - 1), @(kMegabyte), @(kMegabyte + 1), @(3 * kMegabyte + kMegabyte / 2)] ) {
+        NSMutableData* plaintext = [NSMutableData dataWithLength:length.unsignedIntegerValue];
+        arc4random_buf(plaintext.mutableBytes, plaintext.length);
+
+        NSError* error;
+        NSData* roundTripped = [self unhmac:[self hmac:plaintext key:hmacKey] key:hmacKey error:&error];
+
+        XCTAssertNotNil(roundTripped, @"Length [%@]: %@", length, error);
+        XCTAssertEqualObjects(roundTripped, plaintext, @"Length [%@]", length);
+    }
+}
+
+- (void)testTamperedBlockIsRejected {
+    NSData* hmacKey = getRandomData(64);
+    NSMutableData* plaintext = [NSMutableData dataWithLength:2 * kMegabyte];
+    arc4random_buf(plaintext.mutableBytes, plaintext.length);
+
+    NSMutableData* hmaced = [self hmac:plaintext key:hmacKey].mutableCopy;
+    ((uint8_t*)hmaced.mutableBytes)[hmaced.length / 2] ^= 0x01;
+
+    NSError* error;
+    XCTAssertNil([self unhmac:hmaced key:hmacKey error:&error]);
+    XCTAssertNotNil(error);
+
+    XCTAssertNil([self unhmac:[self hmac:plaintext key:hmacKey] key:getRandomData(64) error:nil]);
+}
+
+- (void)testWritePerformance {
+    NSData* hmacKey = getRandomData(64);
+    NSMutableData* plaintext = [NSMutableData dataWithLength:64 * kMegabyte];
+    arc4random_buf(plaintext.mutableBytes, plaintext.length);
+
+    [self measureBlock:^{
+        XCTAssertGreaterThan([self hmac:plaintext key:hmacKey].length, plaintext.length);
+    }];
+}
+
+- (void)testReadPerformance {
+    NSData* hmacKey = getRandomData(64);
+    NSMutableData* plaintext = [NSMutableData dataWithLength:64 * kMegabyte];
+    arc4random_buf(plaintext.mutableBytes, plaintext.length);
+
+    NSData* hmaced = [self hmac:plaintext key:hmacKey];
+
+    [self measureBlock:^{
+        XCTAssertEqual([self unhmac:hmaced key:hmacKey error:nil].length, plaintext.length);
+    }];
+}
+
+@end
@@ -0,0 +1,183 @@
+//
+//  KeePassNodeXmlWriterTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "XmlStrongboxNodeModelAdaptor.h"
+#import "XmlSerializer.h"
+#import "XmlProcessingContext.h"
+#import "KeePassConstants.h"
+#import "InnerRandomStreamFactory.h"
+#import "StringValue.h"
+#import "ValueWithModDate.h"
+#import "AutoType.h"
+
+static const NSUInteger kGroupCount = 6;
+static const NSUInteger kEntriesPerGroup = 40;
+
+@interface KeePassNodeXmlWriterTests : XCTestCase
+
+@property NSData* innerStreamKey;
+
+@end
+
+@implementation KeePassNodeXmlWriterTests
+
+- (void)setUp {
+    NSMutableData* key = [NSMutableData dataWithLength:64];
+    arc4random_buf(key.mutableBytes, key.length);
+    self.innerStreamKey = key;
+}
+
+- (Node*)databaseWithIconPool:(NSDictionary<NSUUID*, NodeIcon*>**)iconPool {
+    NSDate* date = [NSDate dateWithTimeIntervalSince1970:1760000000];
+    NSData* iconData = [@"not really a png" dataUsingEncoding:NSUTF8StringEncoding];
+    NodeIcon* customIcon = [NodeIcon withCustom:iconData uuid:NSUUID.UUID name:@"Custom" modified:date preferredOrder:0];
+
+    *iconPool = @{ customIcon.uuid : customIcon };
+
+    NSMutableArray<DatabaseAttachment*>* attachments = NSMutableArray.array;
+    for ( NSUInteger i = 0; i < 3; i++ ) {
+        NSMutableData* data = [NSMutableData dataWithLength:1024 * (i + 1)];
+        arc4random_buf(data.mutableBytes, data.length);
+        [attachments addObject:[[DatabaseAttachment alloc] initNonPerformantWithData:data compressed:YES protectedInMemory:YES]];
+    }
+
+    Node* root = Node.rootWithDefaultKeePassEffectiveRootGroup;
+    Node* keePassRoot = root.childGroups.firstObject;
+
+    keePassRoot.fields.customData[@"KPXC_DECRYPTION_TIME_PREFERENCE"] = [ValueWithModDate value:@"1000" modified:nil];
+
+    for ( NSUInteger g = 0; g < kGroupCount; g++ ) {
+        Node* group = [[Node alloc] initAsGroup:[NSString stringWithFormat:@"Group %lu", (unsigned long)g] parent:keePassRoot keePassGroupTitleRules:YES uuid:nil];
+        [keePassRoot addChild:group keePassGroupTitleRules:YES];
+
+        group.icon = (g % 2) ? [NodeIcon withPreset:48 + g] : customIcon;
+        group.fields.notes = [NSString stringWithFormat:@"Notes for group %lu <&>", (unsigned long)g];
+        group.fields.isExpanded = (g % 3) != 0;
+        group.fields.enableAutoType = (g % 2) ? @NO : nil;
+        group.fields.defaultAutoTypeSequence = (g % 2) ? @"{USERNAME}{ENTER}" : nil;
+        group.fields.customData[@"Group.Key"] = [ValueWithModDate value:@"Group Value" modified:date];
+        [group.fields setTouchPropertiesWithCreated:date accessed:date modified:date locationChanged:date usageCount:@(g)];
+
+        for ( NSUInteger e = 0; e < kEntriesPerGroup; e++ ) {
+            [group addChild:[self entry:e group:group date:date icon:customIcon attachments:attachments] keePassGroupTitleRules:YES];
+        }
+    }
+
+    return root;
+}
+
+- (Node*)entry:(NSUInteger)index group:(Node*)group date:(NSDate*)date icon:(NodeIcon*)customIcon attachments:(NSArray<DatabaseAttachment*>*)attachments {
+    Node* entry = [[Node alloc] initAsRecord:[NSString stringWithFormat:@"Entry %lu Crème Brûlée", (unsigned long)index] parent:group];
+
+    entry.icon = (index % 5) == 0 ? customIcon : [NodeIcon withPreset:index % 60];
+    entry.fields.username = [NSString stringWithFormat:@"user%lu@example.com", (unsigned long)index];
+    entry.fields.password = [NSString stringWithFormat:@"p@ssw0rd-%lu-<&>\"'", (unsigned long)index];
+    entry.fields.url = (index % 4) ? [NSString stringWithFormat:@"https://site%lu.example.com", (unsigned long)index] : @"";
+    entry.fields.notes = (index % 3) ? @"Multi\nline\tnotes 😀" : @"";
+    entry.fields.expires = (index % 7) == 0 ? date : nil;
+    entry.fields.qualityCheck = (index % 6) != 0;
+    entry.fields.foregroundColor = (index % 8) == 0 ? @"#FF0000" : nil;
+    entry.fields.tags = [NSMutableSet setWithArray:@[@"Café", [NSString stringWithFormat:@"tag-%lu", (unsigned long)(index % 4)]]];
+
+    [entry.fields setCustomField:@"Custom" value:[StringValue valueWithString:@"  Custom Value  " protected:NO]];
+    [entry.fields setCustomField:@"Secret" value:[StringValue valueWithString:@"hidden" protected:YES]];
+
+    entry.fields.customData[@"Entry.Key"] = [ValueWithModDate value:[NSString stringWithFormat:@"%lu", (unsigned long)index] modified:(index % 2) ? date : nil];
+
+    if ( index % 3 == 0 ) {
+        AutoTypeAssociation* association = [[AutoTypeAssociation alloc] init];
+        association.window = @"Firefox - *";
+        association.keystrokeSequence = (index % 2) ? @"{PASSWORD}{ENTER}" : nil;
+
+        AutoType* autoType = [[AutoType alloc] init];
+        autoType.enabled = (index % 2) == 0;
+        autoType.dataTransferObfuscation = 1;
+        autoType.defaultSequence = @"{USERNAME}{TAB}{PASSWORD}{ENTER}";
+        autoType.asssociations = @[association];
+
+        entry.fields.autoType = autoType;
+    }
+
+    if ( index % 2 == 0 ) {
+        entry.fields.attachments[@"document.pdf"] = attachments[index % attachments.count];
+        entry.fields.attachments[@"copy.pdf"] = attachments[(index + 1) % attachments.count];
+    }
+
+    [entry.fields setTouchPropertiesWithCreated:date accessed:date modified:date locationChanged:date usageCount:@(index)];
+
+    if ( index % 4 == 0 ) {
+        Node* historical = [entry cloneForHistory];
+        [historical setTitle:@"Old Title" keePassGroupTitleRules:NO];
+        historical.fields.password = @"old";
+        [historical.fields.attachments removeAllObjects];
+        historical.fields.attachments[@"old.txt"] = attachments.lastObject;
+
+        [entry.fields.keePassHistory addObject:historical];
+    }
+
+    return entry;
+}
+
+- (NSData*)serialize:(BOOL (^)(id<IXmlSerializer> serializer))block {
+    NSOutputStream* stream = [NSOutputStream outputStreamToMemory];
+    [stream open];
+
+    XmlSerializer* serializer = [[XmlSerializer alloc] initWithProtectedStream:[InnerRandomStreamFactory getStream:kInnerStreamChaCha20 key:self.innerStreamKey]
+                                                                      v4Format:YES
+                                                                   prettyPrint:NO
+                                                                  outputStream:stream];
+
+    [serializer beginDocument];
+    XCTAssertTrue(block(serializer));
+    [serializer endDocument];
+
+    XCTAssertNil(serializer.streamError);
+
+    NSData* ret = [stream propertyForKey:NSStreamDataWrittenToMemoryStreamKey];
+    [stream close];
+
+    return ret;
+}
+
+- (void)testMatchesLegacyKeePassGroupWriter {
+    NSDictionary<NSUUID*, NodeIcon*>* iconPool;
+    Node* root = [self databaseWithIconPool:&iconPool];
+
+    XmlStrongboxNodeModelAdaptor* adaptor = [[XmlStrongboxNodeModelAdaptor alloc] init];
+
+    NSError* error;
+    NSArray<DatabaseAttachment*>* legacyPool;
+    KeePassGroup* legacyRoot = [adaptor toKeePassModel:root context:XmlProcessingContext.standardV4Context minimalAttachmentPool:&legacyPool iconPool:iconPool error:&error];
+    XCTAssertNotNil(legacyRoot, @"%@", error);
+
+    NSArray<DatabaseAttachment*>* pool;
+    KeePassNodeXmlWriter* nodeWriter = [adaptor toKeePassNodeWriter:root minimalAttachmentPool:&pool iconPool:iconPool error:&error];
+    XCTAssertNotNil(nodeWriter, @"%@", error);
+
+    XCTAssertEqual(pool.count, 3);
+    XCTAssertEqualObjects(pool, legacyPool);
+
+    NSData* legacy = [self serialize:^BOOL(id<IXmlSerializer> serializer) {
+        return [legacyRoot writeXml:serializer];
+    }];
+
+    NSData* sequential = [self serialize:^BOOL(id<IXmlSerializer> serializer) {
+        return [nodeWriter writeXml:serializer concurrently:NO];
+    }];
+
+    NSData* direct = [self serialize:^BOOL(id<IXmlSerializer> serializer) {
+        return [nodeWriter writeXml:serializer];
+    }];
+
+    XCTAssertGreaterThan(direct.length, 0);
+    XCTAssertEqualObjects(sequential, legacy);
+    XCTAssertEqualObjects(direct, sequential);
+}
+
+@end
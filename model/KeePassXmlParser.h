@@ -8,6 +8,7 @@
 
 #import <Foundation/Foundation.h>
 #import "RootXmlDomainObject.h"
+#import "KeePassXmlNodeBuilder.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -21,11 +22,16 @@ NS_ASSUME_NONNULL_BEGIN
                                   context:(XmlProcessingContext*)context;
 
 @property (nonatomic, readonly, nullable) RootXmlDomainObject* rootElement;
+@property (nullable) KeePassXmlNodeBuilder* nodeBuilder;
+
+@property (class, readonly) NSDictionary<NSString*, NSString*>* knownNames;
+
+- (NSString*)internedName:(const char*)name;
 
 - (void)didStartElement:(NSString *)elementName
              attributes:(NSDictionary *_Nullable)attributeDict;
 
-- (void)foundCharacters:(NSString *)string;
+- (void)foundCharacters:(const char*)characters length:(NSUInteger)length;
 
 - (void)didEndElement:(NSString *)elementName;
 
@@ -16,6 +16,8 @@
 #import "NSData+Extensions.h"
 #import "NSString+Extensions.h"
 #import "NSData+GZIP.h"
+#import "KeePassFile.h"
+#import "Root.h"
 
 @interface KeePassXmlParser ()
 
@@ -24,7 +26,8 @@
 @property (nonatomic) NSError *errorParse;
 @property (nonatomic) NSError *problemDecrypting;
 @property XmlProcessingContext* context;
-@property NSMutableString* mutableText;
+@property NSMutableData* mutableText;
+@property NSMapTable* internedNames;
 @property BOOL sanityCheckStreamDecryption;
 
 @end
@@ -50,7 +53,9 @@
         self.sanityCheckStreamDecryption = sanityCheckStreamDecryption;
         self.handlerStack = [NSMutableArray array];
         [self.handlerStack addObject:[[RootXmlDomainObject alloc] initWithContext:context]];
-        self.mutableText = [[NSMutableString alloc] initWithCapacity:32 * 1024]; 
+        self.mutableText = [[NSMutableData alloc] initWithCapacity:32 * 1024]; 
+        self.internedNames = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsOpaqueMemory | NSPointerFunctionsOpaquePersonality
+                                                   valueOptions:NSPointerFunctionsStrongMemory];
     }
     
     return self;
@@ -70,9 +75,67 @@
     return (RootXmlDomainObject*)rootHandler;
 }
 
++ (NSDictionary<NSString*, NSString*>*)knownNames {
+    static NSDictionary<NSString*, NSString*>* knownNames;
+    static dispatch_once_t onceToken;
+    
+    dispatch_once(&onceToken, ^{
+        NSArray<NSString*>* names = @[kKeePassFileElementName, kMetaElementName, kRootElementName, kGroupElementName, kEntryElementName,
+                                      kStringElementName, kKeyElementName, kValueElementName, kUuidElementName, kTimesElementName,
+                                      kNameElementName, kNotesElementName, kIconIdElementName, kCustomIconUuidElementName, kTagsElementName,
+                                      kHistoryElementName, kBinaryElementName, kAutoTypeElementName, kAutoTypeAssociationElementName,
+                                      kWindowElementName, kKeystrokeSequenceElementName, kEnabledElementName, kDataTransferObfuscationElementName,
+                                      kDefaultSequenceElementName, kForegroundColorElementName, kBackgroundColorElementName, kOverrideURLElementName,
+                                      kQualityCheckElementName, kPreviousParentGroupElementName, kIsExpandedElementName,
+                                      kDefaultAutoTypeSequenceElementName, kEnableAutoTypeElementName, kEnableSearchingElementName,
+                                      kLastTopVisibleElementName, kCustomDataElementName, kCustomDataItemElementName,
+                                      kLastModificationTimeElementName, kCreationTimeElementName, kExpiryTimeElementName, kExpiresElementName,
+                                      kLastAccessTimeElementName, kUsageCountElementName, kLocationChangedTimeElementName,
+                                      kDeletedObjectElementName, kDeletedObjectsElementName, kDeletionTimeElementName,
+                                      kV3BinariesListElementName, kCustomIconListElementName, kCustomIconElementName, kCustomIconDataElementName,
+                                      kAttributeProtected, kBinaryValueAttributeRef, kBinaryCompressedAttribute, kBinaryIdAttribute];
+        
+        NSMutableDictionary<NSString*, NSString*>* ret = [NSMutableDictionary dictionaryWithCapacity:names.count];
+        for ( NSString* name in names ) {
+            ret[name] = name;
+        }
+        
+        knownNames = ret.copy;
+    });
+    
+    return knownNames;
+}
+
+- (NSString *)internedName:(const char *)name {
+    NSString* interned = (__bridge NSString*)NSMapGet(self.internedNames, name);
+    
+    if ( interned == nil ) {
+        NSString* str = @(name);
+        NSString* known = KeePassXmlParser.knownNames[str];
+        
+        interned = known ? known : str;
+        
+        NSMapInsert(self.internedNames, name, (__bridge void*)interned);
+    }
+    
+    return interned;
+}
+
 - (void)didStartElement:(NSString *)elementName
              attributes:(NSDictionary *)attributeDict {
-    id<XmlParsingDomainObject> nextHandler = [[self.handlerStack lastObject] getChildHandler:elementName];
+    if ( self.nodeBuilder && !self.nodeBuilder.isEngaged ) {
+        [self beginNodeBuilderIfReady:elementName];
+    }
+    
+    id<XmlParsingDomainObject> nextHandler = nil;
+    
+    if ( self.nodeBuilder.isEngaged ) {
+        nextHandler = [self.nodeBuilder childHandlerFor:elementName parent:[self.handlerStack lastObject]];
+    }
+    
+    if ( !nextHandler ) {
+        nextHandler = [[self.handlerStack lastObject] getChildHandler:elementName];
+    }
     
     if(!nextHandler) {
         nextHandler = [[BaseXmlDomainObjectHandler alloc] initWithXmlElementName:elementName context:self.context];
@@ -81,13 +144,27 @@
     [nextHandler setXmlInfo:elementName attributes:attributeDict];
     
     if(self.mutableText.length) {
-        [self.mutableText setString:@""];
+        [self.mutableText setLength:0];
     }
     
     [self.handlerStack addObject:nextHandler];
 }
 
-- (void)foundCharacters:(NSString *)string {
+- (void)beginNodeBuilderIfReady:(NSString *)elementName {
+    NSUInteger count = self.handlerStack.count;
+    
+    if ( count < 2 || ![elementName isEqualToString:kGroupElementName] || ![self.handlerStack.lastObject isKindOfClass:Root.class] ) {
+        return;
+    }
+    
+    id<XmlParsingDomainObject> keePassFile = self.handlerStack[count - 2];
+    
+    if ( [keePassFile isKindOfClass:KeePassFile.class] ) {
+        [self.nodeBuilder beginWithMeta:((KeePassFile*)keePassFile).meta];
+    }
+}
+
+- (void)foundCharacters:(const char *)characters length:(NSUInteger)length {
     id<XmlParsingDomainObject> currentHandler = [self.handlerStack lastObject];
 
     BOOL protected = NO;
@@ -99,13 +176,14 @@
     }
     
     if ( currentHandler.isV3BinaryHack && !protected ) { 
-        BOOL streamOk = [currentHandler appendStreamedText:string];
+        NSString* string = [[NSString alloc] initWithBytes:characters length:length encoding:NSUTF8StringEncoding];
+        BOOL streamOk = string != nil && [currentHandler appendStreamedText:string];
         if (!streamOk) {
             self.errorParse = [Utils createNSError:@"Error during foundCharacters streaming" errorCode:-1];
         }
     }
     else {
-        [self.mutableText appendString:string];
+        [self.mutableText appendBytes:characters length:length];
     }
 }
 
@@ -124,9 +202,14 @@
             protected = protectedString.isKeePassXmlBooleanStringTrue;
         }
         
-        if(protected) {
-            NSString *string = self.mutableText;
-            
+        NSString *string = [[NSString alloc] initWithBytes:self.mutableText.bytes length:self.mutableText.length encoding:NSUTF8StringEncoding];
+        
+        if ( string == nil ) {
+            NSLog(@"🔴 WARNWARN: Invalid UTF-8 text in element [%@]", elementName);
+            string = @"";
+        }
+        
+        if(protected) {            
             if ( completedObject.isV3BinaryHack ) {
                 V3Binary* v3Binary = (V3Binary*)completedObject;
                 
@@ -158,16 +241,20 @@
             }
         }
         else {
-            [completedObject setXmlText:self.mutableText.copy];
+            [completedObject setXmlText:string];
         }
         
-        [self.mutableText setString:@""];
+        [self.mutableText setLength:0];
     }
     
     [completedObject onCompleted];
     
     id<XmlParsingDomainObject> parentObject = [self.handlerStack lastObject];
     
+    if ( parentObject && self.nodeBuilder.isEngaged && [self.nodeBuilder consumeCompletedObject:completedObject parent:parentObject] ) {
+        return;
+    }
+    
     if(parentObject) {
         BOOL knownObjectType = [parentObject addKnownChildObject:completedObject withXmlElementName:elementName];
         
@@ -189,11 +276,11 @@
 }
 
 - (NSData*)decryptProtectedToData:(NSString*)ct {
-    NSData *ctData = [[NSData alloc] initWithBase64EncodedString:ct options:NSDataBase64DecodingIgnoreUnknownCharacters];
+    NSMutableData *plaintext = [[NSMutableData alloc] initWithBase64EncodedString:ct options:NSDataBase64DecodingIgnoreUnknownCharacters];
     
-    NSData* plaintext = [self.innerRandomStream xor:ctData];
+    [self.innerRandomStream xorInPlace:plaintext.mutableBytes length:plaintext.length];
 
-    return plaintext;
+    return plaintext ? plaintext : NSData.data;
 }
 
 - (NSString*)decryptProtectedToString:(NSString*)ct {
@@ -0,0 +1,231 @@
+//
+//  KeePassXmlParserTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "KdbxSerializationCommon.h"
+#import "KeePassConstants.h"
+#import "KeePassXmlNodeBuilder.h"
+#import "Node.h"
+#import "KeePassXmlModelAdaptor.h"
+
+static const NSUInteger kGroupCount = 20;
+static const NSUInteger kEntriesPerGroup = 500;
+
+@interface KeePassXmlParserTests : XCTestCase
+
+@end
+
+@implementation KeePassXmlParserTests
+
+- (NSData*)syntheticXml {
+    NSMutableString* xml = NSMutableString.string;
+
+    [xml appendString:@"<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"];
+    [xml appendString:@"<KeePassFile><Meta><Generator>Strongbox</Generator><DatabaseName>Benchmark</DatabaseName></Meta><Root>\n"];
+    [xml appendFormat:@"<Group><UUID>%@</UUID><Name>Root</Name><IsExpanded>True</IsExpanded>\n", [self base64Uuid]];
+
+    for ( NSUInteger g = 0; g < kGroupCount; g++ ) {
+        [xml appendFormat:@"<Group><UUID>%@</UUID><Name>Group %lu</Name><Notes>Notes for group %lu</Notes><IconID>48</IconID>", [self base64Uuid], (unsigned long)g, (unsigned long)g];
+        [xml appendString:@"<Times><CreationTime>2026-01-01T00:00:00Z</CreationTime><LastModificationTime>2026-01-02T00:00:00Z</LastModificationTime><LastAccessTime>2026-01-03T00:00:00Z</LastAccessTime><ExpiryTime>2026-01-04T00:00:00Z</ExpiryTime><Expires>False</Expires><UsageCount>0</UsageCount><LocationChanged>2026-01-01T00:00:00Z</LocationChanged></Times>\n"];
+
+        for ( NSUInteger e = 0; e < kEntriesPerGroup; e++ ) {
+            [xml appendString:[self entryXml:g entry:e withHistory:(e % 10) == 0]];
+        }
+
+        [xml appendString:@"</Group>\n"];
+    }
+
+    [xml appendString:@"</Group><DeletedObjects/></Root></KeePassFile>\n"];
+
+    return [xml dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+- (NSString*)entryXml:(NSUInteger)group entry:(NSUInteger)entry withHistory:(BOOL)withHistory {
+    NSMutableString* xml = NSMutableString.string;
+    NSString* uuid = [self base64Uuid];
+
+    [xml appendFormat:@"<Entry><UUID>%@</UUID><IconID>0</IconID><Tags>tag-%lu,Café</Tags>", uuid, (unsigned long)(entry % 7)];
+    [xml appendString:@"<Times><CreationTime>2026-01-01T00:00:00Z</CreationTime><LastModificationTime>2026-01-02T00:00:00Z</LastModificationTime><LastAccessTime>2026-01-03T00:00:00Z</LastAccessTime><ExpiryTime>2026-01-04T00:00:00Z</ExpiryTime><Expires>False</Expires><UsageCount>3</UsageCount><LocationChanged>2026-01-01T00:00:00Z</LocationChanged></Times>"];
+    [xml appendFormat:@"<String><Key>Title</Key><Value>Entry %lu-%lu Crème Brûlée</Value></String>", (unsigned long)group, (unsigned long)entry];
+    [xml appendFormat:@"<String><Key>UserName</Key><Value>user%lu@example.com</Value></String>", (unsigned long)entry];
+    [xml appendFormat:@"<String><Key>Password</Key><Value>p@ssw0rd-%lu-&lt;&amp;&gt;</Value></String>", (unsigned long)entry];
+    [xml appendFormat:@"<String><Key>URL</Key><Value>https://site%lu.example.com/login</Value></String>", (unsigned long)entry];
+    [xml appendString:@"<String><Key>Notes</Key><Value>Some notes that run on for a little while so that character data spans more than one short chunk.</Value></String>"];
+    [xml appendString:@"<String><Key>Custom</Key><Value>Custom Value</Value></String>"];
+    [xml appendString:@"<AutoType><Enabled>True</Enabled><DataTransferObfuscation>0</DataTransferObfuscation></AutoType>"];
+
+    if ( withHistory ) {
+        [xml appendFormat:@"<History><Entry><UUID>%@</UUID><Times><LastModificationTime>2025-12-01T00:00:00Z</LastModificationTime></Times><String><Key>Title</Key><Value>Old Title</Value></String><String><Key>Password</Key><Value>old</Value></String></Entry></History>", uuid];
+    }
+
+    [xml appendString:@"</Entry>\n"];
+
+    return xml;
+}
+
+- (NSString*)base64Uuid {
+    uuid_t bytes;
+    [NSUUID.UUID getUUIDBytes:bytes];
+    return [[NSData dataWithBytes:bytes length:sizeof(uuid_t)] base64EncodedStringWithOptions:0];
+}
+
+- (Node*)parse:(NSData*)xml {
+    NSInputStream* stream = [NSInputStream inputStreamWithData:xml];
+    [stream open];
+
+    KeePassXmlNodeBuilder* nodeBuilder = [[KeePassXmlNodeBuilder alloc] initWithAttachments:@[]];
+
+    NSError* decryptionError;
+    NSError* error;
+    RootXmlDomainObject* rootXml = parseXml(kInnerStreamPlainText, NSData.data, XmlProcessingContext.standardV4Context, stream, nil, NO, nodeBuilder, &decryptionError, &error);
+
+    [stream close];
+
+    XCTAssertNotNil(rootXml, @"%@", error);
+    XCTAssertNil(decryptionError);
+
+    return nodeBuilder.rootNode;
+}
+
+- (Node*)parseWithBuilder:(NSData*)xml {
+    return [self parse:xml builder:YES];
+}
+
+- (Node*)parseWithoutBuilder:(NSData*)xml {
+    return [self parse:xml builder:NO];
+}
+
+- (Node*)parse:(NSData*)xml builder:(BOOL)builder {
+    NSInputStream* stream = [NSInputStream inputStreamWithData:xml];
+    [stream open];
+
+    KeePassXmlNodeBuilder* nodeBuilder = builder ? [[KeePassXmlNodeBuilder alloc] initWithAttachments:@[]] : nil;
+
+    NSError* decryptionError;
+    NSError* error;
+    RootXmlDomainObject* rootXml = parseXml(kInnerStreamPlainText, NSData.data, XmlProcessingContext.standardV4Context, stream, nil, NO, nodeBuilder, &decryptionError, &error);
+
+    [stream close];
+
+    XCTAssertNotNil(rootXml, @"%@", error);
+
+    if ( nodeBuilder.rootNode ) {
+        return nodeBuilder.rootNode;
+    }
+
+    Node* ret = [KeePassXmlModelAdaptor toStrongboxModel:rootXml attachments:@[] customIconPool:@{} error:&error];
+    XCTAssertNotNil(ret, @"%@", error);
+
+    return ret;
+}
+
+- (void)assertTree:(Node*)node equals:(Node*)other declaredIds:(NSSet<NSUUID*>*)declaredIds {
+    XCTAssertEqualObjects(node.title, other.title);
+    XCTAssertEqual(node.isGroup, other.isGroup, @"[%@]", node.title);
+
+    if ( [declaredIds containsObject:node.uuid] || [declaredIds containsObject:other.uuid] ) {
+        XCTAssertEqualObjects(node.uuid, other.uuid, @"[%@]", node.title);
+        XCTAssertTrue([node isSyncEqualTo:other isForUIDiffReport:YES checkHistory:YES], @"[%@]", node.title);
+    }
+
+    XCTAssertEqual(node.fields.keePassHistory.count, other.fields.keePassHistory.count, @"[%@]", node.title);
+    XCTAssertEqual(node.children.count, other.children.count, @"[%@]", node.title);
+
+    NSUInteger count = MIN(node.children.count, other.children.count);
+    for ( NSUInteger i = 0; i < count; i++ ) {
+        [self assertTree:node.children[i] equals:other.children[i] declaredIds:declaredIds];
+    }
+}
+
+- (NSString*)base64:(NSUUID*)uuid {
+    uuid_t bytes;
+    [uuid getUUIDBytes:bytes];
+    return [[NSData dataWithBytes:bytes length:sizeof(uuid_t)] base64EncodedStringWithOptions:0];
+}
+
+- (NSString*)group:(NSString*)name uuid:(NSUUID*)uuid body:(NSString*)body {
+    return [NSString stringWithFormat:@"<Group><UUID>%@</UUID><Name>%@</Name><Unknown Attribute=\"1\"><Nested>Kept</Nested></Unknown>%@</Group>", [self base64:uuid], name, body];
+}
+
+- (NSString*)entry:(NSString*)title uuid:(NSUUID*)uuid {
+    return [NSString stringWithFormat:@"<Entry><UUID>%@</UUID><FutureElement>ignored</FutureElement><String><Key>Title</Key><Value>%@</Value></String><String><Key>Password</Key><Value>%@ password</Value></String><History><Entry><UUID>%@</UUID><String><Key>Title</Key><Value>Old %@</Value></String></Entry></History></Entry>", [self base64:uuid], title, title, [self base64:uuid], title];
+}
+
+- (void)testBuilderMatchesXmlModelConversion {
+    NSUUID* rootId = NSUUID.UUID;
+    NSUUID* workId = NSUUID.UUID;
+    NSUUID* sharedId = NSUUID.UUID;
+    NSUUID* entryId = NSUUID.UUID;
+
+    NSString* work = [self group:@"Work" uuid:workId body:[NSString stringWithFormat:@"%@%@%@",
+                                                          [self entry:@"Parent Clash" uuid:workId],
+                                                          [self entry:@"Shared First" uuid:sharedId],
+                                                          [self group:@"Nested Clash" uuid:sharedId body:[self entry:@"Deep" uuid:entryId]]]];
+
+    NSString* home = [self group:@"Home" uuid:entryId body:[NSString stringWithFormat:@"%@%@",
+                                                           [self entry:@"Root Clash" uuid:rootId],
+                                                           [self group:@"Empty Clash" uuid:workId body:@""]]];
+
+    NSString* rootGroup = [self group:@"Root" uuid:rootId body:[NSString stringWithFormat:@"%@%@%@", work, home, [self entry:@"Last" uuid:sharedId]]];
+    NSString* meta = @"<Meta><Generator>Strongbox</Generator><DatabaseName>Duplicates</DatabaseName><UnknownMeta>x</UnknownMeta></Meta>";
+    NSString* root = [NSString stringWithFormat:@"<Root>%@<UnknownRootChild><Group>Not a group</Group></UnknownRootChild><DeletedObjects/></Root>", rootGroup];
+
+    NSSet<NSUUID*>* declaredIds = [NSSet setWithArray:@[rootId, workId, sharedId, entryId]];
+
+    for ( NSNumber* metaFirst in @[@YES, @NO] ) {
+        NSString* document = metaFirst.boolValue ? [NSString stringWithFormat:@"<KeePassFile>%@%@</KeePassFile>", meta, root] : [NSString stringWithFormat:@"<KeePassFile>%@%@</KeePassFile>", root, meta];
+        NSData* xml = [[@"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n" stringByAppendingString:document] dataUsingEncoding:NSUTF8StringEncoding];
+
+        Node* built = [self parseWithBuilder:xml];
+        Node* converted = [self parseWithoutBuilder:xml];
+
+        XCTAssertNotNil(built);
+        XCTAssertNotNil(converted);
+
+        [self assertTree:built equals:converted declaredIds:declaredIds];
+
+        Node* workNode = built.childGroups.firstObject.childGroups.firstObject;
+        XCTAssertEqualObjects(workNode.uuid, workId);
+        XCTAssertNotEqualObjects(workNode.childRecords.firstObject.uuid, workId);
+        XCTAssertEqualObjects(workNode.childRecords.firstObject.fields.keePassHistory.firstObject.uuid, workId);
+        XCTAssertEqualObjects(workNode.childRecords[1].uuid, sharedId);
+    }
+}
+
+- (void)testParsesSyntheticDatabase {
+    Node* root = [self parse:[self syntheticXml]];
+
+    XCTAssertNotNil(root);
+    XCTAssertEqual(root.childGroups.count, 1);
+    XCTAssertEqual(root.allChildGroups.count, kGroupCount + 1);
+    XCTAssertEqual(root.allChildRecords.count, kGroupCount * kEntriesPerGroup);
+
+    Node* first = root.childGroups.firstObject.childGroups.firstObject.childRecords.firstObject;
+
+    XCTAssertEqualObjects(first.title, @"Entry 0-0 Crème Brûlée");
+    XCTAssertEqualObjects(first.fields.password, @"p@ssw0rd-0-<&>");
+    XCTAssertEqual(first.fields.keePassHistory.count, 1);
+    XCTAssertEqual(first.fields.customFields.count, 1);
+    XCTAssertTrue([first.fields.tags containsObject:@"Café"]);
+
+    Node* second = root.childGroups.firstObject.childGroups.firstObject.childRecords[1];
+
+    XCTAssertEqual(second.fields.keePassHistory.count, 0);
+    XCTAssertFalse(second.fields.tags == first.fields.tags);
+}
+
+- (void)testParsePerformance {
+    NSData* xml = [self syntheticXml];
+
+    [self measureBlock:^{
+        Node* root = [self parse:xml];
+        XCTAssertEqual(root.allChildRecords.count, kGroupCount * kEntriesPerGroup);
+    }];
+}
+
+@end
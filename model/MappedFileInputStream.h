@@ -0,0 +1,30 @@
+//
+//  MappedFileInputStream.h
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface MappedFileInputStream : NSInputStream
+
++ (instancetype _Nullable)streamWithURL:(NSURL*)url;
+
+- (instancetype)init NS_UNAVAILABLE;
+- (instancetype _Nullable)initWithURL:(NSURL*)url;
+
+- (BOOL)getBuffer:(uint8_t * _Nullable * _Nonnull)buffer length:(NSUInteger *)len;
+- (BOOL)skip:(NSUInteger)length;
+
+- (NSData*)remainingData;
+
+@property (readonly) NSUInteger length;
+@property (readonly) NSUInteger offset;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,160 @@
+//
+//  MappedFileInputStream.m
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import "MappedFileInputStream.h"
+#import "FileManager.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/clonefile.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+@interface MappedFileInputStream ()
+
+@property uint8_t* mapped;
+@property NSUInteger length;
+@property NSUInteger offset;
+@property NSStreamStatus status;
+
+@end
+
+@implementation MappedFileInputStream
+
++ (instancetype)streamWithURL:(NSURL *)url {
+    return [[MappedFileInputStream alloc] initWithURL:url];
+}
+
+- (instancetype)initWithURL:(NSURL *)url {
+    if ( self = [super init] ) {
+        if ( !url.isFileURL ) {
+            return nil;
+        }
+        
+        NSString* privateCopy = [FileManager.sharedInstance.tmpEncryptionStreamPath stringByAppendingPathComponent:NSUUID.UUID.UUIDString];
+        
+        if ( clonefile(url.fileSystemRepresentation, privateCopy.fileSystemRepresentation, 0) != 0 ) {
+            NSLog(@"Could not clone [%@] for mapping - errno = %d. Will use buffered reads.", url.lastPathComponent, errno);
+            return nil;
+        }
+        
+        int fd = open(privateCopy.fileSystemRepresentation, O_RDONLY);
+        unlink(privateCopy.fileSystemRepresentation);
+        
+        if ( fd < 0 ) {
+            return nil;
+        }
+        
+        struct stat st;
+        if ( fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 ) {
+            close(fd);
+            return nil;
+        }
+        
+        void* mapped = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        
+        if ( mapped == MAP_FAILED ) {
+            NSLog(@"🔴 WARNWARN: Could not map [%@] - errno = %d", url.lastPathComponent, errno);
+            return nil;
+        }
+        
+        madvise(mapped, (size_t)st.st_size, MADV_SEQUENTIAL);
+        
+        _mapped = mapped;
+        _length = (NSUInteger)st.st_size;
+        _status = NSStreamStatusNotOpen;
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    if ( self.mapped ) {
+        munmap(self.mapped, self.length);
+        self.mapped = nil;
+    }
+}
+
+- (void)open {
+    if ( self.status == NSStreamStatusNotOpen ) {
+        self.status = NSStreamStatusOpen;
+    }
+}
+
+- (void)close {
+    self.status = NSStreamStatusClosed;
+}
+
+- (NSStreamStatus)streamStatus {
+    if ( self.status == NSStreamStatusOpen && self.offset >= self.length ) {
+        return NSStreamStatusAtEnd;
+    }
+    
+    return self.status;
+}
+
+- (NSError *)streamError {
+    return nil;
+}
+
+- (NSInteger)read:(uint8_t *)buffer maxLength:(NSUInteger)len {
+    if ( self.status != NSStreamStatusOpen ) {
+        return -1;
+    }
+    
+    NSUInteger toCopy = MIN(len, self.length - self.offset);
+    
+    memcpy(buffer, &self.mapped[self.offset], toCopy);
+    self.offset += toCopy;
+    
+    return toCopy;
+}
+
+- (BOOL)getBuffer:(uint8_t **)buffer length:(NSUInteger *)len {
+    if ( self.status != NSStreamStatusOpen ) {
+        return NO;
+    }
+    
+    *buffer = &self.mapped[self.offset];
+    *len = self.length - self.offset;
+    
+    return YES;
+}
+
+- (BOOL)skip:(NSUInteger)length {
+    if ( self.status != NSStreamStatusOpen || length > self.length - self.offset ) {
+        return NO;
+    }
+    
+    self.offset += length;
+    
+    return YES;
+}
+
+- (BOOL)hasBytesAvailable {
+    return self.status == NSStreamStatusOpen && self.offset < self.length;
+}
+
+- (NSData *)remainingData {
+    NSUInteger start = self.offset;
+    NSUInteger remaining = self.length - start;
+    
+    self.offset = self.length;
+    
+    if ( remaining == 0 ) {
+        return NSData.data;
+    }
+    
+    MappedFileInputStream* mapping = self;
+    
+    return [[NSData alloc] initWithBytesNoCopy:&self.mapped[start] length:remaining deallocator:^(void * _Nonnull bytes, NSUInteger length) {
+        (void)mapping;
+    }];
+}
+
+@end
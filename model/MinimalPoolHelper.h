@@ -14,6 +14,8 @@ NS_ASSUME_NONNULL_BEGIN
 @interface MinimalPoolHelper : NSObject
 
 + (NSArray<DatabaseAttachment*>*)getMinimalAttachmentPool:(Node*)rootNode;
++ (NSArray<DatabaseAttachment*>*)getMinimalAttachmentPool:(Node*)rootNode
+                                             indexByDigest:(NSDictionary<NSString*, NSNumber*>*_Nullable*_Nullable)indexByDigest;
 
 @end
 
@@ -9,41 +9,51 @@
 #import "MinimalPoolHelper.h"
 #import "NSArray+Extensions.h"
 #import "NSData+Extensions.h"
+#import "DatabaseAttachmentStore.h"
 
 @implementation MinimalPoolHelper
 
 + (NSArray<DatabaseAttachment*>*)getMinimalAttachmentPool:(Node*)rootNode {
-    NSArray<Node*>* currentNodesWithAttachments = [rootNode filterChildren:YES predicate:^BOOL(Node * _Nonnull node) {
-        return !node.isGroup && node.fields.attachments.count > 0;
-    }];
-
-    NSArray<Node*>* allNodesWithHistoryNodeAttachments = [rootNode filterChildren:YES predicate:^BOOL(Node * _Nonnull node) {
-        return !node.isGroup && [node.fields.keePassHistory anyMatch:^BOOL(Node * _Nonnull obj) {
-            return obj.fields.attachments.count > 0;
-        }];
-    }];
-
-    NSArray<Node*>* allHistoricalNodesWithAttachments = [allNodesWithHistoryNodeAttachments flatMap:^id _Nonnull(Node * _Nonnull node, NSUInteger idx) {
-        return [node.fields.keePassHistory filter:^BOOL(Node * _Nonnull obj) {
-            return obj.fields.attachments.count > 0;
-        }];
-    }];
-    
-    NSMutableArray<Node*>* allNodesWithAttachments = currentNodesWithAttachments.mutableCopy;
-    [allNodesWithAttachments addObjectsFromArray:allHistoricalNodesWithAttachments];
+    return [self getMinimalAttachmentPool:rootNode indexByDigest:nil];
+}
 
-    NSArray<DatabaseAttachment*>* allAttachments = [allNodesWithAttachments flatMap:^NSArray * _Nonnull(Node * _Nonnull obj, NSUInteger idx) {
-        return obj.fields.attachments.allValues;
-    }];
++ (NSArray<DatabaseAttachment*>*)getMinimalAttachmentPool:(Node*)rootNode
+                                             indexByDigest:(NSDictionary<NSString*, NSNumber*>**)indexByDigest {
+    NSHashTable<DatabaseAttachment*>* seen = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
+    NSMutableArray<DatabaseAttachment*>* pool = NSMutableArray.array;
+    NSMutableDictionary<NSString*, NSNumber*>* index = NSMutableDictionary.dictionary;
+    DatabaseAttachmentStore* store = DatabaseAttachmentStore.sharedInstance;
     
+    void (^addAttachments)(Node*) = ^(Node* node) {
+        for ( DatabaseAttachment* attachment in node.fields.attachments.objectEnumerator ) {
+            if ( [seen containsObject:attachment] ) {
+                continue;
+            }
+            [seen addObject:attachment];
+            
+            DatabaseAttachment* canonical = [store intern:attachment];
+            NSString* digest = canonical.digestHash;
+            
+            if ( index[digest] == nil ) {
+                index[digest] = @(pool.count);
+                [pool addObject:canonical];
+            }
+        }
+    };
     
+    for ( Node* node in rootNode.allChildRecords ) {
+        addAttachments(node);
+        
+        for ( Node* historical in node.fields.keePassHistory ) {
+            addAttachments(historical);
+        }
+    }
     
-    NSMutableDictionary<NSString*, DatabaseAttachment*>* attachmentsByHash = NSMutableDictionary.dictionary;
-    for (DatabaseAttachment* attachment in allAttachments) {
-        attachmentsByHash[attachment.digestHash] = attachment;
+    if ( indexByDigest ) {
+        *indexByDigest = index;
     }
-
-    return attachmentsByHash.allValues;
+    
+    return pool;
 }
 
 @end
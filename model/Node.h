@@ -14,6 +14,12 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+typedef NS_OPTIONS(NSUInteger, NodeDerivedFlags) {
+    kNodeDerivedFlagSearchable = 1 << 0,
+    kNodeDerivedFlagInRecycleBin = 1 << 1,
+    kNodeDerivedFlagInKeePass1Backup = 1 << 2,
+};
+
 @interface Node : NSObject
 
 + (instancetype)rootGroup;
@@ -47,6 +53,15 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, readonly) BOOL isGroup;
 @property (nonatomic, readonly) BOOL childRecordsAllowed;
 @property (readonly) BOOL isSearchable;
+- (BOOL)isSearchable:(NSUInteger)epoch;
+@property (readonly) NodeDerivedFlags derivedFlags;
+
+@property (readonly) NSUInteger derivedFlagsEpoch;
+- (void)invalidateDerivedFlags;
+- (void)refreshDerivedFlags:(NSUUID*_Nullable)recycleBinId keePass1Backup:(Node*_Nullable)keePass1Backup;
+
+@property (readonly) NSUInteger contentGeneration;
+- (void)noteContentVersion:(NSUInteger)version;
 
 @property (nonatomic, strong, readonly, nonnull) NSString *title;
 @property (nonatomic, strong, readonly, nonnull) NSUUID *uuid;
@@ -76,6 +91,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (NSDictionary *)serialize:(SerializationPackage*)serialization; 
 
 - (BOOL)contains:(Node*)test;
+- (BOOL)isChildOf:(Node*)parent;
 - (BOOL)setTitle:(NSString*_Nonnull)title keePassGroupTitleRules:(BOOL)keePassGroupTitleRules;
 - (BOOL)validateAddChild:(Node* _Nonnull)node keePassGroupTitleRules:(BOOL)keePassGroupTitleRules;
 
@@ -83,7 +99,10 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (BOOL)addChild:(Node* _Nonnull)node keePassGroupTitleRules:(BOOL)keePassGroupTitleRules;
 - (BOOL)insertChild:(Node* _Nonnull)node keePassGroupTitleRules:(BOOL)keePassGroupTitleRules atPosition:(NSInteger)atPosition;
+- (BOOL)adoptChild:(Node* _Nonnull)node keePassGroupTitleRules:(BOOL)keePassGroupTitleRules;
+- (BOOL)adoptChildren:(NSArray<Node*>*)nodes keePassGroupTitleRules:(BOOL)keePassGroupTitleRules;
 - (void)removeChild:(Node*)node;
+- (NSUInteger)indexOfChild:(Node*)node;
 
 - (Node*_Nullable)firstOrDefault:(BOOL)recursive predicate:(BOOL (^_Nonnull)(Node* _Nonnull node))predicate;
 - (NSArray<Node*>*_Nonnull)filterChildren:(BOOL)recursive predicate:(BOOL (^_Nullable)(Node* _Nonnull node))predicate;
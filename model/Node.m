@@ -15,8 +15,19 @@
 #import "NSArray+Extensions.h"
 #import "NSDate+Extensions.h"
 #import "NSData+Extensions.h"
+#import <stdatomic.h>
 
-@interface Node ()
+static atomic_uint_fast64_t derivedFlagsEpochSource = 1;
+
+static inline NSUInteger nextDerivedFlagsEpoch(void) {
+    return (NSUInteger)atomic_fetch_add(&derivedFlagsEpochSource, 1);
+}
+
+@interface Node () {
+    atomic_uint_fast64_t _searchableMemo;
+    atomic_uint_fast64_t _derivedFlagsEpoch;
+    atomic_uint_fast64_t _contentGeneration;
+}
 
 @property (nonatomic, strong) NSMutableArray<Node*> *mutableChildren;
 
@@ -131,7 +142,11 @@ NSComparator reverseFinderStyleNodeComparator = ^(id obj1, id obj2)
         _mutableChildren = [NSMutableArray array];
         _uuid = uuid == nil ?  [[NSUUID alloc] init] : uuid;
         _fields = fields == nil ? [[NodeFields alloc] init] : fields;
+        _fields.owner = self;
         _childRecordsAllowed = childRecordsAllowed;
+        atomic_init(&_searchableMemo, 0);
+        atomic_init(&_derivedFlagsEpoch, nextDerivedFlagsEpoch());
+        atomic_init(&_contentGeneration, _fields.contentVersion);
         _icon = nil;
         
         return self;
@@ -466,6 +481,7 @@ keePassGroupTitleRules:(BOOL)allowDuplicateGroupTitle
     }
     
     _title = title;
+    [self.fields invalidatePinYinCache];
     
     return YES;
 }
@@ -526,10 +542,40 @@ keePassGroupTitleRules:(BOOL)allowDuplicateGroupTitle
     }
     
     [_mutableChildren insertObject:node atIndex:atPosition];
+    [self noteContentVersion:(NSUInteger)atomic_load(&node->_contentGeneration)];
+    [self invalidateDerivedFlags];
     
     return YES;
 }
 
+- (BOOL)adoptChild:(Node*)node keePassGroupTitleRules:(BOOL)keePassGroupTitleRules {
+    return [self adoptChildren:@[node] keePassGroupTitleRules:keePassGroupTitleRules];
+}
+
+- (BOOL)adoptChildren:(NSArray<Node*>*)nodes keePassGroupTitleRules:(BOOL)keePassGroupTitleRules {
+    BOOL ret = YES;
+    
+    for ( Node* node in nodes ) {
+        if ( ![self validateAddChild:node keePassGroupTitleRules:keePassGroupTitleRules] ) {
+            ret = NO;
+            continue;
+        }
+        
+        node->_parent = self;
+        
+        for ( Node* historical in node.fields.keePassHistory ) {
+            historical->_parent = self;
+        }
+        
+        [_mutableChildren addObject:node];
+        [self noteContentVersion:(NSUInteger)atomic_load(&node->_contentGeneration)];
+    }
+    
+    [self invalidateDerivedFlags];
+    
+    return ret;
+}
+
 - (BOOL)reorderChild:(Node*)item to:(NSInteger)to keePassGroupTitleRules:(BOOL)keePassGroupTitleRules {
     if (![_mutableChildren containsObject:item]) {
         return NO;
@@ -554,16 +600,34 @@ keePassGroupTitleRules:(BOOL)allowDuplicateGroupTitle
     [node clearParent];
 }
 
+- (NSUInteger)indexOfChild:(Node *)node {
+    if ( _mutableChildren.lastObject == node ) {
+        return _mutableChildren.count - 1;
+    }
+    
+    return [_mutableChildren indexOfObjectIdenticalTo:node];
+}
+
 - (void)clearParent {
+    Node* oldRoot = self.treeRoot;
+    
     _parent = nil;
+    
+    atomic_store(&oldRoot->_derivedFlagsEpoch, nextDerivedFlagsEpoch());
+    atomic_store(&_derivedFlagsEpoch, nextDerivedFlagsEpoch());
 }
 
 - (void)internalPatchParent:(Node*)parent {
+    if ( _parent != nil ) {
+        [self clearParent];
+    }
+    
     _parent = parent;
 }
 
 - (void)sortChildren:(BOOL)ascending {
     _mutableChildren = [[_mutableChildren sortedArrayUsingComparator:ascending ? finderStyleNodeComparator : reverseFinderStyleNodeComparator] mutableCopy];
+    [self invalidateDerivedFlags];
 }
 
 - (BOOL)validateChangeParent:(Node*)parent keePassGroupTitleRules:(BOOL)keePassGroupTitleRules {
@@ -684,21 +748,94 @@ keePassGroupTitleRules:(BOOL)allowDuplicateGroupTitle
 }
 
 - (BOOL)isSearchable {
-    if ( self.isGroup && self.fields.enableSearching != nil ) { 
-        return self.fields.enableSearching.boolValue;
-    }
-    
-    Node* parent = self;
-    while ( parent != nil ) {
-        if ( parent.fields.enableSearching != nil ) { 
-            return parent.fields.enableSearching.boolValue;
+    for ( Node* node = self; node != nil; node = node.parent ) {
+        NSNumber* enableSearching = node.fields.enableSearching;
+        
+        if ( enableSearching != nil ) {
+            return enableSearching.boolValue;
         }
-        parent = parent.parent;
     }
     
     return YES;
 }
 
+- (BOOL)isSearchable:(NSUInteger)epoch {
+    uint_fast64_t memo = atomic_load_explicit(&_searchableMemo, memory_order_relaxed);
+    
+    if ( (memo >> 1) == epoch ) {
+        return memo & 1;
+    }
+    
+    NSNumber* enableSearching = self.fields.enableSearching;
+    Node* parent = self.parent;
+    
+    BOOL ret = enableSearching != nil ? enableSearching.boolValue : (parent ? [parent isSearchable:epoch] : YES);
+    
+    atomic_store_explicit(&_searchableMemo, ((uint_fast64_t)epoch << 1) | (ret ? 1 : 0), memory_order_relaxed);
+    
+    return ret;
+}
+
+- (Node*)treeRoot {
+    Node* root = self;
+    Node* parent;
+    
+    while ( (parent = root.parent) != nil ) {
+        root = parent;
+    }
+    
+    return root;
+}
+
+- (NSUInteger)derivedFlagsEpoch {
+    Node* root = self.treeRoot;
+    return (NSUInteger)atomic_load(&root->_derivedFlagsEpoch);
+}
+
+- (void)invalidateDerivedFlags {
+    Node* root = self.treeRoot;
+    atomic_store(&root->_derivedFlagsEpoch, nextDerivedFlagsEpoch());
+}
+
+- (NSUInteger)contentGeneration {
+    Node* root = self.treeRoot;
+    return (NSUInteger)atomic_load(&root->_contentGeneration);
+}
+
+- (void)noteContentVersion:(NSUInteger)version {
+    Node* root = self.treeRoot;
+    uint_fast64_t current = atomic_load(&root->_contentGeneration);
+    
+    while ( current < version && !atomic_compare_exchange_weak(&root->_contentGeneration, &current, version) ) { }
+}
+
+- (void)refreshDerivedFlags:(NSUUID *)recycleBinId keePass1Backup:(Node *)keePass1Backup {
+    [self refreshDerivedFlags:recycleBinId keePass1Backup:keePass1Backup inherited:kNodeDerivedFlagSearchable];
+}
+
+- (void)refreshDerivedFlags:(NSUUID *)recycleBinId keePass1Backup:(Node *)keePass1Backup inherited:(NodeDerivedFlags)inherited {
+    NodeDerivedFlags flags = inherited;
+    NSNumber* enableSearching = self.fields.enableSearching;
+    
+    if ( enableSearching != nil ) {
+        flags = enableSearching.boolValue ? (flags | kNodeDerivedFlagSearchable) : (flags & ~kNodeDerivedFlagSearchable);
+    }
+    
+    if ( recycleBinId != nil && [self.uuid isEqual:recycleBinId] ) {
+        flags |= kNodeDerivedFlagInRecycleBin;
+    }
+    
+    if ( keePass1Backup == self ) {
+        flags |= kNodeDerivedFlagInKeePass1Backup;
+    }
+    
+    _derivedFlags = flags;
+    
+    for ( Node* child in _mutableChildren ) {
+        [child refreshDerivedFlags:recycleBinId keePass1Backup:keePass1Backup inherited:flags];
+    }
+}
+
 - (BOOL)preOrderTraverse:(BOOL (^)(Node*))function {
     for ( Node* child in self.childRecords ) {
         if ( !function ( child ) ) {
@@ -56,6 +56,7 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, nullable) NSString* defaultAutoTypeSequence;
 @property (nonatomic, nullable) NSNumber* enableAutoType;
 @property (nonatomic, nullable) NSNumber* enableSearching;
+@property (nonatomic, weak, nullable) Node* owner;
 @property (nonatomic, nullable) NSUUID* lastTopVisibleEntry;
 @property (nullable) NSString* foregroundColor;
 @property (nullable) NSString* backgroundColor;
@@ -128,6 +129,14 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (readonly) NSArray<NSString*> *alternativeUrls;
 
+
+
+- (NSString*_Nullable)pinYinForText:(NSString*)text;
+- (void)invalidatePinYinCache;
+- (void)markContentChanged;
+
+@property (readonly) NSUInteger contentVersion;
+
 @end
 
 NS_ASSUME_NONNULL_END
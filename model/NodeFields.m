@@ -19,6 +19,7 @@
 #import "Node.h"
 #import "NSString+Extensions.h"
 #import "Constants.h"
+#import <stdatomic.h>
 
 static NSString* const kOtpAuthScheme = @"otpauth";
 static NSString* const kKeePassXcTotpSeedKey = @"TOTP Seed";
@@ -33,6 +34,8 @@ static NSString* const kOriginalWindowsOtpLengthKey = @"TimeOtp-Length";
 static NSString* const kOriginalWindowsOtpPeriodKey = @"TimeOtp-Period";
 static NSString* const kOriginalWindowsOtpAlgoKey = @"TimeOtp-Algorithm";
 
+static atomic_uint_fast64_t contentVersionSource = 1;
+
 static NSString* const kOriginalWindowsOtpAlgoValueSha256 = @"HMAC-SHA-256";
 static NSString* const kOriginalWindowsOtpAlgoValueSha512 = @"HMAC-SHA-512";
 
@@ -42,6 +45,7 @@ static NSString* const kOriginalWindowsOtpAlgoValueSha512 = @"HMAC-SHA-512";
 @property OTPToken* cachedOtpToken;
 @property MutableOrderedDictionary<NSString*, StringValue*> *mutablCustomFields;
 @property BOOL usingLegacyKeeOtpStyle;
+@property (nullable) NSMutableDictionary<NSString*, id>* pinYinCache;
 
 @end
 
@@ -555,6 +559,7 @@ static NSString* const kOriginalWindowsOtpAlgoValueSha512 = @"HMAC-SHA-512";
     }
     
     self.hasCachedOtpToken = NO; 
+    [self invalidatePinYinCache];
 }
 
 - (void)setNotes:(NSString *)notes {
@@ -564,6 +569,22 @@ static NSString* const kOriginalWindowsOtpAlgoValueSha512 = @"HMAC-SHA-512";
     
     _notes = notes;
     self.hasCachedOtpToken = NO; 
+    [self invalidatePinYinCache];
+}
+
+- (void)setUsername:(NSString *)username {
+    _username = username;
+    [self invalidatePinYinCache];
+}
+
+- (void)setUrl:(NSString *)url {
+    _url = url;
+    [self invalidatePinYinCache];
+}
+
+- (void)setEnableSearching:(NSNumber *)enableSearching {
+    _enableSearching = enableSearching;
+    [self.owner invalidateDerivedFlags];
 }
 
 - (MutableOrderedDictionary<NSString *,StringValue *> *)customFieldsNoEmail {
@@ -581,21 +602,25 @@ static NSString* const kOriginalWindowsOtpAlgoValueSha512 = @"HMAC-SHA-512";
 - (void)setCustomFields:(MutableOrderedDictionary<NSString*, StringValue*>*)customFields {
     self.mutablCustomFields = [customFields clone];
     self.hasCachedOtpToken = NO; 
+    [self invalidatePinYinCache];
 }
 
 - (void)removeAllCustomFields {
     [self.mutablCustomFields removeAllObjects];
     self.hasCachedOtpToken = NO; 
+    [self invalidatePinYinCache];
 }
 
 - (void)removeCustomField:(NSString*)key {
     [self.mutablCustomFields removeObjectForKey:key];
     self.hasCachedOtpToken = NO; 
+    [self invalidatePinYinCache];
 }
 
 - (void)setCustomField:(NSString*)key value:(StringValue*)value {
     self.mutablCustomFields[key] = value;
     self.hasCachedOtpToken = NO; 
+    [self invalidatePinYinCache];
 }
 
 - (void)touch:(BOOL)modified {
@@ -633,7 +658,10 @@ static NSString* const kOriginalWindowsOtpAlgoValueSha512 = @"HMAC-SHA-512";
     
     if (accessed != nil) _accessed = accessed;
     
-    if (modified != nil) _modified = modified;
+    if (modified != nil) {
+        _modified = modified;
+        [self markContentChanged];
+    }
     
     if (locationChanged != nil) _locationChanged = locationChanged;
 
@@ -1155,6 +1183,66 @@ static NSString* const kOriginalWindowsOtpAlgoValueSha512 = @"HMAC-SHA-512";
 
 
 
+- (NSString *)pinYinForText:(NSString *)text {
+    if ( text.length == 0 || [text canBeConvertedToEncoding:NSISOLatin1StringEncoding] ) {
+        return nil;
+    }
+    
+    @synchronized (self) {
+        id cached = self.pinYinCache[text];
+        if ( cached ) {
+            return cached == NSNull.null ? nil : cached;
+        }
+    }
+    
+    NSString* pinYin = text.pinYinLatinized;
+    
+    @synchronized (self) {
+        if ( self.pinYinCache == nil ) {
+            self.pinYinCache = NSMutableDictionary.dictionary;
+        }
+        
+        self.pinYinCache[text] = pinYin ? pinYin : NSNull.null;
+    }
+    
+    return pinYin;
+}
+
+- (void)invalidatePinYinCache {
+    @synchronized (self) {
+        self.pinYinCache = nil;
+    }
+    
+    [self markContentChanged];
+}
+
+- (void)markContentChanged {
+    NSUInteger version = (NSUInteger)atomic_fetch_add(&contentVersionSource, 1) + 1;
+    
+    @synchronized (self) {
+        _contentVersion = version;
+    }
+    
+    [self.owner noteContentVersion:version];
+}
+
+- (void)setExpires:(NSDate *)expires {
+    _expires = expires;
+    [self markContentChanged];
+}
+
+- (void)setTags:(NSMutableSet<NSString *> *)tags {
+    _tags = tags;
+    [self invalidatePinYinCache];
+}
+
+- (void)setAttachments:(NSMutableDictionary<NSString *,DatabaseAttachment *> *)attachments {
+    _attachments = attachments;
+    [self invalidatePinYinCache];
+}
+
+
+
 - (NSString *)description {
     return [NSString stringWithFormat:@"{ username = [%@]\nurl = [%@]\n}", self.username, self.url];
 }
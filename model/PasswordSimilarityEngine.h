@@ -0,0 +1,32 @@
+//
+//  PasswordSimilarityEngine.h
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface PasswordSimilarityEngine : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithStrings:(NSArray<NSString*>*)strings threshold:(double)threshold;
+
+@property (readonly) NSUInteger count;
+@property (readonly) double threshold;
+
+- (BOOL)isSimilar:(NSUInteger)index to:(NSUInteger)other;
+- (void)enumerateSimilarPairsInRange:(NSRange)range usingBlock:(void (^)(NSUInteger index, NSUInteger other))block;
+- (void)enumerateSimilarTo:(NSUInteger)index usingBlock:(void (^)(NSUInteger other))block;
+
+
+
+- (NSUInteger)distanceBetween:(NSUInteger)index and:(NSUInteger)other maxDistance:(NSUInteger)maxDistance;
+
+@end
+
+NS_ASSUME_NONNULL_END
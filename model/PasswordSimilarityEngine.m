@@ -0,0 +1,623 @@
+//
+//  PasswordSimilarityEngine.m
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import "PasswordSimilarityEngine.h"
+
+enum {
+    kMaxBitParallelLength = 64,
+    kAsciiTableSize = 128,
+};
+
+typedef struct {
+    uint64_t ascii[kAsciiTableSize];
+    unichar extraChars[kMaxBitParallelLength];
+    uint64_t extraMasks[kMaxBitParallelLength];
+    NSUInteger extraCount;
+    NSUInteger length;
+} PatternMasks;
+
+static void buildPatternMasks(PatternMasks* p, const unichar* pattern, NSUInteger length) {
+    memset(p->ascii, 0, sizeof(p->ascii));
+    p->extraCount = 0;
+    p->length = length;
+
+    for ( NSUInteger i = 0; i < length; i++ ) {
+        unichar c = pattern[i];
+        uint64_t bit = 1ULL << i;
+
+        if ( c < kAsciiTableSize ) {
+            p->ascii[c] |= bit;
+            continue;
+        }
+
+        NSUInteger j = 0;
+        for ( ; j < p->extraCount; j++ ) {
+            if ( p->extraChars[j] == c ) {
+                break;
+            }
+        }
+
+        if ( j == p->extraCount ) {
+            p->extraChars[j] = c;
+            p->extraMasks[j] = 0;
+            p->extraCount++;
+        }
+
+        p->extraMasks[j] |= bit;
+    }
+}
+
+static inline uint64_t maskForChar(const PatternMasks* p, unichar c) {
+    if ( c < kAsciiTableSize ) {
+        return p->ascii[c];
+    }
+
+    for ( NSUInteger j = 0; j < p->extraCount; j++ ) {
+        if ( p->extraChars[j] == c ) {
+            return p->extraMasks[j];
+        }
+    }
+
+    return 0;
+}
+
+
+
+static NSUInteger bitParallelDistance(const PatternMasks* p, const unichar* text, NSUInteger n, NSUInteger maxDistance) {
+    NSUInteger m = p->length;
+
+    if ( m == 0 ) {
+        return n <= maxDistance ? n : maxDistance + 1;
+    }
+
+    uint64_t pv = ~0ULL;
+    uint64_t mv = 0;
+    uint64_t last = 1ULL << (m - 1);
+    NSUInteger score = m;
+
+    for ( NSUInteger j = 0; j < n; j++ ) {
+        uint64_t eq = maskForChar(p, text[j]);
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+
+        if ( ph & last ) {
+            score++;
+        }
+        else if ( mh & last ) {
+            score--;
+        }
+
+        ph = (ph << 1) | 1;
+        mh = mh << 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        if ( score > maxDistance + (n - 1 - j) ) {
+            return maxDistance + 1;
+        }
+    }
+
+    return score <= maxDistance ? score : maxDistance + 1;
+}
+
+
+
+static NSUInteger bandedDistance(const unichar* a, NSUInteger la, const unichar* b, NSUInteger lb, NSUInteger maxDistance) {
+    NSUInteger outside = maxDistance + 1;
+
+    if ( (la > lb ? la - lb : lb - la) > maxDistance ) {
+        return outside;
+    }
+
+    NSUInteger* prev = malloc(sizeof(NSUInteger) * (lb + 1));
+    NSUInteger* cur = malloc(sizeof(NSUInteger) * (lb + 1));
+
+    for ( NSUInteger j = 0; j <= lb; j++ ) {
+        prev[j] = j <= maxDistance ? j : outside;
+    }
+
+    BOOL exceeded = NO;
+
+    for ( NSUInteger i = 1; i <= la; i++ ) {
+        NSUInteger lo = i > maxDistance ? i - maxDistance : 1;
+        NSUInteger hi = MIN(lb, i + maxDistance);
+
+        cur[lo - 1] = (lo == 1 && i <= maxDistance) ? i : outside;
+        NSUInteger rowMin = cur[lo - 1];
+
+        unichar ca = a[i - 1];
+
+        for ( NSUInteger j = lo; j <= hi; j++ ) {
+            NSUInteger v = prev[j - 1] + (ca == b[j - 1] ? 0 : 1);
+            v = MIN(v, prev[j] + 1);
+            v = MIN(v, cur[j - 1] + 1);
+            v = MIN(v, outside);
+
+            cur[j] = v;
+            rowMin = MIN(rowMin, v);
+        }
+
+        if ( hi < lb ) {
+            cur[hi + 1] = outside;
+        }
+
+        if ( rowMin > maxDistance ) {
+            exceeded = YES;
+            break;
+        }
+
+        NSUInteger* tmp = prev;
+        prev = cur;
+        cur = tmp;
+    }
+
+    NSUInteger result = exceeded ? outside : MIN(prev[lb], outside);
+
+    free(prev);
+    free(cur);
+
+    return result;
+}
+
+static NSInteger maxDistanceForLength(NSUInteger length, double threshold) {
+    if ( length == 0 ) {
+        return -1;
+    }
+
+    NSInteger k = (NSInteger)floor((1.0 - threshold) * length);
+    k = MAX(-1, MIN(k, (NSInteger)length));
+
+    while ( k >= 0 && (1.0 - ((double)k / length)) < threshold ) {
+        k--;
+    }
+
+    while ( k < (NSInteger)length && (1.0 - ((double)(k + 1) / length)) >= threshold ) {
+        k++;
+    }
+
+    return k;
+}
+
+typedef struct {
+    uint32_t key;
+    uint32_t index;
+    uint32_t count;
+} GramPosting;
+
+typedef struct {
+    const unichar* characters;
+    NSUInteger* offsets;
+    NSUInteger* lengths;
+    NSInteger* maxDistances;
+    NSUInteger count;
+    NSUInteger maxLength;
+
+    NSUInteger* gramStart;
+    uint32_t* gramKeys;
+    uint32_t* gramCounts;
+
+    NSUInteger postingKeyCount;
+    uint32_t* postingKeys;
+    NSUInteger* postingStart;
+    uint32_t* postingIndexes;
+    uint32_t* postingCounts;
+
+    NSUInteger* lengthStart;
+    uint32_t* lengthIndexes;
+} SimilarityIndex;
+
+typedef struct {
+    uint32_t* shared;
+    uint32_t* touched;
+    uint32_t* results;
+} SimilarityScratch;
+
+static int compareKeys(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static int comparePostings(const void* a, const void* b) {
+    const GramPosting* x = a;
+    const GramPosting* y = b;
+
+    if ( x->key != y->key ) {
+        return x->key < y->key ? -1 : 1;
+    }
+
+    return x->index < y->index ? -1 : (x->index > y->index ? 1 : 0);
+}
+
+static inline NSUInteger lengthDifference(NSUInteger a, NSUInteger b) {
+    return a > b ? a - b : b - a;
+}
+
+static inline NSInteger requiredSharedGrams(NSUInteger maxLength, NSInteger maxDistance) {
+    return (NSInteger)maxLength - 1 - 2 * maxDistance;
+}
+
+static void buildGramIndex(SimilarityIndex* ix) {
+    NSUInteger totalGrams = 0;
+    for ( NSUInteger i = 0; i < ix->count; i++ ) {
+        totalGrams += ix->lengths[i] > 1 ? ix->lengths[i] - 1 : 0;
+    }
+
+    ix->gramStart = malloc(sizeof(NSUInteger) * (ix->count + 1));
+    ix->gramKeys = malloc(sizeof(uint32_t) * MAX(totalGrams, 1));
+    ix->gramCounts = malloc(sizeof(uint32_t) * MAX(totalGrams, 1));
+
+    uint32_t* scratch = malloc(sizeof(uint32_t) * MAX(ix->maxLength, 1));
+    NSUInteger distinct = 0;
+
+    for ( NSUInteger i = 0; i < ix->count; i++ ) {
+        ix->gramStart[i] = distinct;
+
+        NSUInteger length = ix->lengths[i];
+        if ( length < 2 ) {
+            continue;
+        }
+
+        const unichar* chars = ix->characters + ix->offsets[i];
+        for ( NSUInteger c = 0; c < length - 1; c++ ) {
+            scratch[c] = ((uint32_t)chars[c] << 16) | chars[c + 1];
+        }
+
+        qsort(scratch, length - 1, sizeof(uint32_t), compareKeys);
+
+        for ( NSUInteger c = 0; c < length - 1; c++ ) {
+            if ( c > 0 && scratch[c] == scratch[c - 1] ) {
+                ix->gramCounts[distinct - 1]++;
+            }
+            else {
+                ix->gramKeys[distinct] = scratch[c];
+                ix->gramCounts[distinct] = 1;
+                distinct++;
+            }
+        }
+    }
+
+    ix->gramStart[ix->count] = distinct;
+    free(scratch);
+
+    GramPosting* postings = malloc(sizeof(GramPosting) * MAX(distinct, 1));
+    for ( NSUInteger i = 0; i < ix->count; i++ ) {
+        for ( NSUInteger g = ix->gramStart[i]; g < ix->gramStart[i + 1]; g++ ) {
+            postings[g] = (GramPosting){ ix->gramKeys[g], (uint32_t)i, ix->gramCounts[g] };
+        }
+    }
+
+    qsort(postings, distinct, sizeof(GramPosting), comparePostings);
+
+    ix->postingKeys = malloc(sizeof(uint32_t) * MAX(distinct, 1));
+    ix->postingStart = malloc(sizeof(NSUInteger) * (distinct + 1));
+    ix->postingIndexes = malloc(sizeof(uint32_t) * MAX(distinct, 1));
+    ix->postingCounts = malloc(sizeof(uint32_t) * MAX(distinct, 1));
+    ix->postingKeyCount = 0;
+
+    for ( NSUInteger e = 0; e < distinct; e++ ) {
+        if ( e == 0 || postings[e].key != postings[e - 1].key ) {
+            ix->postingKeys[ix->postingKeyCount] = postings[e].key;
+            ix->postingStart[ix->postingKeyCount] = e;
+            ix->postingKeyCount++;
+        }
+
+        ix->postingIndexes[e] = postings[e].index;
+        ix->postingCounts[e] = postings[e].count;
+    }
+
+    ix->postingStart[ix->postingKeyCount] = distinct;
+    free(postings);
+
+    ix->lengthStart = calloc(ix->maxLength + 2, sizeof(NSUInteger));
+    ix->lengthIndexes = malloc(sizeof(uint32_t) * MAX(ix->count, 1));
+
+    for ( NSUInteger i = 0; i < ix->count; i++ ) {
+        ix->lengthStart[ix->lengths[i] + 1]++;
+    }
+
+    for ( NSUInteger len = 0; len <= ix->maxLength; len++ ) {
+        ix->lengthStart[len + 1] += ix->lengthStart[len];
+    }
+
+    NSUInteger* fill = malloc(sizeof(NSUInteger) * (ix->maxLength + 1));
+    memcpy(fill, ix->lengthStart, sizeof(NSUInteger) * (ix->maxLength + 1));
+
+    for ( NSUInteger i = 0; i < ix->count; i++ ) {
+        ix->lengthIndexes[fill[ix->lengths[i]]++] = (uint32_t)i;
+    }
+
+    free(fill);
+}
+
+static void freeGramIndex(SimilarityIndex* ix) {
+    free(ix->gramStart);
+    free(ix->gramKeys);
+    free(ix->gramCounts);
+    free(ix->postingKeys);
+    free(ix->postingStart);
+    free(ix->postingIndexes);
+    free(ix->postingCounts);
+    free(ix->lengthStart);
+    free(ix->lengthIndexes);
+}
+
+static NSUInteger firstIndexFrom(const uint32_t* indexes, NSUInteger lo, NSUInteger hi, NSUInteger from) {
+    while ( lo < hi ) {
+        NSUInteger mid = lo + (hi - lo) / 2;
+
+        if ( indexes[mid] < from ) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+static NSUInteger postingForKey(const SimilarityIndex* ix, uint32_t key) {
+    NSUInteger lo = 0;
+    NSUInteger hi = ix->postingKeyCount;
+
+    while ( lo < hi ) {
+        NSUInteger mid = lo + (hi - lo) / 2;
+
+        if ( ix->postingKeys[mid] < key ) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+
+    return (lo < ix->postingKeyCount && ix->postingKeys[lo] == key) ? lo : NSNotFound;
+}
+
+static inline const unichar* charactersAt(const SimilarityIndex* ix, NSUInteger index) {
+    return ix->characters + ix->offsets[index];
+}
+
+static NSInteger maxDistanceForPair(const SimilarityIndex* ix, NSUInteger index, NSUInteger other) {
+    NSUInteger la = ix->lengths[index];
+    NSUInteger lb = ix->lengths[other];
+
+    NSInteger maxDistance = ix->maxDistances[MAX(la, lb)];
+
+    if ( maxDistance < 0 || lengthDifference(la, lb) > (NSUInteger)maxDistance ) {
+        return -1;
+    }
+
+    return maxDistance;
+}
+
+static NSUInteger boundedDistance(const SimilarityIndex* ix, NSUInteger index, NSUInteger other, const PatternMasks* pattern, NSUInteger maxDistance) {
+    NSUInteger la = ix->lengths[index];
+    NSUInteger lb = ix->lengths[other];
+    const unichar* a = charactersAt(ix, index);
+    const unichar* b = charactersAt(ix, other);
+
+    if ( la == lb && memcmp(a, b, sizeof(unichar) * la) == 0 ) {
+        return 0;
+    }
+
+    if ( lengthDifference(la, lb) > maxDistance ) {
+        return maxDistance + 1;
+    }
+
+    if ( pattern ) {
+        return bitParallelDistance(pattern, b, lb, maxDistance);
+    }
+
+    if ( la <= kMaxBitParallelLength ) {
+        PatternMasks masks;
+        buildPatternMasks(&masks, a, la);
+        return bitParallelDistance(&masks, b, lb, maxDistance);
+    }
+
+    if ( lb <= kMaxBitParallelLength ) {
+        PatternMasks shorter;
+        buildPatternMasks(&shorter, b, lb);
+        return bitParallelDistance(&shorter, a, la, maxDistance);
+    }
+
+    return bandedDistance(a, la, b, lb, maxDistance);
+}
+
+static NSUInteger similarOthersForRow(const SimilarityIndex* ix, NSUInteger index, NSUInteger from, SimilarityScratch* scratch) {
+    NSUInteger la = ix->lengths[index];
+
+    PatternMasks masks;
+    const PatternMasks* pattern = NULL;
+    if ( la <= kMaxBitParallelLength ) {
+        buildPatternMasks(&masks, charactersAt(ix, index), la);
+        pattern = &masks;
+    }
+
+    NSUInteger touchedCount = 0;
+
+    for ( NSUInteger g = ix->gramStart[index]; g < ix->gramStart[index + 1]; g++ ) {
+        NSUInteger posting = postingForKey(ix, ix->gramKeys[g]);
+        if ( posting == NSNotFound ) {
+            continue;
+        }
+
+        uint32_t ca = ix->gramCounts[g];
+        NSUInteger end = ix->postingStart[posting + 1];
+
+        for ( NSUInteger e = firstIndexFrom(ix->postingIndexes, ix->postingStart[posting], end, from); e < end; e++ ) {
+            uint32_t other = ix->postingIndexes[e];
+
+            if ( other == index || maxDistanceForPair(ix, index, other) < 0 ) {
+                continue;
+            }
+
+            if ( scratch->shared[other] == 0 ) {
+                scratch->touched[touchedCount++] = other;
+            }
+
+            scratch->shared[other] += MIN(ca, ix->postingCounts[e]);
+        }
+    }
+
+    NSUInteger resultCount = 0;
+
+    for ( NSUInteger lb = 1; lb <= ix->maxLength; lb++ ) {
+        NSUInteger maxLength = MAX(la, lb);
+        NSInteger maxDistance = ix->maxDistances[maxLength];
+
+        if ( maxDistance < 0 || lengthDifference(la, lb) > (NSUInteger)maxDistance || requiredSharedGrams(maxLength, maxDistance) > 0 ) {
+            continue;
+        }
+
+        NSUInteger end = ix->lengthStart[lb + 1];
+        for ( NSUInteger e = firstIndexFrom(ix->lengthIndexes, ix->lengthStart[lb], end, from); e < end; e++ ) {
+            uint32_t other = ix->lengthIndexes[e];
+
+            if ( other != index && scratch->shared[other] == 0 && boundedDistance(ix, index, other, pattern, maxDistance) <= (NSUInteger)maxDistance ) {
+                scratch->results[resultCount++] = other;
+            }
+        }
+    }
+
+    for ( NSUInteger t = 0; t < touchedCount; t++ ) {
+        uint32_t other = scratch->touched[t];
+        uint32_t shared = scratch->shared[other];
+        scratch->shared[other] = 0;
+
+        NSInteger maxDistance = maxDistanceForPair(ix, index, other);
+        NSInteger required = requiredSharedGrams(MAX(la, ix->lengths[other]), maxDistance);
+
+        if ( (NSInteger)shared >= required && boundedDistance(ix, index, other, pattern, maxDistance) <= (NSUInteger)maxDistance ) {
+            scratch->results[resultCount++] = other;
+        }
+    }
+
+    return resultCount;
+}
+
+@interface PasswordSimilarityEngine () {
+    SimilarityIndex _index;
+}
+
+@property NSData* characters;
+
+@end
+
+@implementation PasswordSimilarityEngine
+
+- (instancetype)initWithStrings:(NSArray<NSString *> *)strings threshold:(double)threshold {
+    if ( self = [super init] ) {
+        _count = strings.count;
+        _threshold = threshold;
+
+        _index.count = _count;
+        _index.offsets = malloc(sizeof(NSUInteger) * MAX(_count, 1));
+        _index.lengths = malloc(sizeof(NSUInteger) * MAX(_count, 1));
+
+        NSUInteger total = 0;
+        for ( NSUInteger i = 0; i < _count; i++ ) {
+            NSUInteger length = strings[i].length;
+
+            _index.offsets[i] = total;
+            _index.lengths[i] = length;
+            _index.maxLength = MAX(_index.maxLength, length);
+
+            total += length;
+        }
+
+        NSMutableData* characters = [NSMutableData dataWithLength:sizeof(unichar) * MAX(total, 1)];
+        unichar* buffer = characters.mutableBytes;
+
+        for ( NSUInteger i = 0; i < _count; i++ ) {
+            [strings[i] getCharacters:buffer + _index.offsets[i] range:NSMakeRange(0, _index.lengths[i])];
+        }
+
+        _characters = characters;
+        _index.characters = buffer;
+
+        _index.maxDistances = malloc(sizeof(NSInteger) * (_index.maxLength + 1));
+        for ( NSUInteger len = 0; len <= _index.maxLength; len++ ) {
+            _index.maxDistances[len] = maxDistanceForLength(len, threshold);
+        }
+
+        buildGramIndex(&_index);
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    freeGramIndex(&_index);
+
+    free(_index.offsets);
+    free(_index.lengths);
+    free(_index.maxDistances);
+}
+
+- (BOOL)isSimilar:(NSUInteger)index to:(NSUInteger)other {
+    NSInteger maxDistance = maxDistanceForPair(&_index, index, other);
+
+    if ( maxDistance < 0 ) {
+        return NO;
+    }
+
+    return [self distanceBetween:index and:other maxDistance:maxDistance] <= (NSUInteger)maxDistance;
+}
+
+- (void)enumerateSimilarPairsInRange:(NSRange)range usingBlock:(void (^)(NSUInteger, NSUInteger))block {
+    SimilarityScratch scratch = [self allocateScratch];
+
+    for ( NSUInteger index = range.location; index < NSMaxRange(range) && index < self.count; index++ ) {
+        NSUInteger found = similarOthersForRow(&_index, index, index + 1, &scratch);
+
+        for ( NSUInteger r = 0; r < found; r++ ) {
+            block(index, scratch.results[r]);
+        }
+    }
+
+    [self freeScratch:scratch];
+}
+
+- (void)enumerateSimilarTo:(NSUInteger)index usingBlock:(void (^)(NSUInteger))block {
+    SimilarityScratch scratch = [self allocateScratch];
+
+    NSUInteger found = similarOthersForRow(&_index, index, 0, &scratch);
+
+    for ( NSUInteger r = 0; r < found; r++ ) {
+        block(scratch.results[r]);
+    }
+
+    [self freeScratch:scratch];
+}
+
+- (SimilarityScratch)allocateScratch {
+    SimilarityScratch scratch;
+
+    scratch.shared = calloc(MAX(self.count, 1), sizeof(uint32_t));
+    scratch.touched = malloc(sizeof(uint32_t) * MAX(self.count, 1));
+    scratch.results = malloc(sizeof(uint32_t) * MAX(self.count, 1));
+
+    return scratch;
+}
+
+- (void)freeScratch:(SimilarityScratch)scratch {
+    free(scratch.shared);
+    free(scratch.touched);
+    free(scratch.results);
+}
+
+- (NSUInteger)distanceBetween:(NSUInteger)index and:(NSUInteger)other maxDistance:(NSUInteger)maxDistance {
+    return boundedDistance(&_index, index, other, NULL, maxDistance);
+}
+
+@end
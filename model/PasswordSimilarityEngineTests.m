@@ -0,0 +1,92 @@
+//
+//  PasswordSimilarityEngineTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "PasswordSimilarityEngine.h"
+#import "NSString+Levenshtein.h"
+
+static const double kThreshold = 0.75;
+
+@interface PasswordSimilarityEngineTests : XCTestCase
+
+@end
+
+@implementation PasswordSimilarityEngineTests
+
+- (NSArray<NSString*>*)passwords:(NSUInteger)count {
+    static NSString* const kAlphabet = @"abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789!@#$%^&*-_éü€";
+
+    NSMutableArray<NSString*>* bases = NSMutableArray.array;
+    NSMutableArray<NSString*>* ret = NSMutableArray.array;
+
+    for ( NSUInteger i = 0; i < count; i++ ) {
+        if ( bases.count && arc4random_uniform(10) < 3 ) {
+            NSMutableString* mutated = [bases[arc4random_uniform((uint32_t)bases.count)] mutableCopy];
+            NSUInteger edits = 1 + arc4random_uniform(3);
+
+            for ( NSUInteger e = 0; e < edits && mutated.length > 1; e++ ) {
+                NSUInteger at = arc4random_uniform((uint32_t)mutated.length);
+                NSString* c = [kAlphabet substringWithRange:NSMakeRange(arc4random_uniform((uint32_t)kAlphabet.length), 1)];
+                [mutated replaceCharactersInRange:NSMakeRange(at, 1) withString:c];
+            }
+
+            [ret addObject:mutated.copy];
+            continue;
+        }
+
+        NSUInteger length = 6 + arc4random_uniform(arc4random_uniform(10) == 0 ? 90 : 20);
+        NSMutableString* password = NSMutableString.string;
+        for ( NSUInteger c = 0; c < length; c++ ) {
+            [password appendString:[kAlphabet substringWithRange:NSMakeRange(arc4random_uniform((uint32_t)kAlphabet.length), 1)]];
+        }
+
+        [ret addObject:password.copy];
+        [bases addObject:password.copy];
+    }
+
+    return ret;
+}
+
+- (void)testAgreesWithLevenshteinSimilarityRatio {
+    NSArray<NSString*>* passwords = [self passwords:400];
+
+    PasswordSimilarityEngine* engine = [[PasswordSimilarityEngine alloc] initWithStrings:passwords threshold:kThreshold];
+
+    NSMutableSet<NSNumber*>* pairs = NSMutableSet.set;
+    [engine enumerateSimilarPairsInRange:NSMakeRange(0, engine.count) usingBlock:^(NSUInteger index, NSUInteger other) {
+        [pairs addObject:@(index * passwords.count + other)];
+    }];
+
+    XCTAssertGreaterThan(pairs.count, 0);
+
+    for ( NSUInteger i = 0; i < passwords.count; i++ ) {
+        for ( NSUInteger j = i + 1; j < passwords.count; j++ ) {
+            BOOL expected = [passwords[i] levenshteinSimilarityRatio:passwords[j]] >= kThreshold;
+
+            XCTAssertEqual(expected, [pairs containsObject:@(i * passwords.count + j)], @"[%@] vs [%@]", passwords[i], passwords[j]);
+            XCTAssertEqual(expected, [engine isSimilar:i to:j]);
+        }
+    }
+}
+
+- (void)testPerformanceTenThousandPasswords {
+    NSArray<NSString*>* passwords = [self passwords:10000];
+
+    [self measureBlock:^{
+        PasswordSimilarityEngine* engine = [[PasswordSimilarityEngine alloc] initWithStrings:passwords threshold:kThreshold];
+
+        __block NSUInteger similarPairs = 0;
+        [engine enumerateSimilarPairsInRange:NSMakeRange(0, engine.count) usingBlock:^(NSUInteger index, NSUInteger other) {
+            similarPairs++;
+        }];
+
+        XCTAssertGreaterThan(similarPairs, 0);
+    }];
+}
+
+@end
@@ -0,0 +1,21 @@
+//
+//  PipelinedInputStream.h
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface PipelinedInputStream : NSInputStream
+
+- (instancetype)init NS_UNAVAILABLE;
+- (instancetype)initWithStream:(NSInputStream*)stream;
+- (instancetype)initWithStream:(NSInputStream*)stream chunkSize:(NSUInteger)chunkSize maxQueuedChunks:(NSUInteger)maxQueuedChunks;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,238 @@
+//
+//  PipelinedInputStream.m
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import "PipelinedInputStream.h"
+#import "Utils.h"
+
+static const NSUInteger kDefaultChunkSize = 256 * 1024;
+static const NSUInteger kDefaultMaxQueuedChunks = 4;
+
+@interface PipelineStage : NSObject
+
+@property (readonly) NSCondition* condition;
+@property (readonly) NSMutableArray<NSData*>* chunks;
+@property BOOL finished;
+@property BOOL cancelled;
+@property NSError* error;
+
+@end
+
+@implementation PipelineStage
+
+- (instancetype)init {
+    if ( self = [super init] ) {
+        _condition = [[NSCondition alloc] init];
+        _chunks = NSMutableArray.array;
+    }
+    
+    return self;
+}
+
+@end
+
+@interface PipelinedInputStream ()
+
+@property NSInputStream* innerStream;
+@property (readonly) NSUInteger chunkSize;
+@property (readonly) NSUInteger maxQueuedChunks;
+
+@property PipelineStage* stage;
+@property dispatch_semaphore_t producerExited;
+
+@property NSData* workingChunk;
+@property NSUInteger workingChunkOffset;
+
+@property NSError* error;
+
+@end
+
+@implementation PipelinedInputStream
+
+- (instancetype)initWithStream:(NSInputStream *)stream {
+    return [self initWithStream:stream chunkSize:kDefaultChunkSize maxQueuedChunks:kDefaultMaxQueuedChunks];
+}
+
+- (instancetype)initWithStream:(NSInputStream *)stream chunkSize:(NSUInteger)chunkSize maxQueuedChunks:(NSUInteger)maxQueuedChunks {
+    if ( self = [super init] ) {
+        if ( !stream ) {
+            return nil;
+        }
+        
+        _innerStream = stream;
+        _chunkSize = MAX(1, chunkSize);
+        _maxQueuedChunks = MAX(1, maxQueuedChunks);
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    [self close];
+}
+
+- (void)open {
+    if ( !self.innerStream || self.stage ) {
+        return;
+    }
+    
+    [self.innerStream open];
+    
+    PipelineStage* stage = [[PipelineStage alloc] init];
+    NSInputStream* inner = self.innerStream;
+    NSUInteger chunkSize = self.chunkSize;
+    NSUInteger maxQueuedChunks = self.maxQueuedChunks;
+    
+    dispatch_semaphore_t producerExited = dispatch_semaphore_create(0);
+    
+    self.stage = stage;
+    self.producerExited = producerExited;
+    
+    NSThread* producer = [[NSThread alloc] initWithBlock:^{
+        [PipelinedInputStream produce:inner stage:stage chunkSize:chunkSize maxQueuedChunks:maxQueuedChunks];
+        dispatch_semaphore_signal(producerExited);
+    }];
+    
+    producer.name = @"PipelinedInputStream";
+    producer.qualityOfService = NSQualityOfServiceUserInitiated;
+    
+    [producer start];
+}
+
++ (void)produce:(NSInputStream*)inner stage:(PipelineStage*)stage chunkSize:(NSUInteger)chunkSize maxQueuedChunks:(NSUInteger)maxQueuedChunks {
+    while ( YES ) {
+        @autoreleasepool {
+            NSMutableData* chunk = [NSMutableData dataWithLength:chunkSize];
+            NSInteger read = [inner read:chunk.mutableBytes maxLength:chunkSize];
+            
+            [stage.condition lock];
+            
+            if ( read < 0 ) {
+                stage.error = inner.streamError ? inner.streamError : [Utils createNSError:@"Could not read from pipelined inner stream." errorCode:-1];
+            }
+            
+            if ( read <= 0 || stage.cancelled ) {
+                stage.finished = YES;
+                [stage.condition broadcast];
+                [stage.condition unlock];
+                return;
+            }
+            
+            chunk.length = read;
+            
+            while ( stage.chunks.count >= maxQueuedChunks && !stage.cancelled ) {
+                [stage.condition wait];
+            }
+            
+            if ( stage.cancelled ) {
+                stage.finished = YES;
+                [stage.condition unlock];
+                return;
+            }
+            
+            [stage.chunks addObject:chunk];
+            [stage.condition broadcast];
+            [stage.condition unlock];
+        }
+    }
+}
+
+- (NSInteger)read:(uint8_t *)buffer maxLength:(NSUInteger)len {
+    PipelineStage* stage = self.stage;
+    if ( !stage ) {
+        return -1;
+    }
+    
+    NSUInteger bufferWritten = 0;
+    
+    while ( bufferWritten < len ) {
+        if ( self.workingChunk == nil || self.workingChunkOffset == self.workingChunk.length ) {
+            [stage.condition lock];
+            
+            while ( stage.chunks.count == 0 && !stage.finished ) {
+                [stage.condition wait];
+            }
+            
+            if ( stage.chunks.count == 0 ) {
+                NSError* error = stage.error;
+                [stage.condition unlock];
+                
+                self.workingChunk = nil;
+                
+                if ( error ) {
+                    self.error = error;
+                    return -1;
+                }
+                
+                break;
+            }
+            
+            self.workingChunk = stage.chunks.firstObject;
+            self.workingChunkOffset = 0;
+            [stage.chunks removeObjectAtIndex:0];
+            
+            [stage.condition broadcast];
+            [stage.condition unlock];
+        }
+        
+        NSUInteger bytesToCopy = MIN(len - bufferWritten, self.workingChunk.length - self.workingChunkOffset);
+        
+        memcpy(&buffer[bufferWritten], &((const uint8_t*)self.workingChunk.bytes)[self.workingChunkOffset], bytesToCopy);
+        
+        bufferWritten += bytesToCopy;
+        self.workingChunkOffset += bytesToCopy;
+    }
+    
+    return bufferWritten;
+}
+
+- (BOOL)hasBytesAvailable {
+    PipelineStage* stage = self.stage;
+    if ( !stage ) {
+        return NO;
+    }
+    
+    if ( self.workingChunk && self.workingChunkOffset < self.workingChunk.length ) {
+        return YES;
+    }
+    
+    [stage.condition lock];
+    BOOL ret = stage.chunks.count > 0 || !stage.finished;
+    [stage.condition unlock];
+    
+    return ret;
+}
+
+- (void)close {
+    PipelineStage* stage = self.stage;
+    
+    if ( stage ) {
+        [stage.condition lock];
+        stage.cancelled = YES;
+        [stage.chunks removeAllObjects];
+        [stage.condition broadcast];
+        [stage.condition unlock];
+        
+        dispatch_semaphore_wait(self.producerExited, DISPATCH_TIME_FOREVER);
+        
+        self.stage = nil;
+        self.producerExited = nil;
+    }
+    
+    self.workingChunk = nil;
+    
+    if ( self.innerStream ) {
+        [self.innerStream close];
+        self.innerStream = nil;
+    }
+}
+
+- (NSError *)streamError {
+    return self.error;
+}
+
+@end
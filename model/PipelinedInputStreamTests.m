@@ -0,0 +1,273 @@
+//
+//  PipelinedInputStreamTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <CommonCrypto/CommonCrypto.h>
+#import "PipelinedInputStream.h"
+#import "HmacBlockInputStream.h"
+#import "HmacBlockOutputStream.h"
+#import "AesInputStream.h"
+#import "AesOutputStream.h"
+#import "GZipInputStream.h"
+#import "GZIPCompressOutputStream.h"
+#import "Utils.h"
+#include <stdatomic.h>
+
+static const NSUInteger kPlainTextLength = 3 * 1024 * 1024 + 123;
+
+@interface ObservedInputStream : NSInputStream
+
+- (instancetype)initWithData:(NSData*)data;
+
+@property (readonly) BOOL closed;
+@property (readonly) NSUInteger readCount;
+@property (readonly) NSUInteger readsAfterClose;
+@property (readonly) NSUInteger activeReads;
+
+@end
+
+@implementation ObservedInputStream {
+    NSData* _data;
+    NSUInteger _offset;
+    atomic_uint _readCount;
+    atomic_uint _readsAfterClose;
+    atomic_uint _activeReads;
+    atomic_bool _closed;
+}
+
+- (instancetype)initWithData:(NSData *)data {
+    if ( self = [super init] ) {
+        _data = data;
+    }
+    
+    return self;
+}
+
+- (void)open {
+}
+
+- (void)close {
+    atomic_store(&_closed, true);
+}
+
+- (NSInteger)read:(uint8_t *)buffer maxLength:(NSUInteger)len {
+    atomic_fetch_add(&_activeReads, 1);
+    atomic_fetch_add(&_readCount, 1);
+    
+    if ( atomic_load(&_closed) ) {
+        atomic_fetch_add(&_readsAfterClose, 1);
+    }
+    
+    usleep(1000);
+    
+    NSUInteger toRead = MIN(len, _data.length - _offset);
+    memcpy(buffer, (const uint8_t*)_data.bytes + _offset, toRead);
+    _offset += toRead;
+    
+    atomic_fetch_sub(&_activeReads, 1);
+    
+    return toRead;
+}
+
+- (BOOL)hasBytesAvailable {
+    return _offset < _data.length;
+}
+
+- (NSStreamStatus)streamStatus {
+    return atomic_load(&_closed) ? NSStreamStatusClosed : NSStreamStatusOpen;
+}
+
+- (NSError *)streamError {
+    return nil;
+}
+
+- (BOOL)closed {
+    return atomic_load(&_closed);
+}
+
+- (NSUInteger)readCount {
+    return atomic_load(&_readCount);
+}
+
+- (NSUInteger)readsAfterClose {
+    return atomic_load(&_readsAfterClose);
+}
+
+- (NSUInteger)activeReads {
+    return atomic_load(&_activeReads);
+}
+
+@end
+
+@interface PipelinedInputStreamTests : XCTestCase
+
+@property NSData* hmacKey;
+@property NSData* masterKey;
+@property NSData* iv;
+
+@end
+
+@implementation PipelinedInputStreamTests
+
+- (void)setUp {
+    self.hmacKey = getRandomData(64);
+    self.masterKey = getRandomData(kCCKeySizeAES256);
+    self.iv = getRandomData(kCCBlockSizeAES128);
+}
+
+- (NSData*)plainText {
+    NSMutableData* ret = [NSMutableData dataWithLength:kPlainTextLength];
+    arc4random_buf(ret.mutableBytes, ret.length);
+    return ret;
+}
+
+- (NSData*)encode:(NSData*)plainText {
+    NSOutputStream* memory = [NSOutputStream outputStreamToMemory];
+    [memory open];
+    
+    HmacBlockOutputStream* hmac = [[HmacBlockOutputStream alloc] initWithStream:memory hmacKey:self.hmacKey];
+    AesOutputStream* aes = [[AesOutputStream alloc] initToOutputStream:hmac encrypt:YES key:self.masterKey iv:self.iv chainOpensAndCloses:NO];
+    GZIPCompressOutputStream* gzip = [[GZIPCompressOutputStream alloc] initToOutputStream:aes];
+    
+    [hmac open];
+    [aes open];
+    [gzip open];
+    
+    XCTAssertEqual([gzip write:plainText.bytes maxLength:plainText.length], (NSInteger)plainText.length);
+    
+    [gzip close];
+    [aes close];
+    [hmac close];
+    
+    NSData* ret = [memory propertyForKey:NSStreamDataWrittenToMemoryStreamKey];
+    [memory close];
+    
+    return ret;
+}
+
+- (NSInputStream*)decodingStream:(NSInputStream*)source pipelined:(BOOL)pipelined {
+    NSInputStream* stream = [[HmacBlockInputStream alloc] initWithStream:source hmacKey:self.hmacKey];
+    
+    if ( pipelined ) {
+        stream = [[PipelinedInputStream alloc] initWithStream:stream];
+    }
+    
+    stream = [[AesInputStream alloc] initWithStream:stream key:self.masterKey iv:self.iv];
+    
+    if ( pipelined ) {
+        stream = [[PipelinedInputStream alloc] initWithStream:stream];
+    }
+    
+    stream = [[GZipInputStream alloc] initWithStream:stream];
+    
+    if ( pipelined ) {
+        stream = [[PipelinedInputStream alloc] initWithStream:stream];
+    }
+    
+    return stream;
+}
+
+- (NSError*)drain:(NSData*)encoded pipelined:(BOOL)pipelined plainText:(NSData**)plainText {
+    NSInputStream* stream = [self decodingStream:[NSInputStream inputStreamWithData:encoded] pipelined:pipelined];
+    NSMutableData* ret = NSMutableData.data;
+    uint8_t buffer[64 * 1024];
+    
+    [stream open];
+    
+    NSInteger read;
+    while ( (read = [stream read:buffer maxLength:sizeof(buffer)]) > 0 ) {
+        [ret appendBytes:buffer length:read];
+    }
+    
+    NSError* error = read < 0 ? stream.streamError : nil;
+    XCTAssertTrue(read == 0 || error != nil);
+    
+    [stream close];
+    
+    if ( plainText ) {
+        *plainText = ret;
+    }
+    
+    return error;
+}
+
+- (NSUInteger)blockLengthAt:(NSUInteger)offset in:(NSData*)encoded {
+    const uint8_t* length = (const uint8_t*)encoded.bytes + offset + CC_SHA256_DIGEST_LENGTH;
+    return length[0] | (length[1] << 8) | (length[2] << 16) | ((NSUInteger)length[3] << 24);
+}
+
+- (void)assertError:(NSError*)pipelined matches:(NSError*)direct {
+    XCTAssertNotNil(direct);
+    XCTAssertNotNil(pipelined);
+    XCTAssertEqualObjects(pipelined.domain, direct.domain);
+    XCTAssertEqual(pipelined.code, direct.code);
+    XCTAssertEqualObjects(pipelined.localizedDescription, direct.localizedDescription);
+}
+
+- (void)testPipelinedChainMatchesDirectChain {
+    NSData* plainText = [self plainText];
+    NSData* encoded = [self encode:plainText];
+    
+    NSData* direct;
+    NSData* pipelined;
+    
+    XCTAssertNil([self drain:encoded pipelined:NO plainText:&direct]);
+    XCTAssertNil([self drain:encoded pipelined:YES plainText:&pipelined]);
+    
+    XCTAssertEqualObjects(direct, plainText);
+    XCTAssertEqualObjects(pipelined, plainText);
+}
+
+- (void)testHmacBlockFailureSurfacesThroughPipelinedStages {
+    NSMutableData* encoded = [self encode:[self plainText]].mutableCopy;
+    
+    NSUInteger header = CC_SHA256_DIGEST_LENGTH + 4;
+    NSUInteger secondBlock = header + [self blockLengthAt:0 in:encoded];
+    XCTAssertLessThan(secondBlock + header + 10, encoded.length);
+    
+    ((uint8_t*)encoded.mutableBytes)[secondBlock + header + 10] ^= 0x01;
+    
+    NSError* direct = [self drain:encoded pipelined:NO plainText:nil];
+    NSError* pipelined = [self drain:encoded pipelined:YES plainText:nil];
+    
+    [self assertError:pipelined matches:direct];
+    XCTAssertTrue([pipelined.localizedDescription containsString:@"HMAC"], @"%@", pipelined);
+}
+
+- (void)testTruncatedFileSurfacesThroughPipelinedStages {
+    NSData* encoded = [self encode:[self plainText]];
+    NSData* truncated = [encoded subdataWithRange:NSMakeRange(0, encoded.length - 1000)];
+    
+    NSError* direct = [self drain:truncated pipelined:NO plainText:nil];
+    NSError* pipelined = [self drain:truncated pipelined:YES plainText:nil];
+    
+    [self assertError:pipelined matches:direct];
+}
+
+- (void)testCloseMidStreamJoinsAllProducers {
+    ObservedInputStream* source = [[ObservedInputStream alloc] initWithData:[self encode:[self plainText]]];
+    NSInputStream* stream = [self decodingStream:source pipelined:YES];
+    
+    [stream open];
+    
+    uint8_t buffer[4096];
+    XCTAssertEqual([stream read:buffer maxLength:sizeof(buffer)], (NSInteger)sizeof(buffer));
+    
+    [stream close];
+    
+    XCTAssertTrue(source.closed);
+    XCTAssertEqual(source.activeReads, 0);
+    
+    NSUInteger readCount = source.readCount;
+    [NSThread sleepForTimeInterval:0.2];
+    
+    XCTAssertEqual(source.readCount, readCount);
+    XCTAssertEqual(source.readsAfterClose, 0);
+}
+
+@end
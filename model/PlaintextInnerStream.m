@@ -18,4 +18,8 @@
     return ct;
 }
 
+- (void)xorInPlace:(uint8_t *)buffer length:(NSUInteger)length {
+    
+}
+
 @end
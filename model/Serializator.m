@@ -8,6 +8,7 @@
 
 #import "Serializator.h"
 #import "StreamUtils.h"
+#import "MappedFileInputStream.h"
 #import "LoggingInputStream.h"
 #import "Constants.h"
 #import "Utils.h"
@@ -336,7 +337,10 @@ sanityCheckInnerStream:config.sanityCheckInnerStream
      completion:(nonnull DeserializeCompletionBlock)completion {
     DatabaseFormat format = [Serializator getDatabaseFormat:url];
      
-    NSInputStream* stream = [NSInputStream inputStreamWithURL:url];
+    NSInputStream* stream = [MappedFileInputStream streamWithURL:url];
+    if ( !stream ) {
+        stream = [NSInputStream inputStreamWithURL:url];
+    }
     
     
     
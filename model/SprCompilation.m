@@ -11,6 +11,7 @@
 #import "NSDictionary+Extensions.h"
 #import "NSArray+Extensions.h"
 #import "OTPToken+Generation.h"
+#import "SprCompilationCache.h"
 
 static NSString* const kTitleOperation = @"TITLE";
 static NSString* const kUsernameOperation = @"USERNAME";
@@ -44,6 +45,17 @@ static NSString* const kUrlSubOperationPassword = @"PASSWORD";
 
 static NSString* const kSprCompilerRegex = @"\\{(TITLE|USERNAME|URL(:(RMVSCM|HOST|SCM|PORT|PATH|QUERY|USERNAME|USERINFO|PASSWORD))*|PASSWORD|NOTES|TIMEOTP|TOTP|S:(.*?)|REF:((T|U|P|A|N|I)@(T|U|P|A|N|I|O):(.*?))){1}\\}";
 
+@interface SprCompilationTrace : NSObject
+
+@property BOOL isVolatile;
+@property BOOL hasReferences;
+
+@end
+
+@implementation SprCompilationTrace
+
+@end
+
 @implementation SprCompilation
 
 + (instancetype)sharedInstance {
@@ -77,14 +89,40 @@ static NSString* const kSprCompilerRegex = @"\\{(TITLE|USERNAME|URL(:(RMVSCM|HOS
 }
 
 - (NSString *)sprCompile:(NSString *)test node:(Node *)node database:(DatabaseModel*)database error:(NSError **)error {
-    return [self sprCompile:test node:node database:database depth:0 noRecurse:NO error:error];
+    if(!test.length || !node) {
+        return @"";
+    }
+    
+    SprCompilationCache* cache = database.sprCompilationCache;
+    
+    NSString* cached = [cache compiledText:test node:node];
+    if(cached) {
+        return cached;
+    }
+    
+    NSUInteger generation = cache.generation;
+    SprCompilationTrace* trace = [[SprCompilationTrace alloc] init];
+    NSError* compileError = nil;
+    
+    NSString* ret = [self sprCompile:test node:node database:database depth:0 noRecurse:NO trace:trace error:&compileError];
+    
+    if(compileError) {
+        if(error) {
+            *error = compileError;
+        }
+    }
+    else if(ret && !trace.isVolatile) {
+        [cache setCompiled:ret text:test node:node hasReferences:trace.hasReferences generation:generation];
+    }
+    
+    return ret;
 }
 
-- (NSString *)sprCompile:(NSString *)test node:(Node *)node database:(DatabaseModel*)database noRecurse:(BOOL)noRecurse error:(NSError **)error {
-    return [self sprCompile:test node:node database:database depth:0 noRecurse:noRecurse error:error];
+- (NSString *)sprCompile:(NSString *)test node:(Node *)node database:(DatabaseModel*)database noRecurse:(BOOL)noRecurse trace:(SprCompilationTrace*)trace error:(NSError **)error {
+    return [self sprCompile:test node:node database:database depth:0 noRecurse:noRecurse trace:trace error:error];
 }
 
-- (NSString *)sprCompile:(NSString *)test node:(Node *)node database:(DatabaseModel*)database depth:(NSUInteger)depth noRecurse:(BOOL)noRecurse error:(NSError **)error {
+- (NSString *)sprCompile:(NSString *)test node:(Node *)node database:(DatabaseModel*)database depth:(NSUInteger)depth noRecurse:(BOOL)noRecurse trace:(SprCompilationTrace*)trace error:(NSError **)error {
     if(!test.length || !node) {
         return @"";
     }
@@ -95,7 +133,7 @@ static NSString* const kSprCompilerRegex = @"\\{(TITLE|USERNAME|URL(:(RMVSCM|HOS
     if(match) {
         if(depth < 10 && !noRecurse) { 
             NSError* matchError;
-            NSString* compiled = [self sprCompileRegexMatch:match test:test node:node database:database error:&matchError];
+            NSString* compiled = [self sprCompileRegexMatch:match test:test node:node database:database trace:trace error:&matchError];
 
             if(!compiled) {
                 NSLog(@"Failed to compile Error: [%@]", matchError);
@@ -107,7 +145,7 @@ static NSString* const kSprCompilerRegex = @"\\{(TITLE|USERNAME|URL(:(RMVSCM|HOS
                 ret = [test stringByReplacingCharactersInRange:match.range withString:compiled];
                 
                 if(depth < 10 && !noRecurse) { 
-                    ret = [self sprCompile:ret node:node database:database depth:depth+1 noRecurse:noRecurse error:error];
+                    ret = [self sprCompile:ret node:node database:database depth:depth+1 noRecurse:noRecurse trace:trace error:error];
                 }
                 else {
                     NSLog(@"Depth/Recurse Limit Exceeded in SPR Compile... Will not attempt Further.");
@@ -122,7 +160,7 @@ static NSString* const kSprCompilerRegex = @"\\{(TITLE|USERNAME|URL(:(RMVSCM|HOS
     return ret;
 }
 
-- (NSString*)sprCompileRegexMatch:(NSTextCheckingResult*)match test:(NSString*)test node:(Node*)node database:(DatabaseModel*)database error:(NSError**)error {
+- (NSString*)sprCompileRegexMatch:(NSTextCheckingResult*)match test:(NSString*)test node:(Node*)node database:(DatabaseModel*)database trace:(SprCompilationTrace*)trace error:(NSError**)error {
 
 
 
@@ -162,6 +200,7 @@ static NSString* const kSprCompilerRegex = @"\\{(TITLE|USERNAME|URL(:(RMVSCM|HOS
         return node.fields.notes;
     }
     else if([operation caseInsensitiveCompare:kKPXC_TOTP_Operation]  == NSOrderedSame || [operation caseInsensitiveCompare:kWinKP_TOTP_Operation] == NSOrderedSame) {
+        trace.isVolatile = YES;
         return node.fields.otpToken.password;
     }
     else if([operation hasPrefix:kCustomFieldOperation]) {
@@ -176,10 +215,10 @@ static NSString* const kSprCompilerRegex = @"\\{(TITLE|USERNAME|URL(:(RMVSCM|HOS
         }
     }
     else if([operation hasPrefix:kUrlOperation]) {
-        return [self sprCompileUrl:match test:test node:node database:database error:error]; 
+        return [self sprCompileUrl:match test:test node:node database:database trace:trace error:error]; 
     }
     else if([operation hasPrefix:kReferenceOperation]) {
-        return [self sprCompileReference:match test:test node:node database:database error:error];
+        return [self sprCompileReference:match test:test node:node database:database trace:trace error:error];
     }
     else {
         if(error) {
@@ -191,7 +230,7 @@ static NSString* const kSprCompilerRegex = @"\\{(TITLE|USERNAME|URL(:(RMVSCM|HOS
     return nil;
 }
 
--(NSString*)sprCompileReference:(NSTextCheckingResult*)match test:(NSString*)test node:(Node*)node database:(DatabaseModel*)database error:(NSError**)error {
+-(NSString*)sprCompileReference:(NSTextCheckingResult*)match test:(NSString*)test node:(Node*)node database:(DatabaseModel*)database trace:(SprCompilationTrace*)trace error:(NSError**)error {
     NSString* desiredField = ([match rangeAtIndex:6].location == NSNotFound) ? nil : [test substringWithRange:[match rangeAtIndex:6]];
     NSString* searchByField = ([match rangeAtIndex:7].location == NSNotFound) ? nil : [test substringWithRange:[match rangeAtIndex:7]];
     NSString* searchTarget = ([match rangeAtIndex:8].location == NSNotFound) ? nil : [test substringWithRange:[match rangeAtIndex:8]];
@@ -205,6 +244,8 @@ static NSString* const kSprCompilerRegex = @"\\{(TITLE|USERNAME|URL(:(RMVSCM|HOS
     
 
     
+    trace.hasReferences = YES;
+    
     Node* target = [self findReferencedNode:searchByField searchTarget:searchTarget database:database error:error];
     
     if(!target) {
@@ -252,50 +293,54 @@ static NSString* const kSprCompilerRegex = @"\\{(TITLE|USERNAME|URL(:(RMVSCM|HOS
         
         target = [database getItemById:uuidTarget];
     }
-    else if([searchByField isEqualToString:kReferenceFieldTitle]) {
-        target = [database.rootNode firstOrDefault:YES predicate:^BOOL(Node * _Nonnull node) {
-            return !node.isGroup && [node.title localizedCaseInsensitiveContainsString:searchTarget];
-        }];
-    }
-    else if([searchByField isEqualToString:kReferenceFieldUsername]) {
-        target = [database.rootNode firstOrDefault:YES predicate:^BOOL(Node * _Nonnull node) {
-            return !node.isGroup && [node.fields.username localizedCaseInsensitiveContainsString:searchTarget];
-        }];
-    }
-    else if([searchByField isEqualToString:kReferenceFieldPassword]) {
-        target = [database.rootNode firstOrDefault:YES predicate:^BOOL(Node * _Nonnull node) {
-            return !node.isGroup && [node.fields.password localizedCaseInsensitiveContainsString:searchTarget];
-        }];
-    }
-    else if([searchByField isEqualToString:kReferenceFieldUrl]) {
-        target = [database.rootNode firstOrDefault:YES predicate:^BOOL(Node * _Nonnull node) {
-            return !node.isGroup && [node.fields.url localizedCaseInsensitiveContainsString:searchTarget];
-        }];
-    }
-    else if([searchByField isEqualToString:kReferenceFieldNotes]) {
-        target = [database.rootNode firstOrDefault:YES predicate:^BOOL(Node * _Nonnull node) {
-            return !database.rootNode.isGroup && [node.fields.notes localizedCaseInsensitiveContainsString:searchTarget];
-        }];
-    }
-    else if([searchByField isEqualToString:kReferenceFieldCustomFields]) {
-        target = [database.rootNode firstOrDefault:YES predicate:^BOOL(Node * _Nonnull node) {
-            if(node.isGroup) {
-                return NO;
-            }
-            else {
+    else {
+        BOOL (^predicate)(Node* node) = nil;
+        
+        if([searchByField isEqualToString:kReferenceFieldTitle]) {
+            predicate = ^BOOL(Node * _Nonnull node) {
+                return [node.title localizedCaseInsensitiveContainsString:searchTarget];
+            };
+        }
+        else if([searchByField isEqualToString:kReferenceFieldUsername]) {
+            predicate = ^BOOL(Node * _Nonnull node) {
+                return [node.fields.username localizedCaseInsensitiveContainsString:searchTarget];
+            };
+        }
+        else if([searchByField isEqualToString:kReferenceFieldPassword]) {
+            predicate = ^BOOL(Node * _Nonnull node) {
+                return [node.fields.password localizedCaseInsensitiveContainsString:searchTarget];
+            };
+        }
+        else if([searchByField isEqualToString:kReferenceFieldUrl]) {
+            predicate = ^BOOL(Node * _Nonnull node) {
+                return [node.fields.url localizedCaseInsensitiveContainsString:searchTarget];
+            };
+        }
+        else if([searchByField isEqualToString:kReferenceFieldNotes]) {
+            predicate = ^BOOL(Node * _Nonnull node) {
+                return [node.fields.notes localizedCaseInsensitiveContainsString:searchTarget];
+            };
+        }
+        else if([searchByField isEqualToString:kReferenceFieldCustomFields]) {
+            predicate = ^BOOL(Node * _Nonnull node) {
                 StringValue* strValue = [node.fields.customFields.allValues firstOrDefault:^BOOL(StringValue * _Nonnull obj) {
                     return [obj.value localizedCaseInsensitiveContainsString:searchTarget];
                 }];
                 
                 return strValue != nil;
-            }
-        }];
+            };
+        }
+        
+        if(predicate) {
+            NSString* key = [NSString stringWithFormat:@"%@@%@", searchByField, searchTarget];
+            target = [database.sprCompilationCache findReferencedNode:key predicate:predicate];
+        }
     }
     
     return target;
 }
 
--(NSString*)sprCompileUrl:(NSTextCheckingResult*)match test:(NSString*)test node:(Node*)node database:(DatabaseModel*)database error:(NSError**)error {
+-(NSString*)sprCompileUrl:(NSTextCheckingResult*)match test:(NSString*)test node:(Node*)node database:(DatabaseModel*)database trace:(SprCompilationTrace*)trace error:(NSError**)error {
     NSString* subOperation = ([match rangeAtIndex:3].location == NSNotFound) ? nil : [test substringWithRange:[match rangeAtIndex:3]];
     
     
@@ -308,7 +353,7 @@ static NSString* const kSprCompilerRegex = @"\\{(TITLE|USERNAME|URL(:(RMVSCM|HOS
     
     
     
-    NSString* dereferencedUrl = [self sprCompile:node.fields.url node:node database:database noRecurse:YES error:error];
+    NSString* dereferencedUrl = [self sprCompile:node.fields.url node:node database:database noRecurse:YES trace:trace error:error];
     NSURLComponents* components = [NSURLComponents componentsWithString:dereferencedUrl];
     
     if([subOperation isEqualToString:kUrlSubOperationScheme]) {
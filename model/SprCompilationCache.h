@@ -0,0 +1,31 @@
+//
+//  SprCompilationCache.h
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "Node.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface SprCompilationCache : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithRootNode:(Node*)rootNode;
+
+@property (readonly) NSUInteger generation;
+
+- (Node*_Nullable)findReferencedNode:(NSString*)key predicate:(BOOL (^)(Node* node))predicate;
+
+
+
+- (NSString*_Nullable)compiledText:(NSString*)text node:(Node*)node;
+- (void)setCompiled:(NSString*)compiled text:(NSString*)text node:(Node*)node hasReferences:(BOOL)hasReferences generation:(NSUInteger)generation;
+
+@end
+
+NS_ASSUME_NONNULL_END
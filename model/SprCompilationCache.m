@@ -0,0 +1,144 @@
+//
+//  SprCompilationCache.m
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import "SprCompilationCache.h"
+
+@interface SprCompiledEntry : NSObject
+
+@property NSString* compiled;
+@property NSUInteger generation;
+@property BOOL hasReferences;
+
+@end
+
+@implementation SprCompiledEntry
+
+- (BOOL)isValidForNode:(Node*)node generation:(NSUInteger)generation {
+    if ( node.fields.contentVersion > self.generation ) {
+        return NO;
+    }
+
+    return !self.hasReferences || self.generation == generation;
+}
+
+@end
+
+@interface SprCompilationCache ()
+
+@property (readonly, weak) Node* rootNode;
+@property (readonly) NSArray<Node*>* entries;
+@property NSUInteger referencesGeneration;
+@property (readonly) NSMutableDictionary<NSString*, id>* references;
+@property (readonly) NSMapTable<Node*, NSMutableDictionary<NSString*, SprCompiledEntry*>*>* compiled;
+
+@end
+
+@implementation SprCompilationCache
+
+- (instancetype)initWithRootNode:(Node *)rootNode {
+    if ( self = [super init] ) {
+        NSMutableArray<Node*>* entries = NSMutableArray.array;
+        [SprCompilationCache collectEntries:rootNode into:entries];
+
+        _rootNode = rootNode;
+        _entries = entries.copy;
+        _referencesGeneration = rootNode.contentGeneration;
+        _references = NSMutableDictionary.dictionary;
+        _compiled = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                          valueOptions:NSPointerFunctionsStrongMemory];
+    }
+
+    return self;
+}
+
++ (void)collectEntries:(Node*)group into:(NSMutableArray<Node*>*)entries {
+    NSArray<Node*>* children = group.children;
+
+    for ( Node* child in children ) {
+        if ( !child.isGroup ) {
+            [entries addObject:child];
+        }
+    }
+
+    for ( Node* child in children ) {
+        if ( child.isGroup ) {
+            [SprCompilationCache collectEntries:child into:entries];
+        }
+    }
+}
+
+
+
+- (Node *)findReferencedNode:(NSString *)key predicate:(BOOL (^)(Node * _Nonnull))predicate {
+    NSUInteger generation = self.generation;
+
+    @synchronized (self) {
+        if ( self.referencesGeneration != generation ) {
+            [self.references removeAllObjects];
+            self.referencesGeneration = generation;
+        }
+
+        id cached = self.references[key];
+
+        if ( cached ) {
+            return cached == NSNull.null ? nil : cached;
+        }
+    }
+
+    Node* found = nil;
+
+    for ( Node* entry in self.entries ) {
+        if ( predicate(entry) ) {
+            found = entry;
+            break;
+        }
+    }
+
+    @synchronized (self) {
+        if ( self.referencesGeneration == generation ) {
+            self.references[key] = found ? found : NSNull.null;
+        }
+    }
+
+    return found;
+}
+
+
+
+- (NSString *)compiledText:(NSString *)text node:(Node *)node {
+    @synchronized (self) {
+        SprCompiledEntry* entry = [[self.compiled objectForKey:node] objectForKey:text];
+
+        return [entry isValidForNode:node generation:self.generation] ? entry.compiled : nil;
+    }
+}
+
+- (NSUInteger)generation {
+    return self.rootNode.contentGeneration;
+}
+
+- (void)setCompiled:(NSString *)compiled text:(NSString *)text node:(Node *)node hasReferences:(BOOL)hasReferences generation:(NSUInteger)generation {
+    SprCompiledEntry* entry = [[SprCompiledEntry alloc] init];
+
+    entry.compiled = compiled;
+    entry.generation = generation;
+    entry.hasReferences = hasReferences;
+
+    @synchronized (self) {
+        NSMutableDictionary<NSString*, SprCompiledEntry*>* byText = [self.compiled objectForKey:node];
+
+        if ( byText == nil ) {
+            byText = NSMutableDictionary.dictionary;
+            [self.compiled setObject:byText forKey:node];
+        }
+
+        byText[text] = entry;
+    }
+}
+
+@end
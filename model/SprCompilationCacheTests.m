@@ -0,0 +1,68 @@
+//
+//  SprCompilationCacheTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "DatabaseModel.h"
+#import "SprCompilation.h"
+
+@interface SprCompilationCacheTests : XCTestCase
+
+@end
+
+@implementation SprCompilationCacheTests
+
+- (Node*)addEntry:(NSString*)title username:(NSString*)username parent:(Node*)parent database:(DatabaseModel*)database {
+    Node* entry = [[Node alloc] initAsRecord:title parent:parent];
+    entry.fields.username = username;
+    XCTAssertTrue([database addChildren:@[entry] destination:parent]);
+    return entry;
+}
+
+- (NSString*)compile:(NSString*)text node:(Node*)node database:(DatabaseModel*)database {
+    NSError* error;
+    NSString* ret = [SprCompilation.sharedInstance sprCompile:text node:node database:database error:&error];
+    XCTAssertNil(error);
+    return ret;
+}
+
+- (void)testReferencesFollowEditsMadeWithoutTouching {
+    DatabaseModel* database = [[DatabaseModel alloc] initWithFormat:kKeePass4];
+    Node* root = database.effectiveRootGroup;
+
+    Node* first = [self addEntry:@"First" username:@"first-user" parent:root database:database];
+    Node* second = [self addEntry:@"Second Target" username:@"second-user" parent:root database:database];
+    Node* source = [self addEntry:@"Source" username:@"source-user" parent:root database:database];
+
+    NSString* reference = @"{REF:U@T:Target}";
+    NSString* missing = @"{REF:U@T:Nowhere}";
+
+    XCTAssertEqualObjects([self compile:reference node:source database:database], @"second-user");
+    XCTAssertEqualObjects([self compile:missing node:source database:database], missing);
+
+    [first setTitle:@"First Target" keePassGroupTitleRules:YES];
+    XCTAssertEqualObjects([self compile:reference node:source database:database], @"first-user");
+
+    second.fields.username = @"renamed-user";
+    [first setTitle:@"First" keePassGroupTitleRules:YES];
+    XCTAssertEqualObjects([self compile:reference node:source database:database], @"renamed-user");
+
+    [second setTitle:@"Nowhere" keePassGroupTitleRules:YES];
+    XCTAssertEqualObjects([self compile:missing node:source database:database], @"renamed-user");
+}
+
+- (void)testCompiledTextFollowsOwnFieldEdits {
+    DatabaseModel* database = [[DatabaseModel alloc] initWithFormat:kKeePass4];
+    Node* entry = [self addEntry:@"Entry" username:@"before" parent:database.effectiveRootGroup database:database];
+
+    XCTAssertEqualObjects([self compile:@"{USERNAME}@{TITLE}" node:entry database:database], @"before@Entry");
+
+    entry.fields.username = @"after";
+    XCTAssertEqualObjects([self compile:@"{USERNAME}@{TITLE}" node:entry database:database], @"after@Entry");
+}
+
+@end
@@ -0,0 +1,113 @@
+//
+//  Utf8XmlWriterTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "Utf8XmlWriter.h"
+#import "XMLWriter.h"
+
+@interface Utf8XmlWriterTests : XCTestCase
+
+@end
+
+@implementation Utf8XmlWriterTests
+
+- (void)writeEntries:(NSUInteger)entries
+        startElement:(void (^)(NSString* name))startElement
+          characters:(void (^)(NSString* text))characters
+          endElement:(void (^)(void))endElement {
+    NSArray<NSString*>* keys = @[@"Title", @"UserName", @"Password", @"URL", @"Notes"];
+
+    startElement(@"KeePassFile");
+    startElement(@"Root");
+    startElement(@"Group");
+
+    for ( NSUInteger i = 0; i < entries; i++ ) {
+        @autoreleasepool {
+            startElement(@"Entry");
+
+            startElement(@"UUID");
+            characters(@"hJsnMq9bRk+5lWkWlPZb4A==");
+            endElement();
+
+            for ( NSString* key in keys ) {
+                startElement(@"String");
+                startElement(@"Key");
+                characters(key);
+                endElement();
+                startElement(@"Value");
+                characters([NSString stringWithFormat:@"%@ <%lu> & \"Ünïcødé\" 'value' for entry number %lu 😀\t", key, (unsigned long)i, (unsigned long)i]);
+                endElement();
+                endElement();
+            }
+
+            startElement(@"Times");
+            startElement(@"LastModificationTime");
+            characters(@"2jW/2Q4AAAA=");
+            endElement();
+            endElement();
+
+            endElement();
+        }
+    }
+
+    endElement();
+    endElement();
+    endElement();
+}
+
+- (NSData*)legacyXml:(NSUInteger)entries {
+    XMLWriter* legacy = [[XMLWriter alloc] init];
+
+    [legacy writeStartDocumentWithEncodingAndVersion:@"UTF-8" version:@"1.0"];
+    [self writeEntries:entries
+          startElement:^(NSString *name) { [legacy writeStartElement:name]; }
+            characters:^(NSString *text) { [legacy writeCharacters:text]; }
+            endElement:^{ [legacy writeEndElement]; }];
+    [legacy writeEndDocument];
+
+    return legacy.toData;
+}
+
+- (NSData*)utf8Xml:(NSUInteger)entries {
+    NSOutputStream* stream = [NSOutputStream outputStreamToMemory];
+    [stream open];
+
+    Utf8XmlWriter* writer = [[Utf8XmlWriter alloc] initWithOutputStream:stream];
+
+    [writer writeStartDocumentWithEncodingAndVersion:@"UTF-8" version:@"1.0"];
+    [self writeEntries:entries
+          startElement:^(NSString *name) { [writer writeStartElement:name]; }
+            characters:^(NSString *text) { [writer writeCharacters:text]; }
+            endElement:^{ [writer writeEndElement]; }];
+    [writer writeEndDocument];
+
+    XCTAssertNil(writer.streamError);
+
+    NSData* ret = [stream propertyForKey:NSStreamDataWrittenToMemoryStreamKey];
+    [stream close];
+
+    return ret;
+}
+
+- (void)testMatchesXmlWriterOutput {
+    XCTAssertEqualObjects([self utf8Xml:250], [self legacyXml:250]);
+}
+
+- (void)testLegacyWriterPerformance {
+    [self measureBlock:^{
+        XCTAssertGreaterThan([self legacyXml:20000].length, 0);
+    }];
+}
+
+- (void)testUtf8WriterPerformance {
+    [self measureBlock:^{
+        XCTAssertGreaterThan([self utf8Xml:20000].length, 0);
+    }];
+}
+
+@end
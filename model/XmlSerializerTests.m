@@ -0,0 +1,140 @@
+//
+//  XmlSerializerTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "XmlSerializer.h"
+#import "XmlStrongboxNodeModelAdaptor.h"
+#import "XmlProcessingContext.h"
+#import "KdbxSerializationCommon.h"
+#import "KeePassXmlNodeBuilder.h"
+#import "KeePassConstants.h"
+#import "InnerRandomStreamFactory.h"
+#import "StringValue.h"
+
+static const NSUInteger kGroupCount = 8;
+static const NSUInteger kEntriesPerGroup = 30;
+
+@interface XmlSerializerTests : XCTestCase
+
+@end
+
+@implementation XmlSerializerTests
+
+- (Node*)database {
+    Node* root = Node.rootWithDefaultKeePassEffectiveRootGroup;
+    Node* keePassRoot = root.childGroups.firstObject;
+
+    for ( NSUInteger g = 0; g < kGroupCount; g++ ) {
+        Node* group = [[Node alloc] initAsGroup:[NSString stringWithFormat:@"Group %lu", (unsigned long)g] parent:keePassRoot keePassGroupTitleRules:YES uuid:nil];
+        [keePassRoot addChild:group keePassGroupTitleRules:YES];
+
+        for ( NSUInteger e = 0; e < kEntriesPerGroup; e++ ) {
+            Node* entry = [[Node alloc] initAsRecord:[NSString stringWithFormat:@"Entry %lu-%lu", (unsigned long)g, (unsigned long)e] parent:group];
+
+            entry.fields.username = [NSString stringWithFormat:@"user%lu", (unsigned long)e];
+            entry.fields.password = [NSString stringWithFormat:@"p@ssw0rd-%lu-%lu-Crème Brûlée 😀", (unsigned long)g, (unsigned long)e];
+            [entry.fields setCustomField:@"Secret" value:[StringValue valueWithString:[@"" stringByPaddingToLength:e * 7 withString:@"s3cr3t" startingAtIndex:0] protected:YES]];
+
+            [group addChild:entry keePassGroupTitleRules:YES];
+        }
+    }
+
+    return root;
+}
+
+- (NSData*)serialize:(KeePassGroup*)rootGroup streamId:(uint32_t)streamId key:(NSData*)key concurrently:(BOOL)concurrently {
+    NSOutputStream* stream = [NSOutputStream outputStreamToMemory];
+    [stream open];
+
+    XmlSerializer* serializer = [[XmlSerializer alloc] initWithProtectedStream:[InnerRandomStreamFactory getStream:streamId key:key]
+                                                                      v4Format:YES
+                                                                   prettyPrint:NO
+                                                                  outputStream:stream];
+
+    [serializer beginDocument];
+    XCTAssertTrue([serializer beginElement:kKeePassFileElementName]);
+    XCTAssertTrue([serializer beginElement:kRootElementName]);
+    XCTAssertTrue([rootGroup writeXml:serializer concurrently:concurrently]);
+    [serializer endElement];
+    [serializer endElement];
+    [serializer endDocument];
+
+    XCTAssertNil(serializer.streamError);
+
+    NSData* ret = [stream propertyForKey:NSStreamDataWrittenToMemoryStreamKey];
+    [stream close];
+
+    return ret;
+}
+
+- (Node*)parse:(NSData*)xml streamId:(uint32_t)streamId key:(NSData*)key {
+    NSInputStream* stream = [NSInputStream inputStreamWithData:xml];
+    [stream open];
+
+    KeePassXmlNodeBuilder* nodeBuilder = [[KeePassXmlNodeBuilder alloc] initWithAttachments:@[]];
+
+    NSError* decryptionError;
+    NSError* error;
+    RootXmlDomainObject* rootXml = parseXml(streamId, key, XmlProcessingContext.standardV4Context, stream, nil, YES, nodeBuilder, &decryptionError, &error);
+
+    [stream close];
+
+    XCTAssertNotNil(rootXml, @"%@", error);
+    XCTAssertNil(decryptionError);
+
+    return nodeBuilder.rootNode;
+}
+
+- (void)assertTree:(Node*)node equals:(Node*)other {
+    XCTAssertEqualObjects(node.title, other.title);
+    XCTAssertEqualObjects(node.uuid, other.uuid, @"[%@]", node.title);
+
+    if ( !node.isGroup ) {
+        XCTAssertEqualObjects(node.fields.password, other.fields.password, @"[%@]", node.title);
+        XCTAssertEqualObjects(node.fields.customFields[@"Secret"].value, other.fields.customFields[@"Secret"].value, @"[%@]", node.title);
+    }
+
+    XCTAssertEqual(node.children.count, other.children.count, @"[%@]", node.title);
+
+    NSUInteger count = MIN(node.children.count, other.children.count);
+    for ( NSUInteger i = 0; i < count; i++ ) {
+        [self assertTree:node.children[i] equals:other.children[i]];
+    }
+}
+
+- (void)assertConcurrentMatchesSequential:(uint32_t)streamId {
+    NSMutableData* key = [NSMutableData dataWithLength:64];
+    arc4random_buf(key.mutableBytes, key.length);
+
+    Node* root = [self database];
+
+    NSError* error;
+    KeePassGroup* rootGroup = [[[XmlStrongboxNodeModelAdaptor alloc] init] toKeePassModel:root context:XmlProcessingContext.standardV4Context error:&error];
+    XCTAssertNotNil(rootGroup, @"%@", error);
+
+    NSData* sequential = [self serialize:rootGroup streamId:streamId key:key concurrently:NO];
+    NSData* concurrent = [self serialize:rootGroup streamId:streamId key:key concurrently:YES];
+
+    XCTAssertGreaterThan(sequential.length, 0);
+    XCTAssertEqualObjects(concurrent, sequential);
+
+    Node* parsed = [self parse:concurrent streamId:streamId key:key];
+    XCTAssertNotNil(parsed);
+
+    [self assertTree:parsed.childGroups.firstObject equals:root.childGroups.firstObject];
+}
+
+- (void)testConcurrentChaCha20MatchesSequential {
+    [self assertConcurrentMatchesSequential:kInnerStreamChaCha20];
+}
+
+- (void)testConcurrentSalsa20MatchesSequential {
+    [self assertConcurrentMatchesSequential:kInnerStreamSalsa20];
+}
+
+@end
@@ -0,0 +1,21 @@
+//
+//  AesKdfEngine.h
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface AesKdfEngine : NSObject
+
+@property (class, readonly) BOOL isHardwareAccelerated;
+
++ (BOOL)transform:(uint8_t*)data key:(NSData*)key rounds:(uint64_t)rounds;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -8,6 +8,7 @@
 
 #import "Argon2KdfCipher.h"
 #import "argon2.h"
+#import "Argon2KdfExecutor.h"
 #import <CommonCrypto/CommonDigest.h>
 #import "Utils.h"
 #import "KeePassCiphers.h"
@@ -126,15 +127,12 @@ static const BOOL kLogVerbose = NO;
 }
 
 - (NSData*)deriveKey:(NSData*)data {
-    uint8_t buffer[32];
-    
     argon2_context ctx = { 0 };
     
     ctx.version = self.version;
     ctx.lanes = self.innerParallelism;
     ctx.m_cost = (uint32_t)self.innerMemory / kBlockSize;
     ctx.t_cost = (uint32_t)self.innerIterations;
-    ctx.out = buffer;
     ctx.outlen = 32;
     ctx.pwd = (uint8_t*)data.bytes;
     ctx.pwdlen = (uint32_t)data.length;
@@ -145,17 +143,13 @@ static const BOOL kLogVerbose = NO;
     ctx.ad = self.assocData ? (uint8_t*)self.assocData.bytes : nil;
     ctx.adlen = self.assocData ? (uint32_t) self.assocData.length : 0;
     ctx.threads = self.innerParallelism; 
-    ctx.allocate_cbk = nil; 
-    ctx.free_cbk = nil; 
-        
-    if ( self.argon2id ) {
-        argon2id_ctx(&ctx);
-    }
-    else {
-        argon2d_ctx(&ctx);
-    }
     
-    NSData *transformKey = [NSData dataWithBytes:ctx.out length:ctx.outlen];
+    NSError* error;
+    NSData *transformKey = [Argon2KdfExecutor.sharedInstance derive:&ctx argon2id:self.argon2id error:&error];
+    
+    if ( transformKey == nil ) {
+        return nil;
+    }
 
     if(kLogVerbose) {
         NSLog(@"ARGON2: TRANSFORM KEY: %@", [transformKey base64EncodedStringWithOptions:kNilOptions]);
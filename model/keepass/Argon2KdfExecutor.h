@@ -0,0 +1,28 @@
+//
+//  Argon2KdfExecutor.h
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "argon2.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface Argon2KdfExecutor : NSObject
+
++ (instancetype)sharedInstance;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (NSData*_Nullable)derive:(argon2_context*)context
+                  argon2id:(BOOL)argon2id
+                     error:(NSError**)error;
+
+- (void)releaseArena;
+
+@end
+
+NS_ASSUME_NONNULL_END
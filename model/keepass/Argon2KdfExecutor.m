@@ -0,0 +1,158 @@
+//
+//  Argon2KdfExecutor.m
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import "Argon2KdfExecutor.h"
+#import "Utils.h"
+#include <sys/mman.h>
+#include <os/lock.h>
+
+static const NSTimeInterval kArenaIdleReleaseDelay = 60.0f;
+static const size_t kMaxRetainedArenaSize = 256 * 1024 * 1024;
+
+static os_unfair_lock arenaLock = OS_UNFAIR_LOCK_INIT;
+static uint8_t* arenaMemory = NULL;
+static size_t arenaSize = 0;
+static BOOL arenaInUse = NO;
+static NSUInteger arenaGeneration = 0;
+
+static void releaseArenaLocked(void) {
+    if ( arenaMemory && !arenaInUse ) {
+        munmap(arenaMemory, arenaSize);
+        arenaMemory = NULL;
+        arenaSize = 0;
+    }
+}
+
+static int arenaAllocate(uint8_t **memory, size_t bytesToAllocate) {
+    os_unfair_lock_lock(&arenaLock);
+    
+    if ( !arenaInUse ) {
+        if ( arenaSize < bytesToAllocate ) {
+            releaseArenaLocked();
+            
+            size_t page = (size_t)getpagesize();
+            size_t size = (bytesToAllocate + page - 1) / page * page;
+            void* mapped = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+            
+            if ( mapped != MAP_FAILED ) {
+                arenaMemory = mapped;
+                arenaSize = size;
+            }
+        }
+        
+        if ( arenaMemory && arenaSize >= bytesToAllocate ) {
+            arenaInUse = YES;
+            arenaGeneration++;
+            *memory = arenaMemory;
+            os_unfair_lock_unlock(&arenaLock);
+            return ARGON2_OK;
+        }
+    }
+    
+    os_unfair_lock_unlock(&arenaLock);
+    
+    void* fallback = NULL;
+    if ( posix_memalign(&fallback, (size_t)getpagesize(), bytesToAllocate) != 0 ) {
+        fallback = NULL;
+    }
+    
+    *memory = fallback;
+    
+    return fallback ? ARGON2_OK : ARGON2_MEMORY_ALLOCATION_ERROR;
+}
+
+static void arenaFree(uint8_t *memory, size_t bytesToFree) {
+    os_unfair_lock_lock(&arenaLock);
+    
+    if ( memory == arenaMemory ) {
+        arenaInUse = NO;
+        
+        if ( arenaSize > kMaxRetainedArenaSize ) {
+            releaseArenaLocked();
+        }
+        
+        os_unfair_lock_unlock(&arenaLock);
+        return;
+    }
+    
+    os_unfair_lock_unlock(&arenaLock);
+    
+    free(memory);
+}
+
+@implementation Argon2KdfExecutor
+
++ (instancetype)sharedInstance {
+    static Argon2KdfExecutor *sharedInstance = nil;
+    static dispatch_once_t onceToken;
+    
+    dispatch_once(&onceToken, ^{
+        sharedInstance = [[Argon2KdfExecutor alloc] initPrivate];
+    });
+    
+    return sharedInstance;
+}
+
+- (instancetype)initPrivate {
+    return [super init];
+}
+
+- (NSData *)derive:(argon2_context *)context argon2id:(BOOL)argon2id error:(NSError **)error {
+    NSMutableData* out = [NSMutableData dataWithLength:context->outlen];
+    
+    argon2_context ctx = *context;
+    ctx.out = out.mutableBytes;
+    ctx.threads = MAX(1, MIN(ctx.lanes, (uint32_t)NSProcessInfo.processInfo.activeProcessorCount));
+    ctx.allocate_cbk = arenaAllocate;
+    ctx.free_cbk = arenaFree;
+    
+    int result = argon2id ? argon2id_ctx(&ctx) : argon2d_ctx(&ctx);
+    
+#ifdef IS_APP_EXTENSION
+    [self releaseArena];
+#else
+    [self scheduleArenaRelease];
+#endif
+    
+    if ( result != ARGON2_OK ) {
+        NSString* message = [NSString stringWithFormat:@"Argon2 error: %s", argon2_error_message(result)];
+        NSLog(@"🔴 WARNWARN: %@", message);
+        
+        [out resetBytesInRange:NSMakeRange(0, out.length)];
+        
+        if ( error ) {
+            *error = [Utils createNSError:message errorCode:result];
+        }
+        
+        return nil;
+    }
+    
+    return out;
+}
+
+- (void)scheduleArenaRelease {
+    os_unfair_lock_lock(&arenaLock);
+    NSUInteger generation = arenaGeneration;
+    os_unfair_lock_unlock(&arenaLock);
+    
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kArenaIdleReleaseDelay * NSEC_PER_SEC)), dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        os_unfair_lock_lock(&arenaLock);
+        if ( generation == arenaGeneration ) {
+            releaseArenaLocked();
+        }
+        os_unfair_lock_unlock(&arenaLock);
+    });
+}
+
+- (void)releaseArena {
+    os_unfair_lock_lock(&arenaLock);
+    releaseArenaLocked();
+    os_unfair_lock_unlock(&arenaLock);
+}
+
+@end
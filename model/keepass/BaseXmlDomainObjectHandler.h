@@ -21,6 +21,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (BOOL)writeUnmanagedChildren:(id<IXmlSerializer>)serializer;
 
+- (void)prepareForReuse;
+
 @end
 
 NS_ASSUME_NONNULL_END
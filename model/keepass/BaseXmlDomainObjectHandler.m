@@ -75,6 +75,12 @@
 
 - (void)onCompleted { }
 
+- (void)prepareForReuse {
+    self.internalAttributes = nil;
+    self.internalText = nil;
+    self.lazyUnmanagedChildElements = nil;
+}
+
 - (BOOL)addKnownChildObject:(id<XmlParsingDomainObject>)completedObject withXmlElementName:(nonnull NSString *)withXmlElementName {
     return NO; 
 }
@@ -17,6 +17,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (id)initWithKey:(const NSData *)key;
 
 - (NSData *)xor:(NSData *)ct;
+- (void)xorInPlace:(uint8_t *)buffer length:(NSUInteger)length;
 @property (nonatomic, readonly) NSData* key;
 
 @end
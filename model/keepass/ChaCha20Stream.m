@@ -8,12 +8,16 @@
 
 #import "ChaCha20Stream.h"
 #import "sodium.h"
+#import "InnerStreamKeystream.h"
 #import <CommonCrypto/CommonCrypto.h>
 
-static const uint32_t kBlockSize = 64;
 static const uint32_t kIvSize = 12;
 static const uint32_t kKeySize = 32;
 
+static void generateKeystream(uint8_t* keystream, size_t length, uint64_t firstBlock, const uint8_t* nonce, const uint8_t* key) {
+    crypto_stream_chacha20_ietf_xor_ic(keystream, keystream, length, nonce, (uint32_t)firstBlock, key);
+}
+
 @interface ChaCha20Stream ()
 
 @property (nonatomic) uint64_t bytesProcessed;
@@ -22,7 +26,9 @@ static const uint32_t kKeySize = 32;
 
 @end
 
-@implementation ChaCha20Stream
+@implementation ChaCha20Stream {
+    InnerStreamKeystream _keystream;
+}
 
 + (void)initialize {
     if(self == [ChaCha20Stream class]) {
@@ -61,27 +67,28 @@ static const uint32_t kKeySize = 32;
         
         self.bytesProcessed = 0;
         
-        
-        
+        innerStreamKeystreamInit(&_keystream, generateKeystream);
     }
     
     return self;
 }
 
--(NSData *)xor:(NSData *)ct {
-    uint32_t currentBlock = (uint32_t)self.bytesProcessed / kBlockSize;
-    int offset = self.bytesProcessed % kBlockSize;
-
-    NSMutableData *xorBlock = [NSMutableData dataWithLength:ct.length + kBlockSize];
-    NSRange subRange = NSMakeRange(offset, ct.length);
-    [xorBlock replaceBytesInRange:subRange withBytes:ct.bytes];
+- (void)dealloc {
+    innerStreamKeystreamWipe(&_keystream);
+}
 
-    NSMutableData *outData = [[NSMutableData alloc] initWithLength:ct.length + kBlockSize];
+- (void)xorInPlace:(uint8_t *)buffer length:(NSUInteger)length {
+    innerStreamKeystreamXor(&_keystream, buffer, length, self.generatedIv.bytes, self.generatedKey.bytes);
+    
+    self.bytesProcessed += length;
+}
 
-    crypto_stream_chacha20_ietf_xor_ic(outData.mutableBytes, xorBlock.bytes, xorBlock.length, self.generatedIv.bytes, currentBlock, self.generatedKey.bytes);
+-(NSData *)xor:(NSData *)ct {
+    NSMutableData *outData = [NSMutableData dataWithData:ct];
+    
+    [self xorInPlace:outData.mutableBytes length:outData.length];
     
-    self.bytesProcessed += ct.length;
-    return [outData subdataWithRange:subRange]; 
+    return outData;
 }
 
 @end
@@ -7,6 +7,7 @@
 //
 
 #import <Foundation/Foundation.h>
+#import "DatabaseAttachmentSegment.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -18,6 +19,11 @@ NS_ASSUME_NONNULL_BEGIN
 - (instancetype)initWithStream:(NSInputStream *)stream length:(NSUInteger)length protectedInMemory:(BOOL)protectedInMemory compressed:(BOOL)compressed;
 - (instancetype)initForStreamWriting:(BOOL)protectedInMemory compressed:(BOOL)compressed;
 
+
+
+- (instancetype _Nullable)initWithStream:(NSInputStream*)stream length:(NSUInteger)length protectedInMemory:(BOOL)protectedInMemory segment:(DatabaseAttachmentSegment*)segment;
+- (instancetype _Nullable)initWithAttachment:(DatabaseAttachment*)attachment segment:(DatabaseAttachmentSegment*)segment;
+
 - (NSInteger)writeStreamWithB64Text:(NSString*)text;
 - (void)closeWriteStream;
 
@@ -35,6 +35,11 @@ static const BOOL kEncrypt = YES;
 @property NSOutputStream* incrementalWriteStream;
 @property Sha256PassThroughOutputStream* digested;
 
+@property DatabaseAttachmentSegment* segment;
+@property uint64_t segmentOffset;
+@property uint64_t segmentEncryptedLength;
+@property NSData* segmentIv;
+
 @end
 
 @implementation DatabaseAttachment
@@ -117,6 +122,46 @@ static const BOOL kEncrypt = YES;
     return self;
 }
 
+- (instancetype)initWithStream:(NSInputStream *)stream length:(NSUInteger)length protectedInMemory:(BOOL)protectedInMemory segment:(DatabaseAttachmentSegment *)segment {
+    if (self = [super init]) {
+        _compressed = YES;
+        _protectedInMemory = protectedInMemory;
+        
+        uint64_t offset, encryptedLength;
+        NSData* iv;
+        if ( ![segment appendFromStream:stream length:length offset:&offset encryptedLength:&encryptedLength iv:&iv] ) {
+            return nil;
+        }
+        
+        self.segment = segment;
+        self.segmentOffset = offset;
+        self.segmentEncryptedLength = encryptedLength;
+        self.segmentIv = iv;
+        self.attachmentLength = length;
+        _sha256Hex = length ? nil : kEmptyDataDigest;
+    }
+    
+    return self;
+}
+
+- (instancetype)initWithAttachment:(DatabaseAttachment *)attachment segment:(DatabaseAttachmentSegment *)segment {
+    NSInputStream* stream = [attachment getPlainTextInputStream];
+    if ( stream == nil ) {
+        return nil;
+    }
+    
+    [stream open];
+    self = [self initWithStream:stream length:attachment.length protectedInMemory:attachment.protectedInMemory segment:segment];
+    [stream close];
+    
+    if ( self ) {
+        _compressed = attachment.compressed;
+        _sha256Hex = attachment.digestHash;
+    }
+    
+    return self;
+}
+
 - (instancetype)initForStreamWriting:(BOOL)protectedInMemory compressed:(BOOL)compressed {
     if (self = [super init]) {
         self.protectedInMemory = protectedInMemory;
@@ -219,6 +264,10 @@ static const BOOL kEncrypt = YES;
 }
 
 - (NSInputStream *)getPlainTextInputStream {
+    if ( self.segment ) {
+        return [self.segment plainTextInputStreamAtOffset:self.segmentOffset encryptedLength:self.segmentEncryptedLength iv:self.segmentIv];
+    }
+    
     if (self.digested == nil) {
         return [NSInputStream inputStreamWithData:NSData.data]; 
     }
@@ -260,7 +309,42 @@ static const BOOL kEncrypt = YES;
 }
 
 - (NSString *)digestHash {
-    return self.sha256Hex;
+    @synchronized (self) {
+        if ( self.sha256Hex == nil ) {
+            _sha256Hex = [self computeDigest];
+        }
+        
+        return self.sha256Hex;
+    }
+}
+
+- (NSString*)computeDigest {
+    NSInputStream* stream = [self getPlainTextInputStream];
+    if ( stream == nil ) {
+        NSLog(@"🔴 WARNWARN: Could not read attachment to compute digest");
+        return kEmptyDataDigest;
+    }
+    
+    CC_SHA256_CTX context;
+    CC_SHA256_Init(&context);
+    
+    uint8_t block[kBlockSize];
+    NSInteger read;
+    
+    [stream open];
+    while ( (read = [stream read:block maxLength:kBlockSize]) > 0 ) {
+        CC_SHA256_Update(&context, block, (CC_LONG)read);
+    }
+    [stream close];
+    
+    if ( read < 0 ) {
+        NSLog(@"🔴 WARNWARN: Error reading attachment while computing digest [%@]", stream.streamError);
+    }
+    
+    uint8_t digest[CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256_Final(digest, &context);
+    
+    return [NSData dataWithBytes:digest length:CC_SHA256_DIGEST_LENGTH].hexString;
 }
 
 - (BOOL)isEqual:(id)object {
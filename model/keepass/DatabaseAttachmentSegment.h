@@ -0,0 +1,31 @@
+//
+//  DatabaseAttachmentSegment.h
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface DatabaseAttachmentSegment : NSObject
+
+- (instancetype _Nullable)init;
+
+- (BOOL)appendFromStream:(NSInputStream*)stream
+                  length:(NSUInteger)length
+                  offset:(uint64_t*)offset
+         encryptedLength:(uint64_t*)encryptedLength
+                      iv:(NSData*_Nullable*_Nonnull)iv;
+
+- (void)finishWriting;
+
+- (NSInputStream*_Nullable)plainTextInputStreamAtOffset:(uint64_t)offset
+                                        encryptedLength:(uint64_t)encryptedLength
+                                                     iv:(NSData*)iv;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,221 @@
+//
+//  DatabaseAttachmentSegment.m
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import "DatabaseAttachmentSegment.h"
+#import <CommonCrypto/CommonCrypto.h>
+#import "FileManager.h"
+#import "Utils.h"
+#import "AesOutputStream.h"
+#import "AesInputStream.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+static const int kBlockSize = 32 * 1024;
+
+@interface SegmentRangeInputStream : NSInputStream
+
+- (instancetype)initWithPath:(NSString*)path offset:(uint64_t)offset length:(uint64_t)length;
+
+@end
+
+@interface SegmentRangeInputStream ()
+
+@property NSString* path;
+@property uint64_t offset;
+@property uint64_t remaining;
+@property int fd;
+@property NSError* error;
+
+@end
+
+@implementation SegmentRangeInputStream
+
+- (instancetype)initWithPath:(NSString *)path offset:(uint64_t)offset length:(uint64_t)length {
+    if ( self = [super init] ) {
+        _path = path;
+        _offset = offset;
+        _remaining = length;
+        _fd = -1;
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    [self close];
+}
+
+- (void)open {
+    if ( self.fd < 0 ) {
+        self.fd = open(self.path.fileSystemRepresentation, O_RDONLY);
+        
+        if ( self.fd < 0 ) {
+            self.error = [Utils createNSError:@"Could not open attachment segment" errorCode:errno];
+        }
+    }
+}
+
+- (void)close {
+    if ( self.fd >= 0 ) {
+        close(self.fd);
+        self.fd = -1;
+    }
+}
+
+- (NSInteger)read:(uint8_t *)buffer maxLength:(NSUInteger)len {
+    if ( self.fd < 0 ) {
+        return -1;
+    }
+    
+    size_t toRead = (size_t)MIN((uint64_t)len, self.remaining);
+    if ( toRead == 0 ) {
+        return 0;
+    }
+    
+    ssize_t read = pread(self.fd, buffer, toRead, (off_t)self.offset);
+    if ( read < 0 ) {
+        self.error = [Utils createNSError:@"Could not read attachment segment" errorCode:errno];
+        return -1;
+    }
+    
+    self.offset += read;
+    self.remaining -= read;
+    
+    return read;
+}
+
+- (BOOL)hasBytesAvailable {
+    return self.remaining > 0;
+}
+
+- (NSStreamStatus)streamStatus {
+    return self.fd < 0 ? NSStreamStatusNotOpen : ( self.remaining ? NSStreamStatusOpen : NSStreamStatusAtEnd );
+}
+
+- (NSError *)streamError {
+    return self.error;
+}
+
+@end
+
+@interface DatabaseAttachmentSegment ()
+
+@property NSString* path;
+@property NSData* encryptionKey;
+@property (nullable) NSOutputStream* outputFile;
+@property uint64_t writtenLength;
+
+@end
+
+@implementation DatabaseAttachmentSegment
+
+- (instancetype)init {
+    if ( self = [super init] ) {
+        _path = [FileManager.sharedInstance.tmpEncryptedAttachmentPath stringByAppendingPathComponent:NSUUID.UUID.UUIDString];
+        _encryptionKey = getRandomData(kCCKeySizeAES256);
+        _outputFile = [NSOutputStream outputStreamToFileAtPath:_path append:NO];
+        
+        [_outputFile open];
+        
+        if ( _encryptionKey == nil || _outputFile.streamStatus != NSStreamStatusOpen ) {
+            NSLog(@"🔴 WARNWARN: Could not create attachment segment at [%@]", _path);
+            return nil;
+        }
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    [self finishWriting];
+    
+    NSError* error;
+    [NSFileManager.defaultManager removeItemAtPath:self.path error:&error];
+}
+
+- (BOOL)appendFromStream:(NSInputStream *)stream
+                  length:(NSUInteger)length
+                  offset:(uint64_t *)offset
+         encryptedLength:(uint64_t *)encryptedLength
+                      iv:(NSData * _Nullable __autoreleasing *)iv {
+    if ( self.outputFile == nil ) {
+        return NO;
+    }
+    
+    NSData* attachmentIv = getRandomData(kCCBlockSizeAES128);
+    AesOutputStream* aes = [[AesOutputStream alloc] initToOutputStream:self.outputFile encrypt:YES key:self.encryptionKey iv:attachmentIv chainOpensAndCloses:NO];
+    if ( aes == nil ) {
+        return NO;
+    }
+    
+    [aes open];
+    
+    uint64_t start = self.writtenLength;
+    
+    uint8_t block[kBlockSize];
+    for ( size_t readSoFar = 0; readSoFar < length; ) {
+        size_t remaining = length - readSoFar;
+        size_t bytesToReadThisTime = remaining > kBlockSize ? kBlockSize : remaining;
+        
+        NSInteger read = [stream read:block maxLength:bytesToReadThisTime];
+        if ( read <= 0 ) {
+            NSLog(@"Not enough data to read specified length of attachment. Read = %ld, Requested = %ld", (long)read, bytesToReadThisTime);
+            [aes close];
+            [self syncWrittenLength];
+            return NO;
+        }
+        
+        if ( [aes write:block maxLength:read] < 0 ) {
+            NSLog(@"🔴 WARNWARN: Could not write attachment segment [%@]", aes.streamError);
+            [aes close];
+            [self syncWrittenLength];
+            return NO;
+        }
+        
+        readSoFar += read;
+    }
+    
+    [aes close];
+    
+    if ( ![self syncWrittenLength] ) {
+        return NO;
+    }
+    
+    *offset = start;
+    *encryptedLength = self.writtenLength - start;
+    *iv = attachmentIv;
+    
+    return YES;
+}
+
+- (BOOL)syncWrittenLength {
+    NSNumber* position = [self.outputFile propertyForKey:NSStreamFileCurrentOffsetKey];
+    
+    if ( position == nil || self.outputFile.streamError != nil ) {
+        NSLog(@"🔴 WARNWARN: Attachment segment position unknown, no further appends [%@]", self.outputFile.streamError);
+        [self finishWriting];
+        return NO;
+    }
+    
+    self.writtenLength = position.unsignedLongLongValue;
+    
+    return YES;
+}
+
+- (void)finishWriting {
+    [self.outputFile close];
+    self.outputFile = nil;
+}
+
+- (NSInputStream *)plainTextInputStreamAtOffset:(uint64_t)offset encryptedLength:(uint64_t)encryptedLength iv:(NSData *)iv {
+    SegmentRangeInputStream* range = [[SegmentRangeInputStream alloc] initWithPath:self.path offset:offset length:encryptedLength];
+    
+    return [[AesInputStream alloc] initWithStream:range key:self.encryptionKey iv:iv];
+}
+
+@end
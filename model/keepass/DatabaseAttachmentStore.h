@@ -0,0 +1,23 @@
+//
+//  DatabaseAttachmentStore.h
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "DatabaseAttachment.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface DatabaseAttachmentStore : NSObject
+
++ (instancetype)sharedInstance;
+
+- (DatabaseAttachment*)intern:(DatabaseAttachment*)attachment;
+- (DatabaseAttachment*)internNew:(DatabaseAttachment*)attachment;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,88 @@
+//
+//  DatabaseAttachmentStore.m
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import "DatabaseAttachmentStore.h"
+
+@interface DatabaseAttachmentStore ()
+
+@property (readonly) NSMapTable<NSString*, DatabaseAttachment*>* byKey;
+@property (weak) DatabaseAttachmentSegment* sharedSegment;
+
+@end
+
+@implementation DatabaseAttachmentStore
+
++ (instancetype)sharedInstance {
+    static DatabaseAttachmentStore *sharedInstance = nil;
+    static dispatch_once_t onceToken;
+    
+    dispatch_once(&onceToken, ^{
+        sharedInstance = [[DatabaseAttachmentStore alloc] init];
+    });
+    
+    return sharedInstance;
+}
+
+- (instancetype)init {
+    if ( self = [super init] ) {
+        _byKey = [NSMapTable strongToWeakObjectsMapTable];
+    }
+    
+    return self;
+}
+
+- (NSString*)keyForAttachment:(DatabaseAttachment*)attachment {
+    return [NSString stringWithFormat:@"%@-%d-%d", attachment.digestHash, attachment.protectedInMemory, attachment.compressed];
+}
+
+- (DatabaseAttachment *)intern:(DatabaseAttachment *)attachment {
+    NSString* key = [self keyForAttachment:attachment];
+    
+    @synchronized (self) {
+        DatabaseAttachment* existing = [self.byKey objectForKey:key];
+        
+        if ( existing ) {
+            return existing;
+        }
+        
+        [self.byKey setObject:attachment forKey:key];
+        
+        return attachment;
+    }
+}
+
+- (DatabaseAttachment *)internNew:(DatabaseAttachment *)attachment {
+    NSString* key = [self keyForAttachment:attachment];
+    
+    @synchronized (self) {
+        DatabaseAttachment* existing = [self.byKey objectForKey:key];
+        
+        if ( existing ) {
+            return existing;
+        }
+        
+        DatabaseAttachmentSegment* segment = self.sharedSegment;
+        if ( segment == nil ) {
+            segment = [[DatabaseAttachmentSegment alloc] init];
+            self.sharedSegment = segment;
+        }
+        
+        DatabaseAttachment* shared = segment ? [[DatabaseAttachment alloc] initWithAttachment:attachment segment:segment] : nil;
+        
+        if ( shared == nil ) {
+            NSLog(@"🔴 WARNWARN: Could not move attachment into shared segment, keeping its own file.");
+            shared = attachment;
+        }
+        
+        [self.byKey setObject:shared forKey:key];
+        
+        return shared;
+    }
+}
+
+@end
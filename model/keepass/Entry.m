@@ -70,6 +70,26 @@ const static NSSet<NSString*> *wellKnownKeys;
     return self;
 }
 
+- (void)prepareForReuse {
+    [super prepareForReuse];
+    
+    self.uuid = NSUUID.UUID;
+    self.times = [[Times alloc] initWithXmlElementName:kTimesElementName context:self.context];
+    self.history = [[History alloc] initWithXmlElementName:kHistoryElementName context:self.context];
+    [self.strings removeAllObjects];
+    [self.binaries removeAllObjects];
+    self.tags = [NSMutableSet set];
+    self.icon = nil;
+    self.customIcon = nil;
+    self.customData = [[CustomData alloc] initWithContext:self.context];
+    self.foregroundColor = nil;
+    self.backgroundColor = nil;
+    self.overrideURL = nil;
+    self.autoType = nil;
+    self.qualityCheck = YES;
+    self.previousParentGroup = nil;
+}
+
 - (id<XmlParsingDomainObject>)getChildHandler:(nonnull NSString *)xmlElementName {
     if([xmlElementName isEqualToString:kTimesElementName]) {
         return [[Times alloc] initWithContext:self.context];
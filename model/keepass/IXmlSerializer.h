@@ -36,6 +36,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (void)endElement;
 
+- (BOOL)writeConcurrently:(NSArray*)items block:(BOOL (^)(id item, id<IXmlSerializer> serializer))block;
+
 @property (readonly, nullable) NSError* streamError;
 
 @end
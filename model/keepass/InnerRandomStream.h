@@ -15,6 +15,7 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, readonly) NSData* key;
 
 - (NSData*)xor:(NSData*)ct;
+- (void)xorInPlace:(uint8_t*)buffer length:(NSUInteger)length;
 
 @end
 
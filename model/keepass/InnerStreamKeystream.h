@@ -0,0 +1,28 @@
+//
+//  InnerStreamKeystream.h
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+#define kInnerStreamKeystreamSize 4096
+
+typedef void (*InnerStreamKeystreamGenerator)(uint8_t* keystream, size_t length, uint64_t firstBlock, const uint8_t* nonce, const uint8_t* key);
+
+typedef struct {
+    uint8_t bytes[kInnerStreamKeystreamSize];
+    size_t offset;
+    uint64_t nextBlock;
+    InnerStreamKeystreamGenerator generator;
+} InnerStreamKeystream;
+
+void innerStreamKeystreamInit(InnerStreamKeystream* keystream, InnerStreamKeystreamGenerator generator);
+void innerStreamKeystreamXor(InnerStreamKeystream* keystream, uint8_t* buffer, size_t length, const uint8_t* nonce, const uint8_t* key);
+void innerStreamKeystreamWipe(InnerStreamKeystream* keystream);
+
+NS_ASSUME_NONNULL_END
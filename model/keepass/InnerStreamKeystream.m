@@ -0,0 +1,52 @@
+//
+//  InnerStreamKeystream.m
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import "InnerStreamKeystream.h"
+#import "sodium.h"
+
+static const size_t kBlockSize = 64;
+
+void innerStreamKeystreamInit(InnerStreamKeystream* keystream, InnerStreamKeystreamGenerator generator) {
+    keystream->offset = kInnerStreamKeystreamSize;
+    keystream->nextBlock = 0;
+    keystream->generator = generator;
+}
+
+static void refill(InnerStreamKeystream* keystream, const uint8_t* nonce, const uint8_t* key) {
+    sodium_memzero(keystream->bytes, kInnerStreamKeystreamSize);
+    
+    keystream->generator(keystream->bytes, kInnerStreamKeystreamSize, keystream->nextBlock, nonce, key);
+    
+    keystream->nextBlock += kInnerStreamKeystreamSize / kBlockSize;
+    keystream->offset = 0;
+}
+
+void innerStreamKeystreamXor(InnerStreamKeystream* keystream, uint8_t* buffer, size_t length, const uint8_t* nonce, const uint8_t* key) {
+    size_t done = 0;
+    
+    while ( done < length ) {
+        if ( keystream->offset == kInnerStreamKeystreamSize ) {
+            refill(keystream, nonce, key);
+        }
+        
+        size_t n = MIN(length - done, kInnerStreamKeystreamSize - keystream->offset);
+        const uint8_t* bytes = &keystream->bytes[keystream->offset];
+        
+        for ( size_t i = 0; i < n; i++ ) {
+            buffer[done + i] ^= bytes[i];
+        }
+        
+        done += n;
+        keystream->offset += n;
+    }
+}
+
+void innerStreamKeystreamWipe(InnerStreamKeystream* keystream) {
+    sodium_memzero(keystream->bytes, kInnerStreamKeystreamSize);
+    keystream->offset = kInnerStreamKeystreamSize;
+}
@@ -14,6 +14,7 @@
 #import "Constants.h"
 #import "NSData+Extensions.h"
 #import "StreamUtils.h"
+#import "MappedFileInputStream.h"
 
 static const BOOL kLogVerbose = NO;
 
@@ -81,6 +82,15 @@ static const BOOL kLogVerbose = NO;
 }
 
 + (void)read:(NSInputStream *)stream ckf:(CompositeKeyFactors *)ckf completion:(OpenCompletionBlock)completion {
+    if ( [stream isKindOfClass:MappedFileInputStream.class] ) {
+        [stream open];
+        NSData* data = ((MappedFileInputStream*)stream).remainingData;
+        [stream close];
+        
+        [self open:data ckf:ckf completion:completion];
+        return;
+    }
+    
     NSMutableData* mutableData = [NSMutableData dataWithCapacity:kStreamingSerializationChunkSize];
     
     [stream open];
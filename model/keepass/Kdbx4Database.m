@@ -68,12 +68,12 @@ static void onDeserialized(Kdbx4SerializationData * _Nullable serializationData,
         
     
     
-    NSDictionary<NSUUID*, NodeIcon*>* customIcons = [KeePassXmlModelAdaptor getCustomIcons:meta];
+    NSDictionary<NSUUID*, NodeIcon*>* customIcons = serializationData.rootNode ? serializationData.customIconPool : [KeePassXmlModelAdaptor getCustomIcons:meta];
 
     
 
     NSError* error;
-    Node* rootGroup = [KeePassXmlModelAdaptor toStrongboxModel:xmlRoot attachments:serializationData.attachments customIconPool:customIcons error:&error];
+    Node* rootGroup = serializationData.rootNode ? serializationData.rootNode : [KeePassXmlModelAdaptor toStrongboxModel:xmlRoot attachments:serializationData.attachments customIconPool:customIcons error:&error];
     if(rootGroup == nil) {
         NSLog(@"Error converting Xml model to Strongbox model: [%@]", error);
         completion(NO, nil, innerStreamError, error);
@@ -159,7 +159,7 @@ static void onDeserialized(Kdbx4SerializationData * _Nullable serializationData,
     
     
     
-    BOOL rotateHardwareKeyChallenge = YES; 
+    BOOL rotateHardwareKeyChallenge = database.ckfs.yubiKeyCR != nil;
     
     if ( rotateHardwareKeyChallenge ) {
         id<KeyDerivationCipher> kdf = getKeyDerivationCipher(database.meta.kdfParameters, &error);
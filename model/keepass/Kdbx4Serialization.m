@@ -30,6 +30,7 @@
 #import "Argon2idKdfCipher.h"
 #import "StrongboxErrorCodes.h"
 #import "StreamUtils.h"
+#import "PipelinedInputStream.h"
 #import "HmacBlockOutputStream.h"
 #import "GzipDecompressOutputStream.h"
 #import "GZIPCompressOutputStream.h"
@@ -355,17 +356,17 @@ headerDataForIntegrityCheck:(NSData*)headerDataForIntegrityCheck
 
     
 
-    HmacBlockInputStream* hmacedBlockStream = [[HmacBlockInputStream alloc] initWithStream:inputStream hmacKey:keys.hmacKey];
-
+    NSInputStream* hmacedBlockStream = [[PipelinedInputStream alloc] initWithStream:[[HmacBlockInputStream alloc] initWithStream:inputStream hmacKey:keys.hmacKey]];
+    
     
 
     id<Cipher> cipher = getCipher(cryptoParams.cipherUuid);
-    NSInputStream* plainTextStream = [cipher getDecryptionStreamForStream:hmacedBlockStream key:keys.masterKey iv:cryptoParams.iv];
-
+    NSInputStream* plainTextStream = [[PipelinedInputStream alloc] initWithStream:[cipher getDecryptionStreamForStream:hmacedBlockStream key:keys.masterKey iv:cryptoParams.iv]];
+    
     
 
     BOOL compressed = cryptoParams.compressionFlags == 1;
-    NSInputStream* decompressedStream = compressed ? [[GZipInputStream alloc] initWithStream:plainTextStream] : plainTextStream;
+    NSInputStream* decompressedStream = compressed ? [[PipelinedInputStream alloc] initWithStream:[[GZipInputStream alloc] initWithStream:plainTextStream]] : plainTextStream;
 
     [decompressedStream open];
     
@@ -540,20 +541,28 @@ static Kdbx4SerializationData* readDecrypted(NSInputStream* stream, NSOutputStre
         return nil;
     }
     
+    KeePassXmlNodeBuilder* nodeBuilder = [[KeePassXmlNodeBuilder alloc] initWithAttachments:ret.attachments];
+    
     ret.rootXmlObject = parseXml(ret.innerRandomStreamId, ret.innerRandomStreamKey,
-                                 XmlProcessingContext.standardV4Context, stream, xmlDumpStream, sanityCheckInnerStream, innerStreamError, ppError);
+                                 XmlProcessingContext.standardV4Context, stream, xmlDumpStream, sanityCheckInnerStream, nodeBuilder, innerStreamError, ppError);
 
     if(ret.rootXmlObject == nil) {
         NSLog(@"Error parsing xml: %@", *ppError);
         return nil;
     }
     
+    if ( nodeBuilder.rootNode ) {
+        ret.rootNode = nodeBuilder.rootNode;
+        ret.customIconPool = nodeBuilder.customIconPool;
+    }
+    
     return ret;
 }
 
 static Kdbx4SerializationData* readInnerHeaders(NSInputStream *stream) {
     NSMutableArray* attachments = [NSMutableArray array];
     Kdbx4SerializationData* ret = [[Kdbx4SerializationData alloc] init];
+    DatabaseAttachmentSegment* segment = nil;
     
     while(YES) {
         uint8_t header[SIZE_OF_INNER_HEADER_ENTRY_HEADER];
@@ -600,7 +609,13 @@ static Kdbx4SerializationData* readInnerHeaders(NSInputStream *stream) {
             BOOL protectedInMemory = block[0] == 1;
             
 
-            DatabaseAttachment *attachment = [[DatabaseAttachment alloc] initWithStream:stream length:headerLength - 1 protectedInMemory:protectedInMemory];
+            if ( segment == nil ) {
+                segment = [[DatabaseAttachmentSegment alloc] init];
+            }
+            
+            DatabaseAttachment *attachment = segment ?
+                [[DatabaseAttachment alloc] initWithStream:stream length:headerLength - 1 protectedInMemory:protectedInMemory segment:segment] :
+                [[DatabaseAttachment alloc] initWithStream:stream length:headerLength - 1 protectedInMemory:protectedInMemory];
             
             if (attachment == nil) {
                 return nil;
@@ -613,6 +628,8 @@ static Kdbx4SerializationData* readInnerHeaders(NSInputStream *stream) {
         }
     }
     
+    [segment finishWriting];
+    
     ret.attachments = attachments;
 
     return ret;
@@ -681,7 +698,19 @@ compositeKeyFactors:(CompositeKeyFactors*)compositeKeyFactors
             Keys *ret = [[Keys alloc] init];
 
             ret.compositeKey = compositeKey;
-            ret.transformKey = [kdf deriveKey:ret.compositeKey];
+            ret.transformKey = [compositeKeyFactors.transformKeyCache transformKeyForCompositeKey:compositeKey kdfParameters:kdfParameters];
+            
+            if ( ret.transformKey == nil ) {
+                ret.transformKey = [kdf deriveKey:ret.compositeKey];
+                
+                if ( ret.transformKey == nil ) {
+                    completion(NO, nil, [Utils createNSError:@"Could not derive key." errorCode:-1]);
+                    return;
+                }
+                
+                [compositeKeyFactors.transformKeyCache setTransformKey:ret.transformKey compositeKey:compositeKey kdfParameters:kdfParameters];
+            }
+            
             ret.masterKey = getMasterKey(masterSeed, ret.transformKey);
 
             
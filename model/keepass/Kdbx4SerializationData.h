@@ -10,6 +10,7 @@
 #import "KdfParameters.h"
 #import "DatabaseAttachment.h"
 #import "RootXmlDomainObject.h"
+#import "Node.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -24,6 +25,8 @@ NS_ASSUME_NONNULL_BEGIN
 @property NSUUID* cipherUuid;
 @property NSArray<DatabaseAttachment*>* attachments;
 @property RootXmlDomainObject* rootXmlObject;
+@property (nullable) Node* rootNode;
+@property (nullable) NSDictionary<NSUUID*, NodeIcon*>* customIconPool;
 
 @end
 
@@ -330,12 +330,14 @@ headerDataForIntegrityCheck:(NSData*)headerDataForIntegrityCheck
     
     NSError* error;
     NSError* innerStreamError;
+    KeePassXmlNodeBuilder* nodeBuilder = [[KeePassXmlNodeBuilder alloc] initWithAttachments:nil];
     RootXmlDomainObject *rootXmlObject = [KdbxSerialization readXml:compressed
                                                              stream:decompressedStream
                                                 innerRandomStreamId:decryptionParameters.innerRandomStreamId
                                                  protectedStreamKey:decryptionParameters.protectedStreamKey
                                                       xmlDumpStream:xmlDumpStream
                                              sanityCheckInnerStream:sanityCheckInnerStream
+                                                        nodeBuilder:nodeBuilder
                                                    innerStreamError:&innerStreamError
                                                               error:&error];
 
@@ -359,6 +361,8 @@ headerDataForIntegrityCheck:(NSData*)headerDataForIntegrityCheck
     ret.headerHash = [headerHash base64EncodedStringWithOptions:kNilOptions];
     ret.rootXmlObject = rootXmlObject;
     ret.cipherId = decryptionParameters.cipherId;
+    ret.rootNode = nodeBuilder.rootNode;
+    ret.customIconPool = nodeBuilder.rootNode ? nodeBuilder.customIconPool : nil;
     
     completion(NO, ret, innerStreamError, nil);
 }
@@ -369,10 +373,11 @@ headerDataForIntegrityCheck:(NSData*)headerDataForIntegrityCheck
              protectedStreamKey:(NSData*)protectedStreamKey
                   xmlDumpStream:(NSOutputStream*)xmlDumpStream
          sanityCheckInnerStream:(BOOL)sanityCheckInnerStream
+                    nodeBuilder:(KeePassXmlNodeBuilder*)nodeBuilder
                innerStreamError:(NSError**)innerStreamError
                           error:(NSError**)error {
     RootXmlDomainObject* rootXmlObject = parseXml(innerRandomStreamId, protectedStreamKey,
-                                                XmlProcessingContext.standardV3Context, stream, xmlDumpStream, sanityCheckInnerStream, innerStreamError, error);
+                                                XmlProcessingContext.standardV3Context, stream, xmlDumpStream, sanityCheckInnerStream, nodeBuilder, innerStreamError, error);
     return rootXmlObject;
 }
 
@@ -11,6 +11,7 @@
 #import "RootXmlDomainObject.h"
 #import "XmlProcessingContext.h"
 #import "CompositeKeyFactors.h"
+#import "KeePassXmlNodeBuilder.h"
 
 typedef struct _KeepassFileHeader {
     uint8_t signature1[4];
@@ -83,6 +84,7 @@ RootXmlDomainObject*_Nullable parseXml(uint32_t innerRandomStreamId,
                               NSInputStream* stream,
                               NSOutputStream*_Nullable xmlDumpStream,
                               BOOL sanityCheckStreamDecryption,
+                              KeePassXmlNodeBuilder*_Nullable nodeBuilder,
                               NSError** decryptionError,
                               NSError** error);
 
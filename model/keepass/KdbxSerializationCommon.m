@@ -15,12 +15,17 @@
 #import "KeePassConstants.h"
 #import "KeePassCiphers.h"
 #import "KeePassXmlParser.h"
+#import "AesKdfEngine.h"
 #include <libxml/parser.h>
 #import "NSData+Extensions.h"
 #import "NSArray+Extensions.h"
 
 static const BOOL kLogVerbose = NO;
 
+static void startElementNs(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI,
+                           int nb_namespaces, const xmlChar **namespaces, int nb_attributes, int nb_defaulted, const xmlChar **atts);
+static void endElementNs(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI);
+
 @implementation KdbxSerializationCommon
 
 BOOL keePass2SignatureAndVersionMatch(NSData * prefix, uint32_t majorVersion, uint32_t minorVersion, NSError** error) {
@@ -231,41 +236,12 @@ NSString* headerEntryIdentifierString(HeaderEntryIdentifier identifier) {
 }
 
 NSData *getAesTransformKey(NSData *compositeKey, NSData* transformSeed, uint64_t transformRounds) {
-    
-    
-    
-    
-    
-    
-    
-    
-    
-    CCCryptorRef cryptorRef;
-    CCCryptorStatus status = CCCryptorCreate(kCCEncrypt, kCCAlgorithmAES, kCCOptionECBMode, transformSeed.bytes, transformSeed.length, NULL, &cryptorRef);
-    if(kCCSuccess != status) {
-        CCCryptorRelease(cryptorRef);
-        return nil;
-    }
-    
     uint8_t derivedData[32];
     [compositeKey getBytes:derivedData length:32];
     
-    size_t tmp;
-    uint64_t rounds = transformRounds;
-    while(rounds--) {
-        status = CCCryptorUpdate(cryptorRef, derivedData, 32, derivedData, 32, &tmp);
-        if(kCCSuccess != status) {
-            CCCryptorRelease(cryptorRef);
-            return nil;
-        }
-    }
-    
-    status = CCCryptorFinal(cryptorRef,derivedData, 32, &tmp);
-    if(kCCSuccess != status) {
-        CCCryptorRelease(cryptorRef);
+    if ( ![AesKdfEngine transform:derivedData key:transformSeed rounds:transformRounds] ) {
         return nil;
     }
-    CCCryptorRelease(cryptorRef);
     
     /* Hash the result */
     
@@ -326,6 +302,7 @@ RootXmlDomainObject* parseXml(uint32_t innerRandomStreamId,
                               NSInputStream* stream,
                               NSOutputStream* xmlDumpStream,
                               BOOL sanityCheckStreamDecryption,
+                              KeePassXmlNodeBuilder* nodeBuilder,
                               NSError** decryptionError,
                               NSError** error) {
     KeePassXmlParser *parser =
@@ -343,11 +320,14 @@ RootXmlDomainObject* parseXml(uint32_t innerRandomStreamId,
         return nil;
     }
     
+    parser.nodeBuilder = nodeBuilder;
+    
     xmlSAXHandler *my_handler = malloc(sizeof(xmlSAXHandler));
     memset(my_handler, 0, sizeof(xmlSAXHandler));
     
-    my_handler->startElement = startElement;
-    my_handler->endElement = endElement;
+    my_handler->initialized = XML_SAX2_MAGIC;
+    my_handler->startElementNs = startElementNs;
+    my_handler->endElementNs = endElementNs;
     my_handler->characters = characters;
     
     const int kChunkSize = 32 * 1024;
@@ -468,40 +448,34 @@ RootXmlDomainObject* parseXml(uint32_t innerRandomStreamId,
     return ret;
 }
 
-void startElement(void *ctx, const xmlChar *fullname, const xmlChar **atts) {
-    NSString* elementName = @((char*)fullname);
+static void startElementNs(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI,
+                           int nb_namespaces, const xmlChar **namespaces, int nb_attributes, int nb_defaulted, const xmlChar **atts) {
+    KeePassXmlParser* parser = (__bridge KeePassXmlParser*)ctx;
+    NSString* elementName = [parser internedName:(const char*)localname];
 
     NSMutableDictionary* attributes;
-    if(atts) {
-        attributes = [NSMutableDictionary dictionaryWithCapacity:8];
-        int current = 0;
-        while (atts[current * 2] != NULL) {
-            const char* key = (char*)atts[(current * 2)];
-            const char* value = (char*)atts[(current * 2) + 1];
-            attributes[@(key)] = @(value);
-            current++;
+    if ( nb_attributes > 0 ) {
+        attributes = [NSMutableDictionary dictionaryWithCapacity:nb_attributes];
+        
+        for ( int i = 0; i < nb_attributes; i++ ) {
+            const xmlChar** attribute = &atts[i * 5]; 
+            NSString* value = [[NSString alloc] initWithBytes:attribute[3] length:attribute[4] - attribute[3] encoding:NSUTF8StringEncoding];
+            
+            attributes[[parser internedName:(const char*)attribute[0]]] = value ? value : @"";
         }
     }
     
-    
-    KeePassXmlParser* parser = (__bridge KeePassXmlParser*)ctx;
     [parser didStartElement:elementName attributes:attributes];
 }
 
-void endElement(void *ctx, const xmlChar *name) {
-    NSString* elementName = @((char*)name);
-    
-    
+static void endElementNs(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI) {
     KeePassXmlParser* parser = (__bridge KeePassXmlParser*)ctx;
-    [parser didEndElement:elementName];
+    [parser didEndElement:[parser internedName:(const char*)localname]];
 }
 
 void characters (void *ctx, const xmlChar *ch, int len) {
-    NSString* text = [[NSString alloc] initWithBytes:ch length:len encoding:NSUTF8StringEncoding];
-    
-
     KeePassXmlParser* parser = (__bridge KeePassXmlParser*)ctx;
-    [parser foundCharacters:text];
+    [parser foundCharacters:(const char*)ch length:len];
 }
 
 
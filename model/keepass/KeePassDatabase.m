@@ -77,13 +77,16 @@ static void onDeserialized(SerializationData *serializationData, NSError * _Null
  
     
 
-    NSArray<DatabaseAttachment*>* attachments = [KeePassXmlModelAdaptor getV3Attachments:xmlRoot];
-    NSDictionary<NSUUID*, NodeIcon*>* customIconPool = [KeePassXmlModelAdaptor getCustomIcons:meta];
+    NSDictionary<NSUUID*, NodeIcon*>* customIconPool = serializationData.rootNode ? serializationData.customIconPool : [KeePassXmlModelAdaptor getCustomIcons:meta];
 
     
         
     NSError* error;
-    Node* rootGroup = [KeePassXmlModelAdaptor toStrongboxModel:xmlRoot attachments:attachments customIconPool:customIconPool error:&error];
+    Node* rootGroup = serializationData.rootNode;
+    if ( rootGroup == nil ) {
+        NSArray<DatabaseAttachment*>* attachments = [KeePassXmlModelAdaptor getV3Attachments:xmlRoot];
+        rootGroup = [KeePassXmlModelAdaptor toStrongboxModel:xmlRoot attachments:attachments customIconPool:customIconPool error:&error];
+    }
     if(rootGroup == nil) {
         NSLog(@"Error converting Xml model to Strongbox model: [%@]", error);
         completion(NO, nil, innerStreamError, error);
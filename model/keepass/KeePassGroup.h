@@ -39,6 +39,8 @@ NS_ASSUME_NONNULL_BEGIN
 @property NSMutableSet<NSString*> *tags;
 @property (nullable) NSUUID* previousParentGroup;
 
+- (BOOL)writeXml:(id<IXmlSerializer>)serializer concurrently:(BOOL)concurrently;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -39,6 +39,26 @@
     return self;
 }
 
+- (void)prepareForReuse {
+    [super prepareForReuse];
+    
+    [self.groupsAndEntries removeAllObjects];
+    self.name = @"";
+    self.uuid = NSUUID.UUID;
+    self.times = [[Times alloc] initWithXmlElementName:kTimesElementName context:self.context];
+    self.notes = nil;
+    self.icon = nil;
+    self.customIcon = nil;
+    self.customData = [[CustomData alloc] initWithContext:self.context];
+    self.defaultAutoTypeSequence = nil;
+    self.enableAutoType = nil;
+    self.enableSearching = nil;
+    self.lastTopVisibleEntry = nil;
+    self.tags = [NSMutableSet set];
+    self.isExpanded = YES;
+    self.previousParentGroup = nil;
+}
+
 - (instancetype)initAsKeePassRoot:(XmlProcessingContext*)context {
     self = [self initWithContext:context];
     if (self) {
@@ -145,6 +165,10 @@
 }
 
 - (BOOL)writeXml:(id<IXmlSerializer>)serializer {
+    return [self writeXml:serializer concurrently:NO];
+}
+
+- (BOOL)writeXml:(id<IXmlSerializer>)serializer concurrently:(BOOL)concurrently {
     @autoreleasepool {
         if(![serializer beginElement:self.originalElementName
                                 text:self.originalText
@@ -176,7 +200,17 @@
             if ( ![serializer writeElement:kIsExpandedElementName boolean:NO]) return NO;
         }
         
-        if (self.groupsAndEntries) {
+        if ( concurrently && self.groupsAndEntries.count ) {
+            BOOL ok = [serializer writeConcurrently:self.groupsAndEntries block:^BOOL(id item, id<IXmlSerializer> fragmentSerializer) {
+                BaseXmlDomainObjectHandler *handler = (BaseXmlDomainObjectHandler*)item;
+                return [handler writeXml:fragmentSerializer];
+            }];
+            
+            if ( !ok ) {
+                return NO;
+            }
+        }
+        else if (self.groupsAndEntries) {
             for (id<KeePassGroupOrEntry> groupOrEntry in self.groupsAndEntries) {
                 BaseXmlDomainObjectHandler *handler = (BaseXmlDomainObjectHandler*)groupOrEntry;
                 if(![handler writeXml:serializer]) {
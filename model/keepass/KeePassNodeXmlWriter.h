@@ -0,0 +1,33 @@
+//
+//  KeePassNodeXmlWriter.h
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "Node.h"
+#import "IXmlSerializer.h"
+#import "DatabaseAttachment.h"
+#import "NodeIcon.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface KeePassNodeXmlWriter : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithRootGroup:(Node*)rootGroup
+                  attachmentsPool:(NSArray<DatabaseAttachment*>*)attachmentsPool
+                    indexByDigest:(NSDictionary<NSString*, NSNumber*>*_Nullable)indexByDigest
+                         iconPool:(NSDictionary<NSUUID*, NodeIcon*>*)iconPool NS_DESIGNATED_INITIALIZER;
+
+@property (readonly) Node* rootGroup;
+
+- (BOOL)writeXml:(id<IXmlSerializer>)serializer;
+- (BOOL)writeXml:(id<IXmlSerializer>)serializer concurrently:(BOOL)concurrently;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,368 @@
+//
+//  KeePassNodeXmlWriter.m
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import "KeePassNodeXmlWriter.h"
+#import "KeePassConstants.h"
+#import "XmlParsingDomainObject.h"
+#import "Entry.h"
+#import "NSUUID+Zero.h"
+#import "NSArray+Extensions.h"
+#import "Utils.h"
+
+@interface KeePassNodeXmlWriter ()
+
+@property (readonly) NSArray<DatabaseAttachment*>* attachmentsPool;
+@property (readonly, nullable) NSDictionary<NSString*, NSNumber*>* indexByDigest;
+@property (readonly) NSDictionary<NSUUID*, NodeIcon*>* iconPool;
+
+@end
+
+@implementation KeePassNodeXmlWriter
+
+- (instancetype)initWithRootGroup:(Node *)rootGroup
+                  attachmentsPool:(NSArray<DatabaseAttachment *> *)attachmentsPool
+                    indexByDigest:(NSDictionary<NSString *,NSNumber *> *)indexByDigest
+                         iconPool:(NSDictionary<NSUUID *,NodeIcon *> *)iconPool {
+    if ( self = [super init] ) {
+        _rootGroup = rootGroup;
+        _attachmentsPool = attachmentsPool;
+        _indexByDigest = indexByDigest;
+        _iconPool = iconPool;
+    }
+
+    return self;
+}
+
+- (BOOL)writeXml:(id<IXmlSerializer>)serializer {
+    return [self writeXml:serializer concurrently:YES];
+}
+
+- (BOOL)writeXml:(id<IXmlSerializer>)serializer concurrently:(BOOL)concurrently {
+    return [self writeGroup:self.rootGroup serializer:serializer concurrently:concurrently];
+}
+
+
+
+- (BOOL)writeGroup:(Node*)group serializer:(id<IXmlSerializer>)serializer concurrently:(BOOL)concurrently {
+    @autoreleasepool {
+        if ( ![serializer beginElement:kGroupElementName] ) return NO;
+
+        if ( ![serializer writeElement:kNameElementName text:group.title] ) return NO;
+        if ( ![serializer writeElement:kUuidElementName uuid:group.uuid] ) return NO;
+        if ( ![self writeIcon:group.icon customIconPreset:48 serializer:serializer] ) return NO;
+        if ( ![self writeTimes:group.fields serializer:serializer] ) return NO;
+        if ( ![self writeTags:group.fields.tags serializer:serializer] ) return NO;
+
+        if ( !group.fields.isExpanded ) {
+            if ( ![serializer writeElement:kIsExpandedElementName boolean:NO] ) return NO;
+        }
+
+        NSArray<Node*>* children = group.children;
+
+        if ( concurrently ) {
+            BOOL ok = [serializer writeConcurrently:children block:^BOOL(id item, id<IXmlSerializer> fragmentSerializer) {
+                return [self writeNode:item serializer:fragmentSerializer];
+            }];
+
+            if ( !ok ) {
+                return NO;
+            }
+        }
+        else {
+            for ( Node* child in children ) {
+                if ( ![self writeNode:child serializer:serializer] ) {
+                    return NO;
+                }
+            }
+        }
+
+        if ( ![self writeCustomData:group.fields.customData serializer:serializer] ) return NO;
+
+        if ( group.fields.notes.length ) {
+            if ( ![serializer writeElement:kNotesElementName text:group.fields.notes] ) return NO;
+        }
+
+        if ( group.fields.defaultAutoTypeSequence.length ) {
+            if ( ![serializer writeElement:kDefaultAutoTypeSequenceElementName text:group.fields.defaultAutoTypeSequence] ) return NO;
+        }
+
+        if ( group.fields.enableAutoType != nil ) {
+            if ( ![serializer writeElement:kEnableAutoTypeElementName boolean:group.fields.enableAutoType.boolValue] ) return NO;
+        }
+
+        if ( group.fields.enableSearching != nil ) {
+            if ( ![serializer writeElement:kEnableSearchingElementName boolean:group.fields.enableSearching.boolValue] ) return NO;
+        }
+
+        if ( group.fields.lastTopVisibleEntry && ![group.fields.lastTopVisibleEntry isEqual:NSUUID.zero] ) {
+            if ( ![serializer writeElement:kLastTopVisibleElementName uuid:group.fields.lastTopVisibleEntry] ) return NO;
+        }
+
+        if ( group.fields.previousParentGroup ) {
+            if ( ![serializer writeElement:kPreviousParentGroupElementName uuid:group.fields.previousParentGroup] ) return NO;
+        }
+
+        if ( ![self writeUnmanagedChildren:group serializer:serializer] ) return NO;
+
+        [serializer endElement];
+
+        return YES;
+    }
+}
+
+- (BOOL)writeNode:(Node*)node serializer:(id<IXmlSerializer>)serializer {
+    if ( node.isGroup ) {
+        return [self writeGroup:node serializer:serializer concurrently:NO];
+    }
+    else {
+        return [self writeEntry:node historical:NO serializer:serializer];
+    }
+}
+
+- (BOOL)writeEntry:(Node*)node historical:(BOOL)historical serializer:(id<IXmlSerializer>)serializer {
+    @autoreleasepool {
+        if ( ![serializer beginElement:kEntryElementName] ) return NO;
+
+        if ( ![serializer writeElement:kUuidElementName uuid:node.uuid] ) return NO;
+        if ( ![self writeIcon:node.icon customIconPreset:0 serializer:serializer] ) return NO;
+
+        if ( ![self writeString:@"Title" value:node.title protected:NO serializer:serializer] ) return NO;
+        if ( ![self writeString:@"UserName" value:node.fields.username protected:NO serializer:serializer] ) return NO;
+        if ( ![self writeString:@"Password" value:node.fields.password protected:YES serializer:serializer] ) return NO;
+        if ( ![self writeString:@"URL" value:node.fields.url protected:NO serializer:serializer] ) return NO;
+        if ( ![self writeString:@"Notes" value:node.fields.notes protected:NO serializer:serializer] ) return NO;
+
+        const NSSet<NSString*>* reserved = Entry.reservedCustomFieldKeys;
+        MutableOrderedDictionary<NSString*, StringValue*>* customFields = node.fields.customFields;
+
+        for ( NSString* key in customFields.allKeys ) {
+            if ( [reserved containsObject:key] ) {
+                continue;
+            }
+
+            StringValue* value = customFields[key];
+
+            if ( ![serializer beginElement:kStringElementName] ) return NO;
+            if ( ![serializer writeElement:kKeyElementName text:key] ) return NO;
+            if ( ![serializer writeElement:kValueElementName text:value.value protected:value.protected trimWhitespace:NO] ) return NO;
+
+            [serializer endElement];
+        }
+
+        for ( NSString* filename in node.fields.attachments ) {
+            NSInteger index = [self indexOfAttachment:node.fields.attachments[filename]];
+
+            if ( index == -1 ) {
+                NSLog(@"WARNWARN: Attachment not found in pool!");
+                continue;
+            }
+
+            if ( ![serializer beginElement:kBinaryElementName] ) return NO;
+            if ( ![serializer writeElement:kKeyElementName text:filename] ) return NO;
+            if ( ![serializer writeElement:kValueElementName text:@"" attributes:@{ kBinaryValueAttributeRef : @(index).stringValue }] ) return NO;
+
+            [serializer endElement];
+        }
+
+        if ( ![self writeTimes:node.fields serializer:serializer] ) return NO;
+        if ( ![self writeTags:node.fields.tags serializer:serializer] ) return NO;
+        if ( ![self writeCustomData:node.fields.customData serializer:serializer] ) return NO;
+
+        if ( node.fields.foregroundColor.length ) {
+            if ( ![serializer writeElement:kForegroundColorElementName text:node.fields.foregroundColor] ) return NO;
+        }
+
+        if ( node.fields.backgroundColor.length ) {
+            if ( ![serializer writeElement:kBackgroundColorElementName text:node.fields.backgroundColor] ) return NO;
+        }
+
+        if ( node.fields.overrideURL.length ) {
+            if ( ![serializer writeElement:kOverrideURLElementName text:node.fields.overrideURL] ) return NO;
+        }
+
+        if ( !node.fields.qualityCheck ) {
+            if ( ![serializer writeElement:kQualityCheckElementName boolean:NO] ) return NO;
+        }
+
+        if ( ![self writeAutoType:node.fields.autoType serializer:serializer] ) return NO;
+
+        if ( !historical && node.fields.keePassHistory.count ) {
+            if ( ![serializer beginElement:kHistoryElementName] ) return NO;
+
+            for ( Node* historicalNode in node.fields.keePassHistory ) {
+                if ( ![self writeEntry:historicalNode historical:YES serializer:serializer] ) return NO;
+            }
+
+            [serializer endElement];
+        }
+
+        if ( node.fields.previousParentGroup ) {
+            if ( ![serializer writeElement:kPreviousParentGroupElementName uuid:node.fields.previousParentGroup] ) return NO;
+        }
+
+        if ( ![self writeUnmanagedChildren:node serializer:serializer] ) return NO;
+
+        [serializer endElement];
+
+        return YES;
+    }
+}
+
+
+
+- (BOOL)writeString:(NSString*)key value:(NSString*)value protected:(BOOL)protected serializer:(id<IXmlSerializer>)serializer {
+    if ( !protected && value.length == 0 ) {
+        return YES;
+    }
+
+    if ( ![serializer beginElement:kStringElementName] ) return NO;
+    if ( ![serializer writeElement:kKeyElementName text:key] ) return NO;
+    if ( ![serializer writeElement:kValueElementName text:value protected:protected trimWhitespace:NO] ) return NO;
+
+    [serializer endElement];
+
+    return YES;
+}
+
+- (BOOL)writeIcon:(NodeIcon*)icon customIconPreset:(NSInteger)customIconPreset serializer:(id<IXmlSerializer>)serializer {
+    if ( !icon ) {
+        return YES;
+    }
+
+    if ( !icon.isCustom ) {
+        return [serializer writeElement:kIconIdElementName integer:icon.preset];
+    }
+
+    if ( icon.uuid == nil || !self.iconPool[icon.uuid] ) {
+        NSLog(@"WARNWARN - Custom Icon is not in pool or is custom but nil UUID - [%@]", icon.uuid);
+        return YES;
+    }
+
+    if ( ![serializer writeElement:kIconIdElementName integer:customIconPreset] ) return NO;
+
+    return [serializer writeElement:kCustomIconUuidElementName uuid:icon.uuid];
+}
+
+- (BOOL)writeTimes:(NodeFields*)fields serializer:(id<IXmlSerializer>)serializer {
+    if ( ![serializer beginElement:kTimesElementName] ) return NO;
+
+    if ( fields.modified && ![serializer writeElement:kLastModificationTimeElementName date:fields.modified] ) return NO;
+    if ( fields.created && ![serializer writeElement:kCreationTimeElementName date:fields.created] ) return NO;
+    if ( fields.accessed && ![serializer writeElement:kLastAccessTimeElementName date:fields.accessed] ) return NO;
+    if ( fields.expires && ![serializer writeElement:kExpiryTimeElementName date:fields.expires] ) return NO;
+    if ( ![serializer writeElement:kExpiresElementName boolean:fields.expires != nil] ) return NO;
+    if ( fields.usageCount && ![serializer writeElement:kUsageCountElementName integer:fields.usageCount.integerValue] ) return NO;
+    if ( fields.locationChanged && ![serializer writeElement:kLocationChangedTimeElementName date:fields.locationChanged] ) return NO;
+
+    [serializer endElement];
+
+    return YES;
+}
+
+- (BOOL)writeTags:(NSSet<NSString*>*)tags serializer:(id<IXmlSerializer>)serializer {
+    if ( !tags.count ) {
+        return YES;
+    }
+
+    NSArray<NSString*>* trimmed = [tags.allObjects map:^id _Nonnull(NSString * _Nonnull obj, NSUInteger idx) {
+        return [Utils trim:obj];
+    }];
+
+    NSArray<NSString*>* filtered = [trimmed filter:^BOOL(NSString * _Nonnull obj) {
+        return obj.length > 0;
+    }];
+
+    NSString* str = [[NSSet setWithArray:filtered].allObjects componentsJoinedByString:@";"];
+
+    return [serializer writeElement:kTagsElementName text:str];
+}
+
+- (BOOL)writeCustomData:(NSDictionary<NSString*, ValueWithModDate*>*)customData serializer:(id<IXmlSerializer>)serializer {
+    if ( !customData.count ) {
+        return YES;
+    }
+
+    if ( ![serializer beginElement:kCustomDataElementName] ) return NO;
+
+    for ( NSString* key in customData.allKeys ) {
+        ValueWithModDate* vm = customData[key];
+
+        if ( ![serializer beginElement:kCustomDataItemElementName] ) return NO;
+        if ( ![serializer writeElement:kKeyElementName text:key attributes:nil trimWhitespace:NO] ) return NO;
+        if ( ![serializer writeElement:kValueElementName text:vm.value attributes:nil trimWhitespace:NO] ) return NO;
+
+        if ( vm.modified ) {
+            if ( ![serializer writeElement:kLastModificationTimeElementName date:vm.modified] ) return NO;
+        }
+
+        [serializer endElement];
+    }
+
+    [serializer endElement];
+
+    return YES;
+}
+
+- (BOOL)writeAutoType:(AutoType*)autoType serializer:(id<IXmlSerializer>)serializer {
+    if ( !autoType ) {
+        return YES;
+    }
+
+    if ( autoType.enabled && autoType.dataTransferObfuscation == 0 && !autoType.defaultSequence.length && !autoType.asssociations.count ) {
+        return YES;
+    }
+
+    if ( ![serializer beginElement:kAutoTypeElementName] ) return NO;
+    if ( ![serializer writeElement:kEnabledElementName boolean:autoType.enabled] ) return NO;
+    if ( ![serializer writeElement:kDataTransferObfuscationElementName integer:autoType.dataTransferObfuscation] ) return NO;
+
+    if ( autoType.defaultSequence.length ) {
+        if ( ![serializer writeElement:kDefaultSequenceElementName text:autoType.defaultSequence] ) return NO;
+    }
+
+    for ( AutoTypeAssociation* association in autoType.asssociations ) {
+        if ( ![serializer beginElement:kAutoTypeAssociationElementName] ) return NO;
+        if ( ![serializer writeElement:kWindowElementName text:association.window ? association.window : @""] ) return NO;
+        if ( ![serializer writeElement:kKeystrokeSequenceElementName text:association.keystrokeSequence ? association.keystrokeSequence : @""] ) return NO;
+
+        [serializer endElement];
+    }
+
+    [serializer endElement];
+
+    return YES;
+}
+
+- (BOOL)writeUnmanagedChildren:(Node*)node serializer:(id<IXmlSerializer>)serializer {
+    if ( !node.linkedData || ![node.linkedData isKindOfClass:NSArray.class] ) {
+        return YES;
+    }
+
+    for ( id<XmlParsingDomainObject> unmanagedChild in (NSArray<id<XmlParsingDomainObject>>*)node.linkedData ) {
+        if ( ![unmanagedChild writeXml:serializer] ) {
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+- (NSInteger)indexOfAttachment:(DatabaseAttachment*)attachment {
+    if ( self.indexByDigest ) {
+        NSNumber* index = self.indexByDigest[attachment.digestHash];
+        return index ? index.integerValue : -1;
+    }
+
+    NSUInteger index = [self.attachmentsPool indexOfObjectPassingTest:^BOOL(DatabaseAttachment * _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
+        return [obj.digestHash isEqualToString:attachment.digestHash];
+    }];
+
+    return index == NSNotFound ? -1 : index;
+}
+
+@end
@@ -40,6 +40,7 @@ NS_ASSUME_NONNULL_BEGIN
 + (NSDictionary<NSUUID*, NSDate*>*)getDeletedObjects:(RootXmlDomainObject*)existingRootXmlDocument;
 + (NSDictionary<NSUUID*, NodeIcon*>*)getCustomIcons:(Meta*_Nullable)meta;
 + (NSArray<DatabaseAttachment*>*)getV3Attachments:(RootXmlDomainObject*)xmlDoc;
++ (NSArray<DatabaseAttachment*>*)getV3AttachmentsFromMeta:(Meta*_Nullable)meta;
 
 @end
 
@@ -12,6 +12,8 @@
 #import "KeePassConstants.h"
 #import "NSArray+Extensions.h"
 
+static const BOOL kDirectNodeXmlWriter = YES;
+
 @implementation KeePassXmlModelAdaptor
 
 + (Node *)toStrongboxModel:(RootXmlDomainObject *)xmlRoot error:(NSError *__autoreleasing  _Nullable *)error {
@@ -101,14 +103,26 @@
 
     XmlStrongboxNodeModelAdaptor *adaptor = [[XmlStrongboxNodeModelAdaptor alloc] init];
     
-    KeePassGroup* rootXmlGroup = [adaptor toKeePassModel:rootNode context:context minimalAttachmentPool:minimalAttachmentPool iconPool:iconPool error:error];
-
-    if(!rootXmlGroup) {
-        NSLog(@"Could not serialize groups/entries.");
-        return nil;
+    if ( kDirectNodeXmlWriter ) {
+        KeePassNodeXmlWriter* nodeWriter = [adaptor toKeePassNodeWriter:rootNode minimalAttachmentPool:minimalAttachmentPool iconPool:iconPool error:error];
+        
+        if(!nodeWriter) {
+            NSLog(@"Could not serialize groups/entries.");
+            return nil;
+        }
+        
+        ret.keePassFile.root.nodeWriter = nodeWriter;
     }
+    else {
+        KeePassGroup* rootXmlGroup = [adaptor toKeePassModel:rootNode context:context minimalAttachmentPool:minimalAttachmentPool iconPool:iconPool error:error];
 
-    ret.keePassFile.root.rootGroup = rootXmlGroup;
+        if(!rootXmlGroup) {
+            NSLog(@"Could not serialize groups/entries.");
+            return nil;
+        }
+
+        ret.keePassFile.root.rootGroup = rootXmlGroup;
+    }
 
     
 
@@ -253,7 +267,11 @@
 }
 
 + (NSArray<DatabaseAttachment*>*)getV3Attachments:(RootXmlDomainObject*)xmlDoc {
-    NSArray<V3Binary*>* v3Binaries = safeGetBinaries(xmlDoc);
+    return [self getV3AttachmentsFromMeta:xmlDoc.keePassFile.meta];
+}
+
++ (NSArray<DatabaseAttachment*>*)getV3AttachmentsFromMeta:(Meta*)meta {
+    NSArray<V3Binary*>* v3Binaries = ( meta && meta.v3binaries ) ? meta.v3binaries.binaries : @[];
     
     NSMutableArray<DatabaseAttachment*> *attachments = [NSMutableArray array];
     
@@ -268,14 +286,6 @@
     return attachments;
 }
 
-static NSMutableArray<V3Binary*>* safeGetBinaries(RootXmlDomainObject* root) {
-    if(root && root.keePassFile && root.keePassFile.meta && root.keePassFile.meta.v3binaries) {
-        return root.keePassFile.meta.v3binaries.binaries;
-    }
-    
-    return [NSMutableArray array];
-}
-
 static KeePassGroup *getExistingRootKeePassGroup(RootXmlDomainObject * _Nonnull existingRootXmlDocument) {
     
     
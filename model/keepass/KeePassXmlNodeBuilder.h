@@ -0,0 +1,37 @@
+//
+//  KeePassXmlNodeBuilder.h
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "Node.h"
+#import "Meta.h"
+#import "DatabaseAttachment.h"
+#import "XmlParsingDomainObject.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface KeePassXmlNodeBuilder : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+
+
+- (instancetype)initWithAttachments:(NSArray<DatabaseAttachment*>*_Nullable)attachments;
+
+@property (readonly) BOOL isEngaged;
+@property (readonly, nullable) Node* rootNode;
+@property (readonly) NSDictionary<NSUUID*, NodeIcon*>* customIconPool;
+@property (readonly) NSArray<DatabaseAttachment*>* attachments;
+
+- (BOOL)beginWithMeta:(Meta*_Nullable)meta;
+
+- (id<XmlParsingDomainObject>_Nullable)childHandlerFor:(NSString*)xmlElementName parent:(id)parentObject;
+- (BOOL)consumeCompletedObject:(id)completedObject parent:(id)parentObject;
+
+@end
+
+NS_ASSUME_NONNULL_END
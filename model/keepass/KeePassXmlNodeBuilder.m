@@ -0,0 +1,204 @@
+//
+//  KeePassXmlNodeBuilder.m
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import "KeePassXmlNodeBuilder.h"
+#import "KeePassXmlModelAdaptor.h"
+#import "XmlStrongboxNodeModelAdaptor.h"
+#import "KeePassGroup.h"
+#import "Entry.h"
+#import "Root.h"
+#import "KeePassConstants.h"
+
+@interface KeePassXmlNodeBuilder ()
+
+@property (nullable) NSArray<DatabaseAttachment*>* innerHeaderAttachments;
+@property XmlStrongboxNodeModelAdaptor* adaptor;
+@property NSMutableSet<NSUUID*>* usedIds;
+@property NSMapTable<KeePassGroup*, NSNumber*>* reservedGroupIds;
+@property NSMapTable<id, NSMutableArray<Node*>*>* pendingChildren;
+@property NSMutableArray<Entry*>* freeEntries;
+@property NSMutableArray<KeePassGroup*>* freeGroups;
+
+@end
+
+@implementation KeePassXmlNodeBuilder
+
+- (instancetype)initWithAttachments:(NSArray<DatabaseAttachment *> *)attachments {
+    if ( self = [super init] ) {
+        _innerHeaderAttachments = attachments;
+        _adaptor = [[XmlStrongboxNodeModelAdaptor alloc] init];
+        _usedIds = NSMutableSet.set;
+        _reservedGroupIds = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                                  valueOptions:NSPointerFunctionsStrongMemory];
+        _pendingChildren = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                                 valueOptions:NSPointerFunctionsStrongMemory];
+        _freeEntries = NSMutableArray.array;
+        _freeGroups = NSMutableArray.array;
+        _customIconPool = @{};
+        _attachments = @[];
+    }
+    
+    return self;
+}
+
+- (BOOL)beginWithMeta:(Meta *)meta {
+    if ( self.isEngaged || meta == nil ) {
+        return NO;
+    }
+    
+    _customIconPool = [KeePassXmlModelAdaptor getCustomIcons:meta];
+    _attachments = self.innerHeaderAttachments ? self.innerHeaderAttachments : [KeePassXmlModelAdaptor getV3AttachmentsFromMeta:meta];
+    _isEngaged = YES;
+    
+    return YES;
+}
+
+- (id<XmlParsingDomainObject>)childHandlerFor:(NSString *)xmlElementName parent:(id)parentObject {
+    if ( !self.isEngaged ) {
+        return nil;
+    }
+    
+    BOOL parentIsGroup = [parentObject isKindOfClass:KeePassGroup.class];
+    
+    if ( parentIsGroup && ( [xmlElementName isEqualToString:kEntryElementName] || [xmlElementName isEqualToString:kGroupElementName] ) ) {
+        [self reserveIdOf:parentObject];
+    }
+    
+    if ( parentIsGroup && [xmlElementName isEqualToString:kEntryElementName] ) {
+        Entry* entry = self.freeEntries.lastObject;
+        
+        if ( entry ) {
+            [self.freeEntries removeLastObject];
+            return entry;
+        }
+        
+        return [[Entry alloc] initWithContext:((KeePassGroup*)parentObject).context];
+    }
+    
+    if ( [xmlElementName isEqualToString:kGroupElementName] ) {
+        BOOL parentIsRoot = [parentObject isKindOfClass:Root.class];
+        
+        if ( parentIsRoot && self.rootNode ) {
+            NSLog(@"WARN: Multiple Root Groups found. Ignoring extra.");
+            return [[BaseXmlDomainObjectHandler alloc] initWithXmlElementName:xmlElementName context:((Root*)parentObject).context];
+        }
+        
+        if ( parentIsRoot || parentIsGroup ) {
+            KeePassGroup* group = self.freeGroups.lastObject;
+            
+            if ( group ) {
+                [self.freeGroups removeLastObject];
+                return group;
+            }
+            
+            return [[KeePassGroup alloc] initWithContext:((BaseXmlDomainObjectHandler*)parentObject).context];
+        }
+    }
+    
+    return nil;
+}
+
+- (BOOL)consumeCompletedObject:(id)completedObject parent:(id)parentObject {
+    if ( !self.isEngaged ) {
+        return NO;
+    }
+    
+    if ( [completedObject isKindOfClass:Entry.class] && [parentObject isKindOfClass:KeePassGroup.class] ) {
+        Node* entryNode = [self.adaptor nodeFromEntry:completedObject
+                                            groupNode:nil
+                                      attachmentsPool:self.attachments
+                                       customIconPool:self.customIconPool
+                                              usedIds:self.usedIds
+                                           historical:NO];
+        
+        [[self pendingChildrenOf:parentObject] addObject:entryNode];
+        
+        [completedObject prepareForReuse];
+        [self.freeEntries addObject:completedObject];
+        
+        return YES;
+    }
+    
+    if ( [parentObject isKindOfClass:Root.class] && self.rootNode && ![completedObject isKindOfClass:KeePassGroup.class] &&
+         [[completedObject originalElementName] isEqualToString:kGroupElementName] ) {
+        [parentObject addUnknownChildObject:completedObject];
+        return YES;
+    }
+    
+    if ( [completedObject isKindOfClass:KeePassGroup.class] ) {
+        BOOL isRootGroup = [parentObject isKindOfClass:Root.class];
+        
+        if ( !isRootGroup && ![parentObject isKindOfClass:KeePassGroup.class] ) {
+            return NO;
+        }
+        
+        BOOL duplicateId = [self reserveIdOf:completedObject];
+        [self.reservedGroupIds removeObjectForKey:completedObject];
+        
+        NSMutableSet<NSUUID*>* usedIds = duplicateId ? [NSMutableSet setWithObject:((KeePassGroup*)completedObject).uuid] : NSMutableSet.set;
+        
+        Node* groupNode = [self.adaptor groupNodeFromGroup:completedObject
+                                                parentNode:nil
+                                            customIconPool:self.customIconPool
+                                                   usedIds:usedIds];
+        
+        NSArray<Node*>* children = [self.pendingChildren objectForKey:completedObject];
+        if ( children.count ) {
+            [groupNode adoptChildren:children keePassGroupTitleRules:YES];
+        }
+        [self.pendingChildren removeObjectForKey:completedObject];
+        
+        [completedObject prepareForReuse];
+        [self.freeGroups addObject:completedObject];
+        
+        if ( isRootGroup ) {
+            Node* rootNode = [[Node alloc] initAsRoot:nil];
+            [rootNode adoptChild:groupNode keePassGroupTitleRules:YES];
+            _rootNode = rootNode;
+        }
+        else {
+            [[self pendingChildrenOf:parentObject] addObject:groupNode];
+        }
+        
+        return YES;
+    }
+    
+    return NO;
+}
+
+- (BOOL)reserveIdOf:(KeePassGroup*)group {
+    if ( group.uuid == nil ) {
+        return NO;
+    }
+    
+    NSNumber* reserved = [self.reservedGroupIds objectForKey:group];
+    
+    if ( reserved && [self.usedIds containsObject:group.uuid] ) {
+        return reserved.boolValue;
+    }
+    
+    BOOL duplicate = [self.usedIds containsObject:group.uuid];
+    
+    [self.usedIds addObject:group.uuid];
+    [self.reservedGroupIds setObject:@(duplicate) forKey:group];
+    
+    return duplicate;
+}
+
+- (NSMutableArray<Node*>*)pendingChildrenOf:(id)parentObject {
+    NSMutableArray<Node*>* children = [self.pendingChildren objectForKey:parentObject];
+    
+    if ( children == nil ) {
+        children = NSMutableArray.array;
+        [self.pendingChildren setObject:children forKey:parentObject];
+    }
+    
+    return children;
+}
+
+@end
@@ -9,6 +9,7 @@
 #import "BaseXmlDomainObjectHandler.h"
 #import "KeePassGroup.h"
 #import "DeletedObjects.h"
+#import "KeePassNodeXmlWriter.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -19,6 +20,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (nonatomic) KeePassGroup* rootGroup;
 @property (nonatomic) DeletedObjects *deletedObjects;
+@property (nonatomic, nullable) KeePassNodeXmlWriter* nodeWriter;
 
 @end
 
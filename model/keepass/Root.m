@@ -74,9 +74,14 @@
         return NO;
     }
 
-    if (self.rootGroup) {
+    if (self.nodeWriter) {
+        if ( ![self.nodeWriter writeXml:serializer] ) {
+            return NO;
+        }
+    }
+    else if (self.rootGroup) {
         @autoreleasepool {
-            [self.rootGroup writeXml:serializer];
+            [self.rootGroup writeXml:serializer concurrently:YES];
         }
     }
     
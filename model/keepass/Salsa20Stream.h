@@ -16,6 +16,7 @@ NS_ASSUME_NONNULL_BEGIN
 -(id)init NS_UNAVAILABLE;
 -(id)initWithKey:(const NSData*)key NS_DESIGNATED_INITIALIZER;
 -(NSData *)xor:(NSData *)ct;
+-(void)xorInPlace:(uint8_t *)buffer length:(NSUInteger)length;
 
 @property (nonatomic, readonly) NSData* key;
 
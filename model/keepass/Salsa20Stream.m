@@ -8,14 +8,18 @@
 
 #import "Salsa20Stream.h"
 #import "sodium.h"
+#import "InnerStreamKeystream.h"
 #import <CommonCrypto/CommonDigest.h>
 
 //static const uint32_t kIvSize = 8;
 static const uint32_t kKeySize = 32;
-static const uint32_t kBlockSize = 64;
 
 static const uint8_t iv[] = {0xE8, 0x30, 0x09, 0x4B, 0x97, 0x20, 0x5D, 0x2A};
 
+static void generateKeystream(uint8_t* keystream, size_t length, uint64_t firstBlock, const uint8_t* nonce, const uint8_t* key) {
+    crypto_stream_salsa20_xor_ic(keystream, keystream, length, nonce, firstBlock, key);
+}
+
 @interface Salsa20Stream ()
 
 @property (nonatomic) uint64_t bytesProcessed;
@@ -23,7 +27,9 @@ static const uint8_t iv[] = {0xE8, 0x30, 0x09, 0x4B, 0x97, 0x20, 0x5D, 0x2A};
 
 @end
 
-@implementation Salsa20Stream
+@implementation Salsa20Stream {
+    InnerStreamKeystream _keystream;
+}
 
 + (void)initialize {
     if(self == [Salsa20Stream class]) {
@@ -60,25 +66,29 @@ static const uint8_t iv[] = {0xE8, 0x30, 0x09, 0x4B, 0x97, 0x20, 0x5D, 0x2A};
         
         self.bytesProcessed = 0;
         self.hashedKey = hashedKey;
+        
+        innerStreamKeystreamInit(&_keystream, generateKeystream);
     }
     
     return self;
 }
 
--(NSData*)xor:(NSData *)ct {
-    uint32_t currentBlock = (uint32_t)self.bytesProcessed / kBlockSize;
-    int offset = self.bytesProcessed % kBlockSize;
-
-    NSMutableData *xorBlock = [NSMutableData dataWithLength:ct.length + kBlockSize];
-    NSRange subRange = NSMakeRange(offset, ct.length);
-    [xorBlock replaceBytesInRange:subRange withBytes:ct.bytes];
-
-    NSMutableData *outData = [[NSMutableData alloc] initWithLength:ct.length + kBlockSize];
+- (void)dealloc {
+    innerStreamKeystreamWipe(&_keystream);
+}
 
-    crypto_stream_salsa20_xor_ic(outData.mutableBytes, xorBlock.bytes, xorBlock.length, iv, currentBlock, self.hashedKey.bytes);
+-(void)xorInPlace:(uint8_t *)buffer length:(NSUInteger)length {
+    innerStreamKeystreamXor(&_keystream, buffer, length, iv, self.hashedKey.bytes);
+    
+    self.bytesProcessed += length;
+}
 
-    self.bytesProcessed += ct.length;
-    return [outData subdataWithRange:subRange];
+-(NSData*)xor:(NSData *)ct {
+    NSMutableData *outData = [NSMutableData dataWithData:ct];
+    
+    [self xorInPlace:outData.mutableBytes length:outData.length];
+    
+    return outData;
 }
 
 @end
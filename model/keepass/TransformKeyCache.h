@@ -0,0 +1,23 @@
+//
+//  TransformKeyCache.h
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "KdfParameters.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface TransformKeyCache : NSObject
+
+- (NSData*_Nullable)transformKeyForCompositeKey:(NSData*)compositeKey kdfParameters:(KdfParameters*)kdfParameters;
+- (void)setTransformKey:(NSData*)transformKey compositeKey:(NSData*)compositeKey kdfParameters:(KdfParameters*)kdfParameters;
+
+- (void)clear;
+
+@end
+
+NS_ASSUME_NONNULL_END
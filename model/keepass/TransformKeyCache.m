@@ -0,0 +1,104 @@
+//
+//  TransformKeyCache.m
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import "TransformKeyCache.h"
+#import "VariantDictionary.h"
+#import <CommonCrypto/CommonDigest.h>
+
+static const NSUInteger kMaxCachedKeys = 8;
+
+static void wipe(NSMutableData* data) {
+    volatile uint8_t* bytes = data.mutableBytes;
+    
+    for ( NSUInteger i = 0; i < data.length; i++ ) {
+        bytes[i] = 0;
+    }
+}
+
+@interface TransformKeyCache ()
+
+@property (readonly) NSMutableDictionary<NSData*, NSMutableData*>* keys;
+@property (readonly) NSMutableArray<NSData*>* order;
+
+@end
+
+@implementation TransformKeyCache
+
+- (instancetype)init {
+    if ( self = [super init] ) {
+        _keys = NSMutableDictionary.dictionary;
+        _order = NSMutableArray.array;
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    [self clear];
+}
+
++ (NSData*)cacheKeyForCompositeKey:(NSData*)compositeKey kdfParameters:(KdfParameters*)kdfParameters {
+    NSData* params = [VariantDictionary toData:kdfParameters.parameters];
+    NSData* uuid = kdfParameters.uuid ? [kdfParameters.uuid.UUIDString dataUsingEncoding:NSUTF8StringEncoding] : NSData.data;
+    
+    CC_SHA256_CTX ctx;
+    CC_SHA256_Init(&ctx);
+    CC_SHA256_Update(&ctx, compositeKey.bytes, (CC_LONG)compositeKey.length);
+    CC_SHA256_Update(&ctx, uuid.bytes, (CC_LONG)uuid.length);
+    CC_SHA256_Update(&ctx, params.bytes, (CC_LONG)params.length);
+    
+    NSMutableData* digest = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256_Final(digest.mutableBytes, &ctx);
+    
+    return digest.copy;
+}
+
+- (NSData *)transformKeyForCompositeKey:(NSData *)compositeKey kdfParameters:(KdfParameters *)kdfParameters {
+    NSData* cacheKey = [TransformKeyCache cacheKeyForCompositeKey:compositeKey kdfParameters:kdfParameters];
+    
+    @synchronized (self) {
+        NSMutableData* found = self.keys[cacheKey];
+        
+        return found ? [NSData dataWithData:found] : nil;
+    }
+}
+
+- (void)setTransformKey:(NSData *)transformKey compositeKey:(NSData *)compositeKey kdfParameters:(KdfParameters *)kdfParameters {
+    NSData* cacheKey = [TransformKeyCache cacheKeyForCompositeKey:compositeKey kdfParameters:kdfParameters];
+    
+    @synchronized (self) {
+        NSMutableData* existing = self.keys[cacheKey];
+        if ( existing ) {
+            wipe(existing);
+            [self.order removeObject:cacheKey];
+        }
+        
+        self.keys[cacheKey] = transformKey.mutableCopy;
+        [self.order addObject:cacheKey];
+        
+        while ( self.order.count > kMaxCachedKeys ) {
+            NSData* oldest = self.order.firstObject;
+            wipe(self.keys[oldest]);
+            [self.keys removeObjectForKey:oldest];
+            [self.order removeObjectAtIndex:0];
+        }
+    }
+}
+
+- (void)clear {
+    @synchronized (self) {
+        for ( NSMutableData* key in self.keys.allValues ) {
+            wipe(key);
+        }
+        
+        [self.keys removeAllObjects];
+        [self.order removeAllObjects];
+    }
+}
+
+@end
@@ -0,0 +1,43 @@
+//
+//  Utf8XmlWriter.h
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface Utf8XmlWriter : NSObject
+
+- (instancetype)init;
+- (instancetype)initWithOutputStream:(NSOutputStream*_Nullable)outputStream NS_DESIGNATED_INITIALIZER;
+
+- (void)setPrettyPrinting:(NSString*)indentation withLineBreak:(NSString*)lineBreak;
+
+@property (nonatomic) BOOL automaticEmptyElements;
+
+- (void)writeStartDocumentWithEncodingAndVersion:(NSString*)encoding version:(NSString*)version;
+- (void)writeEndDocument;
+
+- (void)writeStartElement:(NSString*)localName;
+- (void)writeAttribute:(NSString*)localName value:(NSString*)value;
+- (void)writeCharacters:(NSString*)text;
+- (void)writeEndElement;
+
+- (void)writeRaw:(const void*)bytes length:(NSUInteger)length;
+
+@property (readonly) NSUInteger position;
+
+- (void)flush;
+
+- (NSString*)toString;
+- (NSData*)toData;
+
+@property (readonly, nullable) NSError* streamError;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,477 @@
+//
+//  Utf8XmlWriter.m
+//  Strongbox
+//
+//  Created by Strongbox on 18/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import "Utf8XmlWriter.h"
+#import "KeePassXmlParser.h"
+#import "Utils.h"
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+static const size_t kOutputBufferSize = 256 * 1024;
+#define kScratchSize (16 * 1024)
+
+static inline BOOL needsAttention(uint8_t c) {
+    return c < 0x20 || c == '"' || c == '&' || c == '\'' || c == '<' || c == '>' || c == 0xEF;
+}
+
+static size_t xmlCleanPrefixLength(const uint8_t* p, size_t n) {
+    size_t i = 0;
+    
+#if defined(__aarch64__)
+    const uint8x16_t space = vdupq_n_u8(0x20);
+    const uint8x16_t quot = vdupq_n_u8('"');
+    const uint8x16_t amp = vdupq_n_u8('&');
+    const uint8x16_t apos = vdupq_n_u8('\'');
+    const uint8x16_t lt = vdupq_n_u8('<');
+    const uint8x16_t gt = vdupq_n_u8('>');
+    const uint8x16_t ef = vdupq_n_u8(0xEF);
+    
+    for ( ; i + 16 <= n; i += 16 ) {
+        uint8x16_t v = vld1q_u8(p + i);
+        uint8x16_t m = vcltq_u8(v, space);
+        m = vorrq_u8(m, vceqq_u8(v, quot));
+        m = vorrq_u8(m, vceqq_u8(v, amp));
+        m = vorrq_u8(m, vceqq_u8(v, apos));
+        m = vorrq_u8(m, vceqq_u8(v, lt));
+        m = vorrq_u8(m, vceqq_u8(v, gt));
+        m = vorrq_u8(m, vceqq_u8(v, ef));
+        
+        if ( vmaxvq_u8(m) ) {
+            break;
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128i space = _mm_set1_epi8(0x20);
+    const __m128i quot = _mm_set1_epi8('"');
+    const __m128i amp = _mm_set1_epi8('&');
+    const __m128i apos = _mm_set1_epi8('\'');
+    const __m128i lt = _mm_set1_epi8('<');
+    const __m128i gt = _mm_set1_epi8('>');
+    const __m128i ef = _mm_set1_epi8((char)0xEF);
+    
+    for ( ; i + 16 <= n; i += 16 ) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(p + i));
+        __m128i printable = _mm_cmpeq_epi8(_mm_max_epu8(v, space), v);
+        __m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, quot), _mm_cmpeq_epi8(v, amp));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, apos));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, lt));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, gt));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, ef));
+        
+        int special = (~_mm_movemask_epi8(printable) & 0xFFFF) | _mm_movemask_epi8(m);
+        if ( special ) {
+            return i + __builtin_ctz(special);
+        }
+    }
+#endif
+    
+    for ( ; i < n; i++ ) {
+        if ( needsAttention(p[i]) ) {
+            break;
+        }
+    }
+    
+    return i;
+}
+
+static NSData* utf8Bytes(NSString* string) {
+    return [string dataUsingEncoding:NSUTF8StringEncoding allowLossyConversion:YES];
+}
+
+@interface Utf8XmlWriter ()
+
+@property (readonly) NSMapTable<NSString*, NSData*>* nameCache;
+@property (readonly) NSMutableArray<NSData*>* elementStack;
+
+@property (nullable) NSOutputStream* outputStream;
+@property (nullable) NSMutableData* document;
+
+@property (nullable) NSData* indentation;
+@property (nullable) NSData* lineBreak;
+
+@property NSError* error;
+
+@end
+
+@implementation Utf8XmlWriter {
+    uint8_t* _buffer;
+    size_t _used;
+    NSUInteger _flushed;
+    uint8_t _scratch[kScratchSize];
+    
+    int _level;
+    BOOL _openElement;
+    BOOL _emptyElement;
+}
+
++ (NSDictionary<NSString*, NSData*>*)knownNameBytes {
+    static NSDictionary<NSString*, NSData*>* knownNameBytes;
+    static dispatch_once_t onceToken;
+    
+    dispatch_once(&onceToken, ^{
+        NSMutableDictionary<NSString*, NSData*>* ret = NSMutableDictionary.dictionary;
+        
+        for ( NSString* name in KeePassXmlParser.knownNames ) {
+            ret[name] = utf8Bytes(name);
+        }
+        
+        knownNameBytes = ret.copy;
+    });
+    
+    return knownNameBytes;
+}
+
+- (instancetype)init {
+    return [self initWithOutputStream:nil];
+}
+
+- (instancetype)initWithOutputStream:(NSOutputStream *)outputStream {
+    if ( self = [super init] ) {
+        _buffer = malloc(kOutputBufferSize);
+        _outputStream = outputStream;
+        _document = outputStream ? nil : NSMutableData.data;
+        _nameCache = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                           valueOptions:NSPointerFunctionsStrongMemory];
+        _elementStack = NSMutableArray.array;
+        _automaticEmptyElements = YES;
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    if ( _buffer ) {
+        free(_buffer);
+        _buffer = nil;
+    }
+}
+
+- (void)setPrettyPrinting:(NSString *)indentation withLineBreak:(NSString *)lineBreak {
+    self.indentation = indentation ? utf8Bytes(indentation) : nil;
+    self.lineBreak = lineBreak ? utf8Bytes(lineBreak) : nil;
+}
+
+
+
+- (void)flush {
+    if ( _used == 0 ) {
+        return;
+    }
+    
+    if ( self.document ) {
+        [self.document appendBytes:_buffer length:_used];
+    }
+    else if ( self.outputStream && !self.error ) {
+        [self writeToStream:_buffer length:_used];
+    }
+    
+    _flushed += _used;
+    _used = 0;
+}
+
+- (NSUInteger)position {
+    return _flushed + _used;
+}
+
+- (void)writeToStream:(const uint8_t*)bytes length:(size_t)length {
+    size_t total = 0;
+    
+    while ( total < length ) {
+        NSInteger wrote = [self.outputStream write:&bytes[total] maxLength:length - total];
+        
+        if ( wrote <= 0 ) {
+            NSLog(@"WARNWARN: Could not write XML data to output stream...");
+            self.error = self.outputStream.streamError ? self.outputStream.streamError : [Utils createNSError:@"There was an error writing to output stream from Utf8XmlWriter." errorCode:-1];
+            return;
+        }
+        
+        total += wrote;
+    }
+}
+
+static inline void appendBytes(__unsafe_unretained Utf8XmlWriter* writer, const void* bytes, size_t length) {
+    if ( writer->_used + length > kOutputBufferSize ) {
+        [writer flush];
+        
+        if ( length > kOutputBufferSize ) {
+            writer->_flushed += length;
+            
+            if ( writer.document ) {
+                [writer.document appendBytes:bytes length:length];
+            }
+            else if ( !writer.error ) {
+                [writer writeToStream:bytes length:length];
+            }
+            return;
+        }
+    }
+    
+    memcpy(&writer->_buffer[writer->_used], bytes, length);
+    writer->_used += length;
+}
+
+static inline void appendLiteral(__unsafe_unretained Utf8XmlWriter* writer, const char* literal) {
+    appendBytes(writer, literal, strlen(literal));
+}
+
+static inline void appendData(__unsafe_unretained Utf8XmlWriter* writer, NSData* data) {
+    appendBytes(writer, data.bytes, data.length);
+}
+
+static void appendEscaped(__unsafe_unretained Utf8XmlWriter* writer, const uint8_t* p, size_t n) {
+    while ( n ) {
+        size_t clean = xmlCleanPrefixLength(p, n);
+        
+        if ( clean ) {
+            appendBytes(writer, p, clean);
+            p += clean;
+            n -= clean;
+            
+            if ( !n ) {
+                break;
+            }
+        }
+        
+        uint8_t c = *p;
+        
+        switch ( c ) {
+            case '"':
+                appendBytes(writer, "&quot;", 6);
+                break;
+            case '\'':
+                appendBytes(writer, "&#39;", 5);
+                break;
+            case '&':
+                appendBytes(writer, "&amp;", 5);
+                break;
+            case '<':
+                appendBytes(writer, "&lt;", 4);
+                break;
+            case '>':
+                appendBytes(writer, "&gt;", 4);
+                break;
+            case '\t':
+            case '\n':
+            case '\r':
+                appendBytes(writer, &c, 1);
+                break;
+            case 0xEF:
+                if ( n >= 3 && p[1] == 0xBF && (p[2] == 0xBE || p[2] == 0xBF) ) { 
+                    p += 3;
+                    n -= 3;
+                    continue;
+                }
+                appendBytes(writer, &c, 1);
+                break;
+            default:
+                break;
+        }
+        
+        p++;
+        n--;
+    }
+}
+
+static void appendEscapedString(__unsafe_unretained Utf8XmlWriter* writer, NSString* string) {
+    CFIndex length = CFStringGetLength((CFStringRef)string);
+    if ( length == 0 ) {
+        return;
+    }
+    
+    const char* ascii = CFStringGetCStringPtr((CFStringRef)string, kCFStringEncodingASCII);
+    if ( ascii ) {
+        appendEscaped(writer, (const uint8_t*)ascii, length);
+        return;
+    }
+    
+    NSRange range = NSMakeRange(0, length);
+    
+    while ( range.length ) {
+        NSUInteger used = 0;
+        NSRange remaining;
+        
+        BOOL ok = [string getBytes:writer->_scratch
+                         maxLength:kScratchSize
+                        usedLength:&used
+                          encoding:NSUTF8StringEncoding
+                           options:NSStringEncodingConversionAllowLossy
+                             range:range
+                    remainingRange:&remaining];
+        
+        if ( !ok || used == 0 ) {
+            break;
+        }
+        
+        appendEscaped(writer, writer->_scratch, used);
+        range = remaining;
+    }
+}
+
+- (NSData*)bytesForName:(NSString*)name {
+    NSData* bytes = [self.nameCache objectForKey:name];
+    
+    if ( !bytes ) {
+        bytes = Utf8XmlWriter.knownNameBytes[name];
+        
+        if ( !bytes ) {
+            bytes = utf8Bytes(name);
+        }
+        
+        [self.nameCache setObject:bytes forKey:name];
+    }
+    
+    return bytes;
+}
+
+
+
+- (void)writeLinebreak {
+    if ( self.lineBreak ) {
+        appendData(self, self.lineBreak);
+    }
+}
+
+- (void)writeIndentation {
+    if ( self.indentation ) {
+        for ( int i = 0; i < _level; i++ ) {
+            appendData(self, self.indentation);
+        }
+    }
+}
+
+- (void)writeCloseElement:(BOOL)empty {
+    appendLiteral(self, empty ? " />" : ">");
+    _openElement = NO;
+}
+
+- (void)writeStartDocumentWithEncodingAndVersion:(NSString *)encoding version:(NSString *)version {
+    appendLiteral(self, "<?xml version=\"");
+    appendData(self, utf8Bytes(version ? version : @"1.0"));
+    appendLiteral(self, "\"");
+    
+    if ( encoding ) {
+        appendLiteral(self, " encoding=\"");
+        appendData(self, utf8Bytes(encoding));
+        appendLiteral(self, "\"");
+    }
+    
+    appendLiteral(self, " ?>");
+}
+
+- (void)writeEndDocument {
+    while ( _level > 0 ) {
+        [self writeEndElement];
+    }
+    
+    [self flush];
+}
+
+- (void)writeStartElement:(NSString *)localName {
+    if ( _openElement ) {
+        [self writeCloseElement:NO];
+    }
+    
+    [self writeLinebreak];
+    [self writeIndentation];
+    
+    NSData* name = [self bytesForName:localName];
+    
+    appendBytes(self, "<", 1);
+    appendData(self, name);
+    
+    [self.elementStack addObject:name];
+    
+    _openElement = YES;
+    _emptyElement = YES;
+    _level += 1;
+}
+
+- (void)writeAttribute:(NSString *)localName value:(NSString *)value {
+    if ( !_openElement ) {
+        @throw([NSException exceptionWithName:@"XMLWriterException" reason:@"No open start element" userInfo:NULL]);
+    }
+    
+    appendBytes(self, " ", 1);
+    appendData(self, [self bytesForName:localName]);
+    appendBytes(self, "=\"", 2);
+    appendEscapedString(self, value);
+    appendBytes(self, "\"", 1);
+}
+
+- (void)writeCharacters:(NSString *)text {
+    if ( _openElement ) {
+        [self writeCloseElement:NO];
+    }
+    
+    appendEscapedString(self, text);
+    
+    _emptyElement = NO;
+}
+
+- (void)writeRaw:(const void *)bytes length:(NSUInteger)length {
+    if ( _openElement ) {
+        [self writeCloseElement:NO];
+    }
+    
+    appendBytes(self, bytes, length);
+    
+    _emptyElement = NO;
+}
+
+- (void)writeEndElement {
+    if ( _level <= 0 ) {
+        @throw([NSException exceptionWithName:@"XMLWriterException" reason:@"Cannot write more end elements than start elements." userInfo:NULL]);
+    }
+    
+    _level -= 1;
+    
+    NSData* name = self.elementStack.lastObject;
+    [self.elementStack removeLastObject];
+    
+    if ( _openElement && self.automaticEmptyElements ) {
+        [self writeCloseElement:YES];
+    }
+    else {
+        if ( _openElement ) {
+            [self writeCloseElement:NO];
+        }
+        else if ( _emptyElement ) {
+            [self writeLinebreak];
+            [self writeIndentation];
+        }
+        
+        appendBytes(self, "</", 2);
+        appendData(self, name);
+        appendBytes(self, ">", 1);
+    }
+    
+    _emptyElement = YES;
+    _openElement = NO;
+}
+
+
+
+- (NSData *)toData {
+    [self flush];
+    
+    return self.document ? self.document.copy : NSData.data;
+}
+
+- (NSString *)toString {
+    return [[NSString alloc] initWithData:self.toData encoding:NSUTF8StringEncoding];
+}
+
+- (NSError *)streamError {
+    return self.error;
+}
+
+@end
@@ -7,18 +7,55 @@
 //
 
 #import "XmlSerializer.h"
-#import "XMLWriter.h"
+#import "Utf8XmlWriter.h"
 #import "KeePassDatabase.h"
 #import "InnerRandomStreamFactory.h"
 #import "Utils.h"
 #import "SimpleXmlValueExtractor.h"
-#import "XmlOutputStreamWriter.h"
+#import <stdatomic.h>
+
+static const BOOL kConcurrentSerialization = YES;
+
+@interface XmlProtectedPlaceholder : NSObject
+
+@property NSUInteger offset;
+@property NSString* text;
+
+@end
+
+@implementation XmlProtectedPlaceholder
+
+@end
 
 @interface XmlSerializer ()
 
-@property (nonatomic) XMLWriter* xmlWriter;
+@property (nonatomic) Utf8XmlWriter* xmlWriter;
 @property (nonatomic) id<InnerRandomStream> innerRandomStream;
 @property BOOL v4Format;
+@property BOOL prettyPrint;
+@property (nonatomic) NSMutableData* protectedScratch;
+
+@property (nullable) NSMutableArray<XmlProtectedPlaceholder*>* deferredProtected;
+
+@end
+
+@interface XmlSerializerFragment : NSObject
+
+@property (nullable) XmlSerializer* serializer;
+@property BOOL succeeded;
+@property (readonly) dispatch_semaphore_t done;
+
+@end
+
+@implementation XmlSerializerFragment
+
+- (instancetype)init {
+    if ( self = [super init] ) {
+        _done = dispatch_semaphore_create(0);
+    }
+    
+    return self;
+}
 
 @end
 
@@ -54,13 +91,9 @@
     if( self = [super init] ) {
         self.innerRandomStream = innerRandomStream;
         self.v4Format = v4Format;
+        self.prettyPrint = prettyPrint;
         
-        if ( outputStream ) {
-            self.xmlWriter = [[XmlOutputStreamWriter alloc] initWithOutputStream:outputStream];
-        }
-        else {
-            self.xmlWriter = [[XMLWriter alloc] init];
-        }
+        self.xmlWriter = [[Utf8XmlWriter alloc] initWithOutputStream:outputStream];
         
         if(prettyPrint) {
             [self.xmlWriter setPrettyPrinting:@"\t" withLineBreak:@"\n"];
@@ -194,7 +227,16 @@
 
 - (void)writeText:(NSString*)text protected:(BOOL)protected trimWhitespace:(BOOL)trimWhitespace {
     if(text.length) {
-        if(protected) {
+        if ( protected && self.deferredProtected ) {
+            [self.xmlWriter writeCharacters:@""];
+            
+            XmlProtectedPlaceholder* placeholder = [[XmlProtectedPlaceholder alloc] init];
+            placeholder.offset = self.xmlWriter.position;
+            placeholder.text = text;
+            
+            [self.deferredProtected addObject:placeholder];
+        }
+        else if(protected) {
             NSString *encrypted = [self encryptProtected:text];
             [self.xmlWriter writeCharacters:encrypted];
         }
@@ -219,15 +261,133 @@
 
 
 
+- (instancetype)initFragmentOf:(XmlSerializer*)parent {
+    if ( self = [self initWithProtectedStream:parent.innerRandomStream v4Format:parent.v4Format prettyPrint:NO outputStream:nil] ) {
+        self.deferredProtected = NSMutableArray.array;
+    }
+    
+    return self;
+}
+
+- (BOOL)writeConcurrently:(NSArray *)items block:(BOOL (^)(id _Nonnull, id<IXmlSerializer> _Nonnull))block {
+    if ( !kConcurrentSerialization || self.prettyPrint || self.deferredProtected || items.count < 2 ) {
+        for ( id item in items ) {
+            if ( !block(item, self) ) {
+                return NO;
+            }
+        }
+        
+        return YES;
+    }
+    
+    NSUInteger count = items.count;
+    NSUInteger maxInFlight = MAX(2, NSProcessInfo.processInfo.activeProcessorCount * 2);
+    
+    NSMutableArray<XmlSerializerFragment*>* fragments = [NSMutableArray arrayWithCapacity:count];
+    for ( NSUInteger i = 0; i < count; i++ ) {
+        [fragments addObject:[[XmlSerializerFragment alloc] init]];
+    }
+    
+    atomic_bool failed;
+    atomic_init(&failed, false);
+    atomic_bool* pFailed = &failed;
+    
+    NSUInteger submitted = 0;
+    NSUInteger stitched = 0;
+    BOOL ret = YES;
+    
+    for ( ; stitched < count; stitched++ ) {
+        for ( ; submitted < count && submitted < stitched + maxInFlight; submitted++ ) {
+            XmlSerializerFragment* fragment = fragments[submitted];
+            id item = items[submitted];
+            
+            dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+                if ( !atomic_load(pFailed) ) {
+                    @autoreleasepool {
+                        XmlSerializer* serializer = [[XmlSerializer alloc] initFragmentOf:self];
+                        
+                        fragment.succeeded = block(item, serializer);
+                        fragment.serializer = serializer;
+                    }
+                }
+                
+                dispatch_semaphore_signal(fragment.done);
+            });
+        }
+        
+        XmlSerializerFragment* fragment = fragments[stitched];
+        dispatch_semaphore_wait(fragment.done, DISPATCH_TIME_FOREVER);
+        
+        if ( !fragment.succeeded || ![self stitchFragment:fragment.serializer] ) {
+            atomic_store(&failed, true);
+            ret = NO;
+            stitched++;
+            break;
+        }
+        
+        fragment.serializer = nil;
+    }
+    
+    for ( ; stitched < submitted; stitched++ ) {
+        dispatch_semaphore_wait(fragments[stitched].done, DISPATCH_TIME_FOREVER);
+    }
+    
+    return ret;
+}
+
+- (BOOL)stitchFragment:(XmlSerializer*)fragment {
+    @autoreleasepool {
+        NSData* data = fragment.xmlWriter.toData;
+        const uint8_t* bytes = data.bytes;
+        NSUInteger offset = 0;
+        
+        for ( XmlProtectedPlaceholder* placeholder in fragment.deferredProtected ) {
+            if ( placeholder.offset < offset || placeholder.offset > data.length ) {
+                NSLog(@"🔴 WARNWARN: Protected placeholder out of range while stitching XML fragment");
+                return NO;
+            }
+            
+            [self.xmlWriter writeRaw:&bytes[offset] length:placeholder.offset - offset];
+            [self.xmlWriter writeCharacters:[self encryptProtected:placeholder.text]];
+            
+            offset = placeholder.offset;
+        }
+        
+        [self.xmlWriter writeRaw:&bytes[offset] length:data.length - offset];
+        
+        return self.xmlWriter.streamError == nil;
+    }
+}
+
+
+
 - (NSString *)encryptProtected:(NSString *)pt {
     if(self.innerRandomStream == nil) { 
         return pt;
     }
     
     @autoreleasepool {
-        NSData *ptData = [pt dataUsingEncoding:NSUTF8StringEncoding];
-
-        NSData* ciphertext = [self.innerRandomStream xor:ptData];
+        NSUInteger maxLength = [pt maximumLengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+        
+        if ( self.protectedScratch == nil ) {
+            self.protectedScratch = [NSMutableData dataWithLength:MAX(maxLength, 1024)];
+        }
+        else if ( self.protectedScratch.length < maxLength ) {
+            self.protectedScratch.length = maxLength;
+        }
+        
+        NSUInteger used = 0;
+        [pt getBytes:self.protectedScratch.mutableBytes
+           maxLength:maxLength
+          usedLength:&used
+            encoding:NSUTF8StringEncoding
+             options:kNilOptions
+               range:NSMakeRange(0, pt.length)
+      remainingRange:nil];
+        
+        [self.innerRandomStream xorInPlace:self.protectedScratch.mutableBytes length:used];
+        
+        NSData* ciphertext = [NSData dataWithBytesNoCopy:self.protectedScratch.mutableBytes length:used freeWhenDone:NO];
         
         return [ciphertext base64EncodedStringWithOptions:kNilOptions];
     }
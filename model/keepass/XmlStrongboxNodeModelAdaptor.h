@@ -11,6 +11,7 @@
 #import "SerializationData.h"
 #import "KeePassGroup.h"
 #import "DatabaseAttachment.h"
+#import "KeePassNodeXmlWriter.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -24,6 +25,11 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (nullable KeePassGroup*)toKeePassModel:(Node*)rootNode context:(XmlProcessingContext*)context error:(NSError**)error;
 
+- (nullable KeePassNodeXmlWriter*)toKeePassNodeWriter:(Node*)rootNode
+                                minimalAttachmentPool:(NSArray<DatabaseAttachment*>*_Nullable*_Nullable)minimalAttachmentPool
+                                             iconPool:(NSDictionary<NSUUID*, NodeIcon*>*)iconPool
+                                                error:(NSError**)error;
+
 - (nullable Node*)toStrongboxModel:(KeePassGroup*)existingXmlRoot
                     error:(NSError**)error;
 
@@ -32,6 +38,18 @@ NS_ASSUME_NONNULL_BEGIN
                     customIconPool:(NSDictionary<NSUUID *, NodeIcon *> *)customIconPool
                              error:(NSError**)error;
 
+- (Node*)groupNodeFromGroup:(KeePassGroup*)group
+                 parentNode:(Node*_Nullable)parentNode
+             customIconPool:(NSDictionary<NSUUID *, NodeIcon *> *)customIconPool
+                    usedIds:(NSMutableSet<NSUUID*>*)usedIds;
+
+- (Node*)nodeFromEntry:(Entry *)childEntry
+             groupNode:(Node*_Nullable)groupNode
+       attachmentsPool:(NSArray<DatabaseAttachment *> *)attachmentsPool
+        customIconPool:(NSDictionary<NSUUID*, NodeIcon*>*)customIconPool
+               usedIds:(NSMutableSet<NSUUID*>*)usedIds
+            historical:(BOOL)historical;
+
 @end
 
 NS_ASSUME_NONNULL_END
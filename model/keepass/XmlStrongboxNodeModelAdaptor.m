@@ -17,6 +17,7 @@
 @interface XmlStrongboxNodeModelAdaptor ()
 
 @property XmlProcessingContext* xmlParsingContext;
+@property NSDictionary<NSString*, NSNumber*>* attachmentIndexByDigest;
 
 @end
 
@@ -45,7 +46,10 @@
         return nil;
     }
 
-    NSArray<DatabaseAttachment*>* attachmentsPool = [MinimalPoolHelper getMinimalAttachmentPool:rootNode];
+    NSDictionary<NSString*, NSNumber*>* indexByDigest;
+    NSArray<DatabaseAttachment*>* attachmentsPool = [MinimalPoolHelper getMinimalAttachmentPool:rootNode indexByDigest:&indexByDigest];
+    self.attachmentIndexByDigest = indexByDigest;
+    
     if (minimalAttachmentPool) {
         *minimalAttachmentPool = attachmentsPool;
     }
@@ -55,6 +59,32 @@
     return [self buildXmlGroup:keePassRootGroup attachmentsPool:attachmentsPool iconPool:iconPool];
 }
 
+- (KeePassNodeXmlWriter *)toKeePassNodeWriter:(Node *)rootNode
+                        minimalAttachmentPool:(NSArray<DatabaseAttachment *> **)minimalAttachmentPool
+                                     iconPool:(NSDictionary<NSUUID *,NodeIcon *> *)iconPool
+                                        error:(NSError **)error {
+    if(rootNode.children.count != 1 || ![rootNode.children objectAtIndex:0].isGroup) {
+       if(error) {
+            *error = [Utils createNSError:@"Unexpected root group. More/Less than 1 child at root or non group at root" errorCode:-1];
+        }
+        
+        NSLog(@"Unexpected root group. More/Less than 1 child at root or non group at root");
+        return nil;
+    }
+    
+    NSDictionary<NSString*, NSNumber*>* indexByDigest;
+    NSArray<DatabaseAttachment*>* attachmentsPool = [MinimalPoolHelper getMinimalAttachmentPool:rootNode indexByDigest:&indexByDigest];
+    
+    if (minimalAttachmentPool) {
+        *minimalAttachmentPool = attachmentsPool;
+    }
+    
+    return [[KeePassNodeXmlWriter alloc] initWithRootGroup:[rootNode.children objectAtIndex:0]
+                                           attachmentsPool:attachmentsPool
+                                             indexByDigest:indexByDigest
+                                                  iconPool:iconPool];
+}
+
 - (Node*)toStrongboxModel:(KeePassGroup *)existingXmlRoot error:(NSError *__autoreleasing  _Nullable *)error {
     return [self toStrongboxModel:existingXmlRoot attachmentsPool:@[] customIconPool:@{} error:error];
 }
@@ -280,6 +310,38 @@
    attachmentsPool:(NSArray<DatabaseAttachment *> *)attachmentsPool
     customIconPool:(NSDictionary<NSUUID *, NodeIcon *> *)customIconPool
            usedIds:(NSMutableSet<NSUUID*>*)usedIds {
+    Node* groupNode = [self groupNodeFromGroup:group parentNode:parentNode customIconPool:customIconPool usedIds:usedIds];
+    
+    for (id<KeePassGroupOrEntry> child in group.groupsAndEntries) {
+        if (child.isGroup) {
+            if(![self buildGroup:(KeePassGroup*)child parentNode:groupNode attachmentsPool:attachmentsPool customIconPool:customIconPool usedIds:usedIds]) {
+                NSLog(@"Error Builing Child Group: [%@]", child);
+                return NO;
+            }
+        }
+        else {
+            Node * entryNode = [self nodeFromEntry:(Entry*)child groupNode:groupNode attachmentsPool:attachmentsPool customIconPool:customIconPool usedIds:usedIds historical:NO]; 
+            
+            if( entryNode == nil ) {
+                NSLog(@"Error building node from Entry: [%@]", child);
+                return NO;
+            }
+            
+            [groupNode addChild:entryNode keePassGroupTitleRules:YES];
+        }
+    }
+    
+    [parentNode addChild:groupNode keePassGroupTitleRules:YES];
+
+    
+
+    return YES;
+}
+
+- (Node*)groupNodeFromGroup:(KeePassGroup*)group
+                 parentNode:(Node*)parentNode
+             customIconPool:(NSDictionary<NSUUID *, NodeIcon *> *)customIconPool
+                    usedIds:(NSMutableSet<NSUUID*>*)usedIds {
     BOOL alreadyUsedId = [usedIds containsObject:group.uuid];
     if ( alreadyUsedId ) {
         NSLog(@"WARNWARN: %@", group.uuid);
@@ -287,7 +349,12 @@
     NSUUID* nodeId = ( alreadyUsedId || group.uuid == nil ) ? NSUUID.UUID : group.uuid; 
     [usedIds addObject:nodeId];
     
-    Node* groupNode = [[Node alloc] initAsGroup:group.name parent:parentNode keePassGroupTitleRules:YES uuid:nodeId];
+    Node* groupNode = [[Node alloc] initWithParent:parentNode
+                                             title:group.name ? group.name : @""
+                                           isGroup:YES
+                                              uuid:nodeId
+                                            fields:nil
+                               childRecordsAllowed:YES];
     
     [groupNode.fields setTouchPropertiesWithCreated:group.times.creationTime
                                            accessed:group.times.lastAccessTime
@@ -326,30 +393,7 @@
     groupNode.fields.isExpanded = group.isExpanded;
     groupNode.fields.previousParentGroup = group.previousParentGroup;
     
-    for (id<KeePassGroupOrEntry> child in group.groupsAndEntries) {
-        if (child.isGroup) {
-            if(![self buildGroup:(KeePassGroup*)child parentNode:groupNode attachmentsPool:attachmentsPool customIconPool:customIconPool usedIds:usedIds]) {
-                NSLog(@"Error Builing Child Group: [%@]", child);
-                return NO;
-            }
-        }
-        else {
-            Node * entryNode = [self nodeFromEntry:(Entry*)child groupNode:groupNode attachmentsPool:attachmentsPool customIconPool:customIconPool usedIds:usedIds historical:NO]; 
-            
-            if( entryNode == nil ) {
-                NSLog(@"Error building node from Entry: [%@]", child);
-                return NO;
-            }
-            
-            [groupNode addChild:entryNode keePassGroupTitleRules:YES];
-        }
-    }
-    
-    [parentNode addChild:groupNode keePassGroupTitleRules:YES];
-
-    
-
-    return YES;
+    return groupNode;
 }
 
 - (Node*)nodeFromEntry:(Entry *)childEntry
@@ -433,10 +477,12 @@
     NSUUID* nodeId = ((alreadyUsedId && !historical) || childEntry.uuid == nil) ? NSUUID.UUID : childEntry.uuid; 
     [usedIds addObject:nodeId];
     
-    Node* entryNode = [[Node alloc] initAsRecord:childEntry.title
-                                          parent:groupNode
-                                          fields:fields
-                                            uuid:nodeId];
+    Node* entryNode = [[Node alloc] initWithParent:groupNode
+                                             title:childEntry.title
+                                           isGroup:NO
+                                              uuid:nodeId
+                                            fields:fields
+                               childRecordsAllowed:NO];
     
     if ( childEntry.customIcon ) {
         NodeIcon* ni = customIconPool[childEntry.customIcon];
@@ -465,6 +511,11 @@
 }
 
 - (NSInteger)getIndexOfAttachmentInPool:(NSArray<DatabaseAttachment*>*)attachments attachment:(DatabaseAttachment*)attachment {
+    if ( self.attachmentIndexByDigest ) {
+        NSNumber* index = self.attachmentIndexByDigest[attachment.digestHash];
+        return index ? index.integerValue : -1;
+    }
+    
     int i = 0;
     
     for (DatabaseAttachment* a in attachments) {
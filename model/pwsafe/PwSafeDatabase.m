@@ -7,6 +7,7 @@
 #import "Constants.h"
 #import "StrongboxErrorCodes.h"
 #import "StreamUtils.h"
+#import "MappedFileInputStream.h"
 
 const NSInteger kPwSafeDefaultVersionMajor = 0x03;
 const NSInteger kPwSafeDefaultVersionMinor = 0x0D;
@@ -72,6 +73,15 @@ const NSInteger kPwSafeDefaultVersionMinor = 0x0D;
 }
 
 + (void)read:(NSInputStream *)stream ckf:(CompositeKeyFactors *)ckf completion:(OpenCompletionBlock)completion {
+    if ( [stream isKindOfClass:MappedFileInputStream.class] ) {
+        [stream open];
+        NSData* data = ((MappedFileInputStream*)stream).remainingData;
+        [stream close];
+        
+        [self open:data ckf:ckf completion:completion];
+        return;
+    }
+    
     NSMutableData* mutableData = [NSMutableData dataWithCapacity:kStreamingSerializationChunkSize];
     
     [stream open];